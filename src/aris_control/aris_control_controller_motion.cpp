@@ -69,8 +69,20 @@ namespace aris
 			imp_->home_pos_ = home_pos;
 		}
 
-		struct Controller::Imp{	aris::core::RefPool<Motion> motion_pool_;};
+		struct Controller::Imp{	aris::core::RefPool<Motion> motion_pool_; MotionState motion_state_; };
 		auto Controller::motionPool()->aris::core::RefPool<Motion>& { return imp_->motion_pool_; }
+		auto Controller::motionState()const->const MotionState& { return imp_->motion_state_; }
+		auto Controller::updateMotionState()->void
+		{
+			auto &st = imp_->motion_state_;
+			for (std::size_t i = 0; i < st.target_pos_.size(); ++i)
+			{
+				auto &m = imp_->motion_pool_.at(i);
+				st.target_pos_[i] = m.targetPos();
+				st.actual_pos_[i] = m.actualPos();
+				st.actual_vel_[i] = m.actualVel();
+			}
+		}
 		auto Controller::init()->void
 		{
 			motionPool().clear();
@@ -79,6 +91,19 @@ namespace aris
 				if (dynamic_cast<Motion*>(&s))motionPool().push_back_ptr(dynamic_cast<Motion*>(&s));
 				motionPool().back().imp_->mot_id_ = motionPool().size() - 1;
 			}
+
+			// 限位在运行时不变，这里一次性读入 //
+			auto &st = imp_->motion_state_;
+			const auto n = motionPool().size();
+			for (auto v : { &st.target_pos_, &st.actual_pos_, &st.actual_vel_, &st.max_pos_, &st.min_pos_, &st.max_vel_, &st.max_pos_following_error_ })v->assign(n, 0.0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				auto &m = motionPool().at(i);
+				st.max_pos_[i] = m.maxPos();
+				st.min_pos_[i] = m.minPos();
+				st.max_vel_[i] = m.maxVel();
+				st.max_pos_following_error_[i] = m.maxPosFollowingError();
+			}
 		}
 		auto Controller::motionAtAbs(aris::Size id)->Motion& { return imp_->motion_pool_.at(id); }
 		auto Controller::motionAtPhy(aris::Size id)->Motion& { return dynamic_cast<Motion&>(slaveAtPhy(id)); }
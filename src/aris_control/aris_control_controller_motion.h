@@ -4,6 +4,7 @@
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 #include <aris_core.h>
 #include <aris_control_master_slave.h>
@@ -70,8 +71,18 @@ namespace aris
 		class Controller : public virtual Master
 		{
 		public:
+			/// 所有电机状态的连续快照（structure of arrays），下标为 motionPool() 中的序号
+			///
+			/// target 与 actual 在每个周期 recv() 之后刷新一次，限位在 start() 时刷新，供实时线程批量检查
+			struct MotionState
+			{
+				std::vector<double> target_pos_, actual_pos_, actual_vel_;
+				std::vector<double> max_pos_, min_pos_, max_vel_, max_pos_following_error_;
+			};
 			static auto Type()->const std::string &{ static const std::string type("Controller"); return std::ref(type); }
 			auto virtual type() const->const std::string& override{ return Type(); }
+			auto motionState()const->const MotionState&;
+			auto updateMotionState()->void;
 			auto motionPool()->aris::core::RefPool<Motion>&;
 			auto motionPool()const->const aris::core::RefPool<Motion>&{return const_cast<std::decay_t<decltype(*this)> *>(this)->motionPool(); }
 			auto motionAtSla(aris::Size id)->Motion&;
@@ -90,6 +101,7 @@ namespace aris
 
 		protected:
 			auto virtual init()->void override;
+			auto virtual recv()->void override { Master::recv(); updateMotionState(); }
 
 		private:
 			struct Imp;
@@ -9,6 +9,8 @@
 #include <thread>
 #include <chrono>
 #include <future>
+#include <vector>
+#include <algorithm>
 
 #include "aris_control_ethercat_kernel.h"
 #include "aris_control_ethercat.h"
@@ -444,10 +446,130 @@ namespace aris
 		EthercatSlaveType& EthercatSlaveType::operator=(const EthercatSlaveType &) = default;
 		EthercatSlaveType& EthercatSlaveType::operator=(EthercatSlaveType &&) = default;
 		
+		auto SdoRequest::setRead(std::uint16_t index, std::uint8_t subindex, int byte_size)->void
+		{
+			if (state() == PENDING)throw std::runtime_error("failed to set sdo request, because it's pending");
+			if (byte_size <= 0 || byte_size > MAX_DATA_SIZE)throw std::runtime_error("failed to set sdo request, because data size is invalid");
+			is_write_ = false;
+			index_ = index;
+			subindex_ = subindex;
+			byte_size_ = byte_size;
+			abort_code_ = 0;
+			state_.store(IDLE, std::memory_order_release);
+		}
+		auto SdoRequest::setWrite(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void
+		{
+			if (state() == PENDING)throw std::runtime_error("failed to set sdo request, because it's pending");
+			if (byte_size <= 0 || byte_size > MAX_DATA_SIZE)throw std::runtime_error("failed to set sdo request, because data size is invalid");
+			is_write_ = true;
+			index_ = index;
+			subindex_ = subindex;
+			byte_size_ = byte_size;
+			abort_code_ = 0;
+			std::memcpy(data_, value, byte_size);
+			state_.store(IDLE, std::memory_order_release);
+		}
+		auto SdoRequest::wait()const->State
+		{
+			while (state() == PENDING)std::this_thread::sleep_for(std::chrono::microseconds(100));
+			return state();
+		}
+		// 异步 sdo 的邮箱，每个邮箱由一个非实时线程服务，实时线程与非实时线程都可以提交请求 //
+		// 槽位的 seq_ 为 pos 时可写入，为 pos + 1 时可读取，与 ControlServer 的命令队列相同 //
+		struct SdoMailbox
+		{
+			enum { QUEUE_SIZE = 256 };
+			struct Slot
+			{
+				std::atomic<std::uint64_t> seq_;
+				SdoRequest *request_;
+				std::uint16_t position_;
+			};
+
+			Slot slots_[QUEUE_SIZE];
+			std::atomic<std::uint64_t> enqueue_pos_{ 0 };
+			std::uint64_t dequeue_pos_{ 0 };
+			std::atomic_bool is_running_{ false };
+			std::thread thread_;
+
+			auto push(SdoRequest *request, std::uint16_t position)->bool
+			{
+				auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					auto &slot = slots_[pos % QUEUE_SIZE];
+					auto diff = static_cast<std::int64_t>(slot.seq_.load(std::memory_order_acquire) - pos);
+					if (diff == 0)
+					{
+						if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							slot.request_ = request;
+							slot.position_ = position;
+							slot.seq_.store(pos + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (diff < 0) return false;
+					else pos = enqueue_pos_.load(std::memory_order_relaxed);
+				}
+			}
+			auto pop(SdoRequest *&request, std::uint16_t &position)->bool
+			{
+				auto &slot = slots_[dequeue_pos_ % QUEUE_SIZE];
+				if (slot.seq_.load(std::memory_order_acquire) != dequeue_pos_ + 1) return false;
+				request = slot.request_;
+				position = slot.position_;
+				slot.seq_.store(dequeue_pos_ + QUEUE_SIZE, std::memory_order_release);
+				++dequeue_pos_;
+				return true;
+			}
+			auto start(Handle *master_handle)->void
+			{
+				is_running_ = true;
+				thread_ = std::thread([this, master_handle]()
+				{
+					SdoRequest *req;
+					std::uint16_t position;
+					for (;;)
+					{
+						if (!pop(req, position))
+						{
+							if (!is_running_)break;
+							std::this_thread::sleep_for(std::chrono::microseconds(500));
+							continue;
+						}
+
+						// 停止后剩余的请求直接失败，避免等待者一直等待 //
+						int ret{ -1 };
+						if (is_running_)
+						{
+							std::size_t result_size{ 0 };
+							ret = req->is_write_
+								? aris_ecrt_sdo_write(master_handle, position, req->index_, req->subindex_, req->data_, req->byte_size_, &req->abort_code_)
+								: aris_ecrt_sdo_read(master_handle, position, req->index_, req->subindex_, req->data_, req->byte_size_, &result_size, &req->abort_code_);
+						}
+						req->state_.store(ret == 0 ? SdoRequest::SUCCESS : SdoRequest::FAILED, std::memory_order_release);
+					}
+				});
+			}
+			auto stop()->void
+			{
+				is_running_ = false;
+				if (thread_.joinable())thread_.join();
+
+				SdoRequest *req;
+				std::uint16_t position;
+				while (pop(req, position))req->state_.store(SdoRequest::FAILED, std::memory_order_release);
+			}
+
+			SdoMailbox() { for (std::uint64_t i = 0; i < QUEUE_SIZE; ++i)slots_[i].seq_.store(i); }
+			~SdoMailbox() { stop(); }
+		};
 		struct EthercatSlave::Imp
 		{
 		public:
 			aris::core::ImpPtr<Handle> ec_handle_;
+			SdoMailbox *sdo_mailbox_{ nullptr };
 
 			std::uint32_t vendor_id_, product_code_, revision_num_, dc_assign_activate_;
 			aris::core::ObjectPool<PdoGroup> *pdo_group_pool_;
@@ -544,12 +666,23 @@ namespace aris
 			if (pdo.size() != byte_size)throw std::runtime_error("failed to write pdo:\"" + pdo.name() + "\" because byte size is not correct");
 			aris_ecrt_pdo_write(ecHandle(), pdoGroupPool().at(id_pair.first).at(id_pair.second).ecHandle(), value, byte_size);
 		}
+		auto EthercatSlave::pdoAddress(std::uint16_t index, std::uint8_t subindex, int byte_size)->void*
+		{
+			auto found_index = imp_->pdo_map_.find(index);
+			if (found_index == imp_->pdo_map_.end())return nullptr;
+			auto found_subindex = found_index->second.find(subindex);
+			if (found_subindex == found_index->second.end())return nullptr;
+
+			auto &pdo = pdoGroupPool().at(found_subindex->second.first).at(found_subindex->second.second);
+			if (pdo.size() != byte_size)throw std::runtime_error("failed to get address of pdo:\"" + pdo.name() + "\" because byte size is not correct");
+			return aris_ecrt_pdo_address(ecHandle(), pdo.ecHandle());
+		}
 		auto EthercatSlave::readSdo(std::uint16_t index, std::uint8_t subindex, void *value, int byte_size)->void
 		{
 			std::size_t result_size;
 			std::uint32_t abort_code;
 			auto &sdo = sdoPool().at(imp_->sdo_map_.at(index).at(subindex));
-			aris_ecrt_sdo_read(ecHandle(), phyId(), index, subindex, reinterpret_cast<std::uint8_t*>(value), byte_size, &result_size, &abort_code);
+			aris_ecrt_sdo_read(dynamic_cast<EthercatMaster&>(root()).ecHandle(), phyId(), index, subindex, reinterpret_cast<std::uint8_t*>(value), byte_size, &result_size, &abort_code);
 		}
 		auto EthercatSlave::writeSdo(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void
 		{
@@ -561,6 +694,17 @@ namespace aris
 		auto EthercatSlave::configSdo(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void
 		{
 
+		}
+		auto EthercatSlave::submitSdo(SdoRequest &request)->bool
+		{
+			auto mailbox = imp_->sdo_mailbox_;
+			if (!mailbox || !mailbox->is_running_ || request.byte_size_ == 0 || request.state() == SdoRequest::PENDING)return false;
+
+			request.state_.store(SdoRequest::PENDING, std::memory_order_release);
+			if (mailbox->push(&request, phyId()))return true;
+
+			request.state_.store(SdoRequest::IDLE, std::memory_order_release);
+			return false;
 		}
 		EthercatSlave::~EthercatSlave() = default;
 		EthercatSlave::EthercatSlave(const std::string &name, std::uint16_t phy_id, std::uint32_t vid, std::uint32_t p_code, std::uint32_t r_num, std::uint32_t dc) :Slave(name, phy_id), imp_(new Imp)
@@ -583,6 +727,9 @@ namespace aris
 		public:
 			aris::core::ImpPtr<Handle> ec_handle_;
 			aris::core::RefPool<EthercatSlave> ec_slave_pool_;
+
+			int sdo_thread_num_{ 4 };
+			std::vector<std::unique_ptr<SdoMailbox>> sdo_mailboxes_;
 		};
 		auto EthercatMaster::init()->void
 		{
@@ -671,8 +818,35 @@ namespace aris
 			// start ethercat master and slave //
 			aris_ecrt_master_start(ecHandle());
 			for (auto &sla : ecSlavePool())aris_ecrt_slave_start(sla.ecHandle());
+
+			// cache pdo address, must after slave start //
+			for (auto &sla : ecSlavePool())sla.initPdoRef();
+
+			// start sdo mailbox threads //
+			imp_->sdo_mailboxes_.clear();
+			auto mailbox_num = std::max<std::size_t>(1, std::min<std::size_t>(imp_->sdo_thread_num_, ecSlavePool().size()));
+			for (std::size_t i = 0; i < mailbox_num; ++i)
+			{
+				imp_->sdo_mailboxes_.push_back(std::unique_ptr<SdoMailbox>(new SdoMailbox));
+				imp_->sdo_mailboxes_.back()->start(ecHandle());
+			}
+			for (std::size_t i = 0; i < ecSlavePool().size(); ++i)
+				ecSlavePool().at(i).imp_->sdo_mailbox_ = imp_->sdo_mailboxes_.at(i % mailbox_num).get();
+		}
+		auto EthercatMaster::release()->void 
+		{
+			for (auto &sla : ecSlavePool())sla.imp_->sdo_mailbox_ = nullptr;
+			for (auto &mailbox : imp_->sdo_mailboxes_)mailbox->stop();
+			imp_->sdo_mailboxes_.clear();
+
+			aris_ecrt_master_stop(ecHandle());
+		}
+		auto EthercatMaster::sdoThreadNum()const->int { return imp_->sdo_thread_num_; }
+		auto EthercatMaster::setSdoThreadNum(int thread_num)->void 
+		{
+			if (thread_num < 1)throw std::runtime_error("failed to set sdo thread num, because it must be positive");
+			imp_->sdo_thread_num_ = thread_num; 
 		}
-		auto EthercatMaster::release()->void { aris_ecrt_master_stop(ecHandle()); }
 		auto EthercatMaster::send()->void 
 		{
 			for (auto &sla : ecSlavePool())aris_ecrt_slave_send(sla.ecHandle());
@@ -713,7 +887,43 @@ namespace aris
 			int enable_period{ 0 };
 			int home_period{ 0 };
 			std::uint8_t running_mode{ 9 };
+
+			// 预先解析的PDO地址，无效时退回到 readPdo/writePdo //
+			PdoRef<std::uint8_t> mode_of_display_, mode_of_operation_;
+			PdoRef<std::uint16_t> status_word_, control_word_;
+			PdoRef<std::int32_t> actual_pos_, actual_vel_, target_pos_pdo_, target_vel_pdo_, offset_vel_pdo_;
+			PdoRef<std::int16_t> actual_cur_, target_cur_pdo_, offset_cur_pdo_;
+
+			template<typename ValueType>
+			static auto read(EthercatMotion *mot, const PdoRef<ValueType> &ref, std::uint16_t index)->ValueType
+			{
+				if (ref.valid())return ref.read();
+				ValueType value;
+				mot->readPdo(index, 0x00, value);
+				return value;
+			}
+			template<typename ValueType>
+			static auto write(EthercatMotion *mot, PdoRef<ValueType> &ref, std::uint16_t index, ValueType value)->void
+			{
+				if (ref.valid())ref.write(value);
+				else mot->writePdo(index, 0x00, value);
+			}
 		};
+		auto EthercatMotion::initPdoRef()->void
+		{
+			imp_->mode_of_display_ = pdoRef<std::uint8_t>(0x6061, 0x00);
+			imp_->mode_of_operation_ = pdoRef<std::uint8_t>(0x6060, 0x00);
+			imp_->status_word_ = pdoRef<std::uint16_t>(0x6041, 0x00);
+			imp_->control_word_ = pdoRef<std::uint16_t>(0x6040, 0x00);
+			imp_->actual_pos_ = pdoRef<std::int32_t>(0x6064, 0x00);
+			imp_->actual_vel_ = pdoRef<std::int32_t>(0x606C, 0x00);
+			imp_->actual_cur_ = pdoRef<std::int16_t>(0x6078, 0x00);
+			imp_->target_pos_pdo_ = pdoRef<std::int32_t>(0x607A, 0x00);
+			imp_->target_vel_pdo_ = pdoRef<std::int32_t>(0x60FF, 0x00);
+			imp_->target_cur_pdo_ = pdoRef<std::int16_t>(0x6071, 0x00);
+			imp_->offset_vel_pdo_ = pdoRef<std::int32_t>(0x60B1, 0x00);
+			imp_->offset_cur_pdo_ = pdoRef<std::int16_t>(0x60B2, 0x00);
+		}
 		auto EthercatMotion::saveXml(aris::core::XmlElement &xml_ele) const->void
 		{
 			EthercatSlave::saveXml(xml_ele);
@@ -741,57 +951,49 @@ namespace aris
 		auto EthercatMotion::offsetCur()const->double { return imp_->offset_cur_; }
 		auto EthercatMotion::modeOfDisplay()->std::uint8_t
 		{
-			std::uint8_t mode;
-			readPdo(0x6061, 0x00, mode);
-			return mode;
+			return Imp::read(this, imp_->mode_of_display_, 0x6061);
 		}
 		auto EthercatMotion::actualPos()->double
 		{
-			std::int32_t pos_count;
-			readPdo(0x6064, 0x00, pos_count);
-			return static_cast<double>(pos_count) / posFactor() - posOffset();
+			return static_cast<double>(Imp::read(this, imp_->actual_pos_, 0x6064)) / posFactor() - posOffset();
 		}
 		auto EthercatMotion::actualVel()->double
 		{
-			std::int32_t vel_count;
-			readPdo(0x606C, 0x00, vel_count);
-			return static_cast<double>(vel_count) / posFactor();
+			return static_cast<double>(Imp::read(this, imp_->actual_vel_, 0x606C)) / posFactor();
 		}
 		auto EthercatMotion::actualCur()->double
 		{
-			std::int16_t cur_count;
-			readPdo(0x6078, 0x00, cur_count);
-			return static_cast<double>(cur_count);
+			return static_cast<double>(Imp::read(this, imp_->actual_cur_, 0x6078));
 		}
 		auto EthercatMotion::setModeOfOperation(std::uint8_t mode)->void
 		{
 			imp_->mode_of_operation = mode;
-			writePdo(0x6060, 0x00, mode);
+			Imp::write(this, imp_->mode_of_operation_, 0x6060, mode);
 		}
 		auto EthercatMotion::setTargetPos(double pos)->void
 		{
 			imp_->target_pos_ = pos;
-			writePdo(0x607A, 0x00, static_cast<std::int32_t>((pos + posOffset()) * posFactor()));
+			Imp::write(this, imp_->target_pos_pdo_, 0x607A, static_cast<std::int32_t>((pos + posOffset()) * posFactor()));
 		}
 		auto EthercatMotion::setTargetVel(double vel)->void
 		{
 			imp_->target_vel_ = vel;
-			writePdo(0x60FF, 0x00, static_cast<std::int32_t>(vel * posFactor()));
+			Imp::write(this, imp_->target_vel_pdo_, 0x60FF, static_cast<std::int32_t>(vel * posFactor()));
 		}
 		auto EthercatMotion::setTargetCur(double cur)->void
 		{
 			imp_->target_cur_ = cur;
-			writePdo(0x6071, 0x00, static_cast<std::int16_t>(cur));
+			Imp::write(this, imp_->target_cur_pdo_, 0x6071, static_cast<std::int16_t>(cur));
 		}
 		auto EthercatMotion::setOffsetVel(double vel)->void
 		{
 			imp_->offset_vel_ = vel;
-			writePdo(0x60B1, 0x00, static_cast<std::int32_t>(vel * posFactor()));
+			Imp::write(this, imp_->offset_vel_pdo_, 0x60B1, static_cast<std::int32_t>(vel * posFactor()));
 		}
 		auto EthercatMotion::setOffsetCur(double cur)->void
 		{
 			imp_->offset_cur_ = cur;
-			writePdo(0x60B2, 0x00, static_cast<std::int16_t>(cur));
+			Imp::write(this, imp_->offset_cur_pdo_, 0x60B2, static_cast<std::int16_t>(cur));
 		}
 		auto EthercatMotion::disable()->int
 		{
@@ -819,8 +1021,7 @@ namespace aris
 			// 0x4F    0b 0000 0000 0100 1111
 			// disable change state to A/B/C/D to E
 
-			std::uint16_t status_word;
-			readPdo(0x6041, 0x00, status_word);
+			auto status_word = Imp::read(this, imp_->status_word_, 0x6041);
 
 			// check status A
 			if ((status_word & 0x4F) == 0x00)
@@ -831,14 +1032,14 @@ namespace aris
 			else if ((status_word & 0x4F) == 0x40)
 			{
 				// transition 2 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x06));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x06));
 				return 1;
 			}
 			// check status C, now transition 3
 			else if ((status_word & 0x6F) == 0x21)
 			{
 				// transition 3 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x07));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x07));
 				return 1;
 			}
 			// check status D, now keep and return
@@ -850,26 +1051,26 @@ namespace aris
 			else if ((status_word & 0x6F) == 0x27)
 			{
 				// transition 5 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x06));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x06));
 				return 1;
 			}
 			// check status F, now transition 12
 			else if ((status_word & 0x6F) == 0x07)
 			{
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x00));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x00));
 				return 1;
 			}
 			// check status G, now transition 14
 			else if ((status_word & 0x4F) == 0x0F)
 			{
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x00));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x00));
 				return 1;
 			}
 			// check status H, now transition 13
 			else if ((status_word & 0x4F) == 0x08)
 			{
 				// transition 4 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x80));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x80));
 				return 1;
 			}
 			// unknown status
@@ -903,8 +1104,7 @@ namespace aris
 			// 0x6F    0b 0000 0000 0110 1111
 			// 0x4F    0b 0000 0000 0100 1111
 			// enable change state to A/B/C/D/F/G/H to E
-			std::uint16_t status_word;
-			readPdo(0x6041, 0x00, status_word);
+			auto status_word = Imp::read(this, imp_->status_word_, 0x6041);
 
 			// check status A
 			if ((status_word & 0x4F) == 0x00)
@@ -915,21 +1115,21 @@ namespace aris
 			else if ((status_word & 0x4F) == 0x40)
 			{
 				// transition 2 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x06));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x06));
 				return 2;
 			}
 			// check status C, now transition 3
 			else if ((status_word & 0x6F) == 0x21)
 			{
 				// transition 3 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x07));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x07));
 				return 3;
 			}
 			// check status D, now transition 4
 			else if ((status_word & 0x6F) == 0x23)
 			{
 				// transition 4 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x0F));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x0F));
 				imp_->waiting_count_left = 20;
 
 				// check mode to set correct pos, vel or cur //
@@ -954,20 +1154,20 @@ namespace aris
 			// check status F, now transition 12
 			else if ((status_word & 0x6F) == 0x07)
 			{
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x00));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x00));
 				return 6;
 			}
 			// check status G, now transition 14
 			else if ((status_word & 0x4F) == 0x0F)
 			{
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x00));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x00));
 				return 7;
 			}
 			// check status H, now transition 13
 			else if ((status_word & 0x4F) == 0x08)
 			{
 				// transition 4 //
-				writePdo(0x6040, 0x00, static_cast<std::uint16_t>(0x80));
+				Imp::write(this, imp_->control_word_, 0x6040, static_cast<std::uint16_t>(0x80));
 				return 8;
 			}
 			// unknown status
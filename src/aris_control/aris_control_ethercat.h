@@ -6,6 +6,8 @@
 #include <thread>
 #include <fstream>
 #include <cstdint>
+#include <cstring>
+#include <atomic>
 
 #include <aris_core.h>
 #include <aris_control_master_slave.h>
@@ -134,6 +136,59 @@ namespace aris
 
 			friend class EthercatSlave;
 		};
+		/// 直接指向过程数据（process image）中某个PDO的句柄，在 EthercatMaster::init() 之后由 EthercatSlave::pdoRef() 获得
+		/// 读写时不再查表，也不做尺寸检查；过程数据不存在时（例如未映射该PDO）为无效句柄
+		template<typename ValueType>
+		class PdoRef
+		{
+		public:
+			auto valid()const->bool { return data_ != nullptr; }
+			auto read()const->ValueType { ValueType value; std::memcpy(&value, data_, sizeof(ValueType)); return value; }
+			auto write(const ValueType &value)->void { std::memcpy(data_, &value, sizeof(ValueType)); }
+
+			explicit PdoRef(void *data = nullptr) :data_(data) {}
+
+		private:
+			void *data_;
+		};
+		/// 异步 sdo 请求，由请求者持有，提交后在结束之前不能销毁或修改
+		///
+		/// 通过 EthercatSlave::submitSdo() 提交后由 EthercatMaster 的非实时邮箱线程执行，
+		/// 实时线程中只需查询 state()，不会阻塞；同一从站的请求按提交顺序执行，不同从站的请求可以并行
+		class SdoRequest
+		{
+		public:
+			enum State { IDLE = 0, PENDING = 1, SUCCESS = 2, FAILED = 3 };
+			enum { MAX_DATA_SIZE = 64 };
+			auto setRead(std::uint16_t index, std::uint8_t subindex, int byte_size)->void;
+			template<typename ValueType>
+			auto setWrite(std::uint16_t index, std::uint8_t subindex, const ValueType &value)->void { setWrite(index, subindex, &value, sizeof(ValueType)); }
+			auto setWrite(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void;
+			auto state()const->State { return static_cast<State>(state_.load(std::memory_order_acquire)); }
+			auto finished()const->bool { return state() == SUCCESS || state() == FAILED; }
+			auto abortCode()const->std::uint32_t { return abort_code_; }
+			auto data()const->const void* { return data_; }
+			template<typename ValueType>
+			auto value()const->ValueType { ValueType value; std::memcpy(&value, data_, sizeof(ValueType)); return value; }
+			// 在非实时线程中等待请求结束 //
+			auto wait()const->State;
+
+			SdoRequest() = default;
+			SdoRequest(const SdoRequest &) = delete;
+			SdoRequest& operator=(const SdoRequest &) = delete;
+
+		private:
+			std::atomic<int> state_{ IDLE };
+			bool is_write_{ false };
+			std::uint16_t index_{ 0 };
+			std::uint8_t subindex_{ 0 };
+			int byte_size_{ 0 };
+			std::uint32_t abort_code_{ 0 };
+			std::uint8_t data_[MAX_DATA_SIZE]{};
+
+			friend class EthercatSlave;
+			friend struct SdoMailbox;
+		};
 		class EthercatSlave : virtual public Slave
 		{
 		public:
@@ -158,6 +213,10 @@ namespace aris
 			template<typename ValueType>
 			auto writePdo(std::uint16_t index, std::uint8_t subindex, const ValueType &value)->void { writePdo(index, subindex, &value, sizeof(ValueType)); }
 			auto writePdo(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void;
+			// 在 init 之后有效，未映射该PDO时返回无效句柄，尺寸不对时抛出异常 //
+			template<typename ValueType>
+			auto pdoRef(std::uint16_t index, std::uint8_t subindex)->PdoRef<ValueType> { return PdoRef<ValueType>(pdoAddress(index, subindex, sizeof(ValueType))); }
+			auto pdoAddress(std::uint16_t index, std::uint8_t subindex, int byte_size)->void*;
 			template<typename ValueType>
 			auto readSdo(std::uint16_t index, std::uint8_t subindex, ValueType &value)->void { readSdo(index, subindex, &value, sizeof(ValueType)); }
 			auto readSdo(std::uint16_t index, std::uint8_t subindex, void *value, int byte_size)->void;
@@ -167,6 +226,8 @@ namespace aris
 			template<typename ValueType>
 			auto configSdo(std::uint16_t index, std::uint8_t subindex, const ValueType &value)->void { configSdo(index, subindex, &value, sizeof(ValueType)); }
 			auto configSdo(std::uint16_t index, std::uint8_t subindex, const void *value, int byte_size)->void;
+			// 提交异步 sdo 请求，可以在实时线程中调用，主站未运行、队列已满或请求仍在执行时返回 false //
+			auto submitSdo(SdoRequest &request)->bool;
 
 			virtual ~EthercatSlave();
 			explicit EthercatSlave(const std::string &name = "ethercat_slave", std::uint16_t phy_id = 0, std::uint32_t vendor_id = 0x00000000, std::uint32_t product_code = 0x00000000, std::uint32_t revision_num = 0x00000000, std::uint32_t dc_assign_activate = 0x00000000);
@@ -175,6 +236,10 @@ namespace aris
 			EthercatSlave& operator=(const EthercatSlave &other) = delete;
 			EthercatSlave& operator=(EthercatSlave &&other) = delete;
 
+		protected:
+			// 主站启动后调用，用于缓存 PdoRef //
+			auto virtual initPdoRef()->void {}
+
 		private:
 			struct Imp;
 			aris::core::ImpPtr<Imp> imp_;
@@ -188,6 +253,9 @@ namespace aris
 			auto ecHandle()const->const Handle*{ return const_cast<std::decay_t<decltype(*this)> *>(this)->ecHandle(); }
 			auto ecSlavePool()->aris::core::RefPool<EthercatSlave>&;
 			auto ecSlavePool()const->const aris::core::RefPool<EthercatSlave>&{ return const_cast<std::decay_t<decltype(*this)> *>(this)->ecSlavePool(); }
+			// 服务异步 sdo 的邮箱线程数，从站按位置分配到各个线程，在 start 之前设置 //
+			auto sdoThreadNum()const->int;
+			auto setSdoThreadNum(int thread_num)->void;
 
 			virtual ~EthercatMaster();
 			EthercatMaster();
@@ -260,6 +328,9 @@ namespace aris
 				, std::uint32_t vendor_id = 0x00000000, std::uint32_t product_code = 0x00000000, std::uint32_t revision_num = 0x00000000, std::uint32_t dc_assign_activate = 0x00000000
 				, double max_pos = 0.0, double min_pos = 0.0, double max_vel = 0.0, double max_acc = 0.0, double pos_factor = 1.0, double pos_offset = 0.0, double home_pos = 0.0);
 
+		protected:
+			auto virtual initPdoRef()->void override;
+
 		private:
 			class Imp;
 			std::unique_ptr<Imp> imp_;
@@ -280,7 +351,7 @@ namespace aris
 		protected:
 			auto virtual init()->void override { EthercatMaster::init(); Controller::init(); };
 			auto virtual send()->void override { EthercatMaster::send(); };
-			auto virtual recv()->void override { EthercatMaster::recv(); };
+			auto virtual recv()->void override { EthercatMaster::recv(); Controller::updateMotionState(); };
 			auto virtual sync()->void override { EthercatMaster::sync(); };
 			auto virtual release()->void override { EthercatMaster::release(); };
 		};
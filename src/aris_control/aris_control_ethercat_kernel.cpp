@@ -10,7 +10,13 @@ extern "C"
 #include <thread>
 #include <memory>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <stdexcept>
 
 #include "aris_control_ethercat_kernel.h"
 
@@ -19,30 +25,269 @@ namespace aris
 	namespace control
 	{
 #ifndef USE_ETHERLAB
-		auto aris_ecrt_master_init()->Handle* { return nullptr; }
+		struct EcSimDrive
+		{
+			EcSimDriveParam param_;
+			std::atomic_bool fault_request_{ false };
+
+			// 指向过程数据，未映射时为 nullptr //
+			std::uint8_t *control_word_{ nullptr }, *status_word_{ nullptr }, *mode_of_operation_{ nullptr }, *mode_of_display_{ nullptr };
+			std::uint8_t *target_pos_{ nullptr }, *target_vel_{ nullptr }, *target_cur_{ nullptr }, *offset_vel_{ nullptr }, *offset_cur_{ nullptr };
+			std::uint8_t *actual_pos_{ nullptr }, *actual_vel_{ nullptr }, *actual_cur_{ nullptr }, *following_error_{ nullptr };
+
+			std::uint16_t state_{ 0x00 }, last_control_word_{ 0x00 };
+			std::uint8_t mode_{ 0x00 };
+			double pos_{ 0.0 }, vel_{ 0.0 }, cur_{ 0.0 }, following_error_value_{ 0.0 };
+
+			template<typename ValueType>
+			static auto read(const std::uint8_t *data, ValueType default_value)->ValueType
+			{
+				if (!data) return default_value;
+				ValueType value;
+				std::memcpy(&value, data, sizeof(ValueType));
+				return value;
+			}
+			template<typename ValueType>
+			static auto write(std::uint8_t *data, ValueType value)->void { if (data) std::memcpy(data, &value, sizeof(ValueType)); }
+			static auto clamp(double value, double max_abs)->double { return max_abs > 0.0 ? std::max(-max_abs, std::min(max_abs, value)) : value; }
+
+			auto updateState(std::uint16_t cw)->void
+			{
+				// 0x40 switch on disabled, 0x21 ready to switch on, 0x23 switched on, 0x27 operation enabled //
+				// 0x07 quick stop active, 0x0F fault reaction active, 0x08 fault //
+				const bool disable_voltage = (cw & 0x02) == 0;
+				const bool quick_stop = (cw & 0x06) == 0x02;
+				const bool fault_reset = (cw & 0x80) && !(last_control_word_ & 0x80);
+				const auto cmd = cw & 0x8F;
+
+				if (fault_request_.exchange(false) && state_ != 0x08) state_ = 0x0F;
+
+				switch (state_)
+				{
+				case 0x00: state_ = 0x40; break;
+				case 0x40: if ((cw & 0x87) == 0x06) state_ = 0x21; break;
+				case 0x21:
+					if (disable_voltage || quick_stop) state_ = 0x40;
+					else if (cmd == 0x07 || cmd == 0x0F) state_ = 0x23;
+					break;
+				case 0x23:
+					if (disable_voltage || quick_stop) state_ = 0x40;
+					else if (cmd == 0x06) state_ = 0x21;
+					else if (cmd == 0x0F) state_ = 0x27;
+					break;
+				case 0x27:
+					if (disable_voltage) state_ = 0x40;
+					else if (quick_stop) state_ = 0x07;
+					else if (cmd == 0x06) state_ = 0x21;
+					else if (cmd == 0x07) state_ = 0x23;
+					break;
+				case 0x07:
+					if (disable_voltage) state_ = 0x40;
+					else if (cmd == 0x0F) state_ = 0x27;
+					break;
+				case 0x0F: state_ = 0x08; break;
+				case 0x08: if (fault_reset) state_ = 0x40; break;
+				default: state_ = 0x00;
+				}
+				last_control_word_ = cw;
+			}
+			auto updateMotion(double dt)->void
+			{
+				mode_ = read<std::uint8_t>(mode_of_operation_, mode_);
+
+				const auto last_vel = vel_;
+				if (state_ != 0x27)
+				{
+					// 未使能时抱闸 //
+					vel_ = 0.0;
+					following_error_value_ = 0.0;
+				}
+				else if (mode_ == 0x08)
+				{
+					const auto target = static_cast<double>(read<std::int32_t>(target_pos_, static_cast<std::int32_t>(pos_)));
+					const auto alpha = std::min(1.0, dt / std::max(param_.pos_time_constant, dt));
+					vel_ = clamp((target - pos_) * alpha / dt, param_.max_vel);
+					pos_ += vel_ * dt;
+					following_error_value_ = target - pos_;
+				}
+				else if (mode_ == 0x09)
+				{
+					const auto target = static_cast<double>(read<std::int32_t>(target_vel_, 0) + read<std::int32_t>(offset_vel_, 0));
+					const auto alpha = std::min(1.0, dt / std::max(param_.vel_time_constant, dt));
+					vel_ = clamp(vel_ + (target - vel_) * alpha, param_.max_vel);
+					pos_ += vel_ * dt;
+					following_error_value_ = 0.0;
+				}
+				else if (mode_ == 0x0A)
+				{
+					const auto target = clamp(static_cast<double>(read<std::int16_t>(target_cur_, 0) + read<std::int16_t>(offset_cur_, 0)), param_.max_cur);
+					vel_ = clamp(vel_ + (target * param_.cur_to_acc - param_.damping * vel_) * dt, param_.max_vel);
+					pos_ += vel_ * dt;
+					cur_ = target;
+					following_error_value_ = 0.0;
+				}
+
+				// cst 以外的模式由加速度反推电流 //
+				if (state_ != 0x27) cur_ = 0.0;
+				else if (mode_ != 0x0A) cur_ = clamp(((vel_ - last_vel) / dt + param_.damping * vel_) / param_.cur_to_acc, param_.max_cur);
+
+				if (param_.max_following_error > 0.0 && std::abs(following_error_value_) > param_.max_following_error) state_ = 0x0F;
+			}
+			auto step(double dt)->void
+			{
+				updateState(read<std::uint16_t>(control_word_, 0x00));
+				updateMotion(dt);
+
+				write(status_word_, state_);
+				write(mode_of_display_, mode_);
+				write(actual_pos_, static_cast<std::int32_t>(std::lround(pos_)));
+				write(actual_vel_, static_cast<std::int32_t>(std::lround(vel_)));
+				write(actual_cur_, static_cast<std::int16_t>(std::lround(cur_)));
+				write(following_error_, static_cast<std::int32_t>(std::lround(following_error_value_)));
+			}
+		};
+		struct EcSimSlaveHandle;
+		struct EcSimMasterHandle :public Handle
+		{
+			std::uint64_t sync_ns_{ 0 };
+			std::vector<EcSimSlaveHandle*> slaves_;
+			std::mutex sdo_mutex_;
+		};
+		struct EcSimSlaveHandle :public Handle
+		{
+			struct PdoEntry { std::uint16_t index_; std::uint8_t subindex_; std::uint32_t offset_; };
+
+			EcSimMasterHandle *master_{ nullptr };
+			std::uint16_t position_{ 0 };
+			std::uint64_t last_ns_{ 0 };
+			std::uint32_t domain_size_{ 0 };
+			std::vector<PdoEntry> pdo_entry_vec_;
+			std::vector<std::uint8_t> domain_data_;
+			std::uint8_t* domain_pd_{ nullptr };
+			std::map<std::pair<std::uint16_t, std::uint8_t>, std::vector<std::uint8_t> > sdo_map_;
+
+			bool is_drive_{ false };
+			EcSimDrive drive_;
+
+			auto pdoData(std::uint16_t index)->std::uint8_t*
+			{
+				auto found = std::find_if(pdo_entry_vec_.begin(), pdo_entry_vec_.end(), [index](const PdoEntry &e) {return e.index_ == index && e.subindex_ == 0x00; });
+				return found == pdo_entry_vec_.end() ? nullptr : domain_pd_ + found->offset_;
+			}
+		};
+		struct EcSimPdoHandle :public Handle
+		{
+			std::uint32_t offset_{ 0 };
+		};
+		auto aris_ecrt_master_init()->Handle* { return new EcSimMasterHandle; }
 		auto aris_ecrt_master_config(Handle* master_handle)->void {}
 		auto aris_ecrt_master_start(Handle* master_handle)->void {}
 		auto aris_ecrt_master_stop(Handle* master_handle)->void {}
-		auto aris_ecrt_master_sync(Handle* master_handle, std::uint64_t ns)->void {}
+		auto aris_ecrt_master_sync(Handle* master_handle, std::uint64_t ns)->void { static_cast<EcSimMasterHandle*>(master_handle)->sync_ns_ = ns; }
 		auto aris_ecrt_master_receive(Handle* master_handle)->void {}
 		auto aris_ecrt_master_send(Handle* master_handle)->void {}
-		auto aris_ecrt_slave_init()->Handle* { return nullptr; }
-		auto aris_ecrt_slave_config(Handle* master_handle, Handle* slave_handle, std::uint16_t alias, std::uint16_t position, std::uint32_t vendor_id, std::uint32_t product_code, std::uint32_t dc_assign_activate)->void {}
-		auto aris_ecrt_slave_start(Handle* slave_handle)->void {}
-		auto aris_ecrt_slave_send(Handle* slave_handle)->void {}
+		auto aris_ecrt_slave_init()->Handle* { return new EcSimSlaveHandle; }
+		auto aris_ecrt_slave_config(Handle* master_handle, Handle* slave_handle, std::uint16_t alias, std::uint16_t position, std::uint32_t vendor_id, std::uint32_t product_code, std::uint32_t dc_assign_activate)->void
+		{
+			auto mst = static_cast<EcSimMasterHandle*>(master_handle);
+			auto sla = static_cast<EcSimSlaveHandle*>(slave_handle);
+			sla->master_ = mst;
+			sla->position_ = position;
+			mst->slaves_.push_back(sla);
+		}
+		auto aris_ecrt_slave_start(Handle* slave_handle)->void
+		{
+			auto sla = static_cast<EcSimSlaveHandle*>(slave_handle);
+			sla->domain_data_.assign(std::max<std::uint32_t>(sla->domain_size_, 1), 0);
+			sla->domain_pd_ = sla->domain_data_.data();
+
+			auto &drive = sla->drive_;
+			drive.control_word_ = sla->pdoData(0x6040);
+			drive.status_word_ = sla->pdoData(0x6041);
+			drive.mode_of_operation_ = sla->pdoData(0x6060);
+			drive.mode_of_display_ = sla->pdoData(0x6061);
+			drive.actual_pos_ = sla->pdoData(0x6064);
+			drive.actual_vel_ = sla->pdoData(0x606C);
+			drive.target_cur_ = sla->pdoData(0x6071);
+			drive.actual_cur_ = sla->pdoData(0x6078);
+			drive.target_pos_ = sla->pdoData(0x607A);
+			drive.offset_vel_ = sla->pdoData(0x60B1);
+			drive.offset_cur_ = sla->pdoData(0x60B2);
+			drive.following_error_ = sla->pdoData(0x60F4);
+			drive.target_vel_ = sla->pdoData(0x60FF);
+			sla->is_drive_ = drive.control_word_ && drive.status_word_;
+		}
+		auto aris_ecrt_slave_send(Handle* slave_handle)->void
+		{
+			// 驱动器在 send 时读取 rx pdo，并更新下个周期读到的 tx pdo //
+			auto sla = static_cast<EcSimSlaveHandle*>(slave_handle);
+			if (!sla->is_drive_) return;
+
+			const auto ns = sla->master_->sync_ns_;
+			const auto dt = (sla->last_ns_ && ns > sla->last_ns_) ? (ns - sla->last_ns_) * 1e-9 : 0.001;
+			sla->last_ns_ = ns;
+			sla->drive_.step(dt);
+		}
 		auto aris_ecrt_slave_receive(Handle* slave_handle)->void {}
-		auto aris_ecrt_pdo_group_init()->Handle* { return nullptr; }
+		auto aris_ecrt_pdo_group_init()->Handle* { return new Handle; }
 		auto aris_ecrt_pdo_group_config(Handle* slave_handle, Handle* pdo_group_handle, std::uint16_t index, bool is_tx)->void {}
-		auto aris_ecrt_pdo_init()->Handle*{ return nullptr; }
-		auto aris_ecrt_pdo_config(Handle* slave_handle, Handle* pdo_group_handle, Handle* pdo_handle, std::uint16_t index, std::uint8_t subindex, std::uint8_t bit_length)->void{}
-		auto aris_ecrt_pdo_read(Handle* slave_handle, Handle* pdo_handle, void *data, int byte_size)->void{	}
-		auto aris_ecrt_pdo_write(Handle* slave_handle, Handle* pdo_handle, const void *data, int byte_size)->void{ }
+		auto aris_ecrt_pdo_init()->Handle* { return new EcSimPdoHandle; }
+		auto aris_ecrt_pdo_config(Handle* slave_handle, Handle* pdo_group_handle, Handle* pdo_handle, std::uint16_t index, std::uint8_t subindex, std::uint8_t bit_length)->void
+		{
+			auto sla = static_cast<EcSimSlaveHandle*>(slave_handle);
+			static_cast<EcSimPdoHandle*>(pdo_handle)->offset_ = sla->domain_size_;
+			sla->pdo_entry_vec_.push_back(EcSimSlaveHandle::PdoEntry{ index, subindex, sla->domain_size_ });
+			sla->domain_size_ += (bit_length + 7) / 8;
+		}
+		auto aris_ecrt_pdo_read(Handle* slave_handle, Handle* pdo_handle, void *data, int byte_size)->void
+		{
+			std::copy_n(static_cast<EcSimSlaveHandle*>(slave_handle)->domain_pd_ + static_cast<EcSimPdoHandle*>(pdo_handle)->offset_, byte_size, static_cast<char *>(data));
+		}
+		auto aris_ecrt_pdo_write(Handle* slave_handle, Handle* pdo_handle, const void *data, int byte_size)->void
+		{
+			std::copy_n(static_cast<const char *>(data), byte_size, static_cast<EcSimSlaveHandle*>(slave_handle)->domain_pd_ + static_cast<EcSimPdoHandle*>(pdo_handle)->offset_);
+		}
+		auto aris_ecrt_pdo_address(Handle* slave_handle, Handle* pdo_handle)->void*
+		{
+			return static_cast<EcSimSlaveHandle*>(slave_handle)->domain_pd_ + static_cast<EcSimPdoHandle*>(pdo_handle)->offset_;
+		}
 		auto aris_ecrt_sdo_read(Handle* master_handle, std::uint16_t slave_position, std::uint16_t index, std::uint8_t subindex,
-			std::uint8_t *to_buffer, std::size_t buffer_size, std::size_t *result_size, std::uint32_t *abort_code) ->int{return 0;}
+			std::uint8_t *to_buffer, std::size_t buffer_size, std::size_t *result_size, std::uint32_t *abort_code) ->int
+		{
+			auto mst = static_cast<EcSimMasterHandle*>(master_handle);
+			std::unique_lock<std::mutex> lck(mst->sdo_mutex_);
+
+			auto sla = std::find_if(mst->slaves_.begin(), mst->slaves_.end(), [slave_position](EcSimSlaveHandle *s) {return s->position_ == slave_position; });
+			if (sla == mst->slaves_.end()) return -1;
+
+			auto &value = (*sla)->sdo_map_[std::make_pair(index, subindex)];
+			value.resize(std::max(value.size(), buffer_size), 0);
+			std::copy_n(value.begin(), buffer_size, to_buffer);
+			if (result_size) *result_size = buffer_size;
+			if (abort_code) *abort_code = 0;
+			return 0;
+		}
 		auto aris_ecrt_sdo_write(Handle* master_handle, std::uint16_t slave_position, std::uint16_t index, std::uint8_t subindex,
-			std::uint8_t *to_buffer, std::size_t buffer_size, std::uint32_t *abort_code) ->int{	return 0;}
+			std::uint8_t *to_buffer, std::size_t buffer_size, std::uint32_t *abort_code) ->int
+		{
+			auto mst = static_cast<EcSimMasterHandle*>(master_handle);
+			std::unique_lock<std::mutex> lck(mst->sdo_mutex_);
+
+			auto sla = std::find_if(mst->slaves_.begin(), mst->slaves_.end(), [slave_position](EcSimSlaveHandle *s) {return s->position_ == slave_position; });
+			if (sla == mst->slaves_.end()) return -1;
+
+			(*sla)->sdo_map_[std::make_pair(index, subindex)].assign(to_buffer, to_buffer + buffer_size);
+			if (abort_code) *abort_code = 0;
+			return 0;
+		}
 		auto aris_ecrt_sdo_config(Handle* master_handle, Handle* slave_handle, std::uint16_t index, std::uint8_t subindex,
-			std::uint8_t *buffer, std::size_t bit_size)->void {}
+			std::uint8_t *buffer, std::size_t byte_size)->void
+		{
+			std::unique_lock<std::mutex> lck(static_cast<EcSimMasterHandle*>(master_handle)->sdo_mutex_);
+			static_cast<EcSimSlaveHandle*>(slave_handle)->sdo_map_[std::make_pair(index, subindex)].assign(buffer, buffer + byte_size);
+		}
+		auto aris_ecrt_sim_set_drive_param(Handle* slave_handle, const EcSimDriveParam &param)->void { static_cast<EcSimSlaveHandle*>(slave_handle)->drive_.param_ = param; }
+		auto aris_ecrt_sim_set_fault(Handle* slave_handle)->void { static_cast<EcSimSlaveHandle*>(slave_handle)->drive_.fault_request_ = true; }
 #endif
 
 #ifdef USE_ETHERLAB
@@ -205,6 +450,10 @@ namespace aris
 		{
 			std::copy_n(static_cast<const char *>(data), byte_size, static_cast<EcSlaveHandle*>(slave_handle)->domain_pd_ + static_cast<EcPdoHandle*>(pdo_handle)->offset_);
 		}
+		auto aris_ecrt_pdo_address(Handle* slave_handle, Handle* pdo_handle)->void*
+		{
+			return static_cast<EcSlaveHandle*>(slave_handle)->domain_pd_ + static_cast<EcPdoHandle*>(pdo_handle)->offset_;
+		}
 		auto aris_ecrt_sdo_read(Handle* master_handle, std::uint16_t slave_position, std::uint16_t index, std::uint8_t subindex,
 			std::uint8_t *to_buffer, std::size_t buffer_size, std::size_t *result_size, std::uint32_t *abort_code)->int
 		{
@@ -221,6 +470,8 @@ namespace aris
 			auto &ec_slave_config = static_cast<EcSlaveHandle*>(slave_handle)->ec_slave_config_;
 			ecrt_slave_config_sdo(ec_slave_config, index, subindex, buffer, byte_size * 8);
 		}
+		auto aris_ecrt_sim_set_drive_param(Handle* slave_handle, const EcSimDriveParam &param)->void { throw std::runtime_error("simulated drive is not available with etherlab"); }
+		auto aris_ecrt_sim_set_fault(Handle* slave_handle)->void { throw std::runtime_error("simulated drive is not available with etherlab"); }
 #endif
 	}
 }
@@ -53,12 +53,36 @@ namespace aris
 		auto aris_ecrt_pdo_config(Handle* slave_handle, Handle* pdo_group_handle, Handle* pdo_handle, std::uint16_t index, std::uint8_t subindex, std::uint8_t bit_length)->void;
 		auto aris_ecrt_pdo_read(Handle* slave_handle, Handle* pdo_handle, void *data, int byte_size)->void;
 		auto aris_ecrt_pdo_write(Handle* slave_handle, Handle* pdo_handle, const void *data, int byte_size)->void;
+		// slave start 之后有效，返回该PDO在过程数据中的地址，没有过程数据时返回 nullptr //
+		auto aris_ecrt_pdo_address(Handle* slave_handle, Handle* pdo_handle)->void*;
 		auto aris_ecrt_sdo_read(Handle* master_handle, std::uint16_t slave_position, std::uint16_t index, std::uint8_t subindex,
 			std::uint8_t *to_buffer, std::size_t bit_size, std::size_t *result_size, std::uint32_t *abort_code)->int;
 		auto aris_ecrt_sdo_write(Handle* master_handle, std::uint16_t slave_position, std::uint16_t index, std::uint8_t subindex,
 			std::uint8_t *to_buffer, std::size_t bit_size, std::uint32_t *abort_code) ->int;
 		auto aris_ecrt_sdo_config(Handle* master_handle, Handle* slave_handle, std::uint16_t index, std::uint8_t subindex,
 			std::uint8_t *buffer, std::size_t bit_size)->void;
+
+		//------------------------ 仿真后端 ------------------------//
+		// 未定义 USE_ETHERLAB 时，以上接口由仿真主站实现，每个从站拥有真实的过程数据，sdo 也会被保存
+		// 映射了 0x6040 与 0x6041 的从站被模拟为 CiA-402 驱动器，在 slave send 时根据 rx pdo 推进一个周期：
+		//   状态机   ：0x6040 -> 0x6041，支持 fault reset
+		//   运行模式 ：0x6060 -> 0x6061，支持 8(csp)、9(csv)、10(cst)
+		//   指令     ：0x607A、0x60FF、0x6071、0x60B1、0x60B2
+		//   反馈     ：0x6064、0x606C、0x6078、0x60F4(跟随误差)
+		// 周期由 master sync 的时间计算，配合 aris_rt_set_time_scale 可以超实时运行
+		struct EcSimDriveParam
+		{
+			double pos_time_constant{ 0.002 };  // csp 下位置环的一阶时间常数，单位 s
+			double vel_time_constant{ 0.002 };  // csv 下速度环的一阶时间常数，单位 s
+			double cur_to_acc{ 1000.0 };        // 单位电流产生的加速度，单位 count/s^2
+			double damping{ 0.0 };              // 粘滞阻尼，单位 1/s
+			double max_vel{ 0.0 };              // 最大速度，单位 count/s，0 表示不限制
+			double max_cur{ 0.0 };              // 最大电流，0 表示不限制
+			double max_following_error{ 0.0 };  // 超过该跟随误差时进入 fault，单位 count，0 表示不检查
+		};
+		auto aris_ecrt_sim_set_drive_param(Handle* slave_handle, const EcSimDriveParam &param)->void;
+		// 在下一个周期让仿真驱动器进入 fault reaction active //
+		auto aris_ecrt_sim_set_fault(Handle* slave_handle)->void;
 	}
 }
 
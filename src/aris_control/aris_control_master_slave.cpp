@@ -6,6 +6,18 @@
 #include <mutex>
 #include <thread>
 #include <future>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <cstring>
+#include <numeric>
+#include <functional>
+
+#ifdef UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 #include "aris_control_rt_timer.h"
 #include "aris_control_master_slave.h"
@@ -15,18 +27,134 @@ namespace aris
 {
 	namespace control
 	{
-		struct RTTimer::Imp { int sample_period_ns_{ 1000000 }; };
-		auto RTTimer::saveXml(aris::core::XmlElement &xml_ele) const->void { Object::saveXml(xml_ele); }
-		auto RTTimer::loadXml(const aris::core::XmlElement &xml_ele)->void { Object::loadXml(xml_ele); }
+		struct RTTimer::Imp { int sample_period_ns_{ 1000000 }; RtTaskConfig config_; };
+		auto RTTimer::saveXml(aris::core::XmlElement &xml_ele) const->void 
+		{ 
+			Object::saveXml(xml_ele);
+			xml_ele.SetAttribute("priority", config().priority_);
+			xml_ele.SetAttribute("cpu", config().cpu_);
+			xml_ele.SetAttribute("spin_ns", config().spin_ns_);
+		}
+		auto RTTimer::loadXml(const aris::core::XmlElement &xml_ele)->void 
+		{ 
+			Object::loadXml(xml_ele);
+			imp_->config_.priority_ = attributeInt32(xml_ele, "priority", 0);
+			imp_->config_.cpu_ = attributeInt32(xml_ele, "cpu", -1);
+			imp_->config_.spin_ns_ = attributeInt32(xml_ele, "spin_ns", 0);
+		}
+		auto RTTimer::config()const->const RtTaskConfig& { return imp_->config_; }
+		auto RTTimer::setConfig(const RtTaskConfig &config)->void { imp_->config_ = config; }
 		RTTimer::~RTTimer() = default;
-		RTTimer::RTTimer(const std::string &name) :Object(name), imp_(new Imp)
+		RTTimer::RTTimer(const std::string &name, int priority, int cpu, int spin_ns) :Object(name), imp_(new Imp)
 		{
+			imp_->config_.priority_ = priority;
+			imp_->config_.cpu_ = cpu;
+			imp_->config_.spin_ns_ = spin_ns;
 		}
 		
+		// 二进制日志的写入，UNIX 下可以使用 O_DIRECT 绕过页缓存，此时写入的地址和长度都需按 4096 对齐 //
+		class LogBlockFile
+		{
+		public:
+			auto open(const std::string &file_name, bool direct_io)->bool
+			{
+#ifdef UNIX
+				fd_ = -1;
+#ifdef O_DIRECT
+				if (direct_io) fd_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+#endif
+				if (fd_ < 0) fd_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+				return fd_ >= 0;
+#else
+				file_.open(file_name.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+				return file_.is_open();
+#endif
+			}
+			// 失败时记录第一个错误并返回 false，之后的写入全部丢弃 //
+			auto write(const char *data, std::size_t size)->bool
+			{
+				if (!error_.empty()) return false;
+#ifdef UNIX
+				while (size > 0)
+				{
+					auto ret = ::write(fd_, data, size);
+					if (ret < 0 && errno == EINTR) continue;
+#ifdef O_DIRECT
+					// 部分文件系统在写入时才拒绝 O_DIRECT，此时退化为普通写入 //
+					if (ret < 0 && errno == EINVAL && (::fcntl(fd_, F_GETFL) & O_DIRECT))
+					{
+						::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT);
+						continue;
+					}
+#endif
+					if (ret < 0) { error_ = std::strerror(errno); return false; }
+					if (ret == 0) { error_ = "no data written"; return false; }
+					data += ret;
+					size -= ret;
+				}
+#else
+				if (!file_.write(data, size)) { error_ = "stream write failed"; return false; }
+#endif
+				return true;
+			}
+			auto close()->void
+			{
+#ifdef UNIX
+				if (fd_ >= 0 && ::close(fd_) && error_.empty()) error_ = std::strerror(errno);
+				fd_ = -1;
+#else
+				file_.close();
+				if (file_.fail() && error_.empty()) error_ = "stream close failed";
+#endif
+			}
+			auto error()const->const std::string& { return error_; }
+
+		private:
+			std::string error_;
+#ifdef UNIX
+			int fd_{ -1 };
+#else
+			std::fstream file_;
+#endif
+		};
+		// 按 4096 对齐的缓冲区 //
+		class LogAlignedBuffer
+		{
+		public:
+			auto data()->char* { return data_; }
+			auto resize(std::size_t size)->void
+			{
+				mem_.reset(new char[size + LOG_ALIGNMENT]);
+				data_ = mem_.get() + (LOG_ALIGNMENT - reinterpret_cast<std::uintptr_t>(mem_.get()) % LOG_ALIGNMENT) % LOG_ALIGNMENT;
+				std::fill_n(data_, size, 0);
+			}
+			static const std::size_t LOG_ALIGNMENT = 4096;
+
+		private:
+			std::unique_ptr<char[]> mem_;
+			char *data_{ nullptr };
+		};
+		auto log_align(std::size_t size, std::size_t alignment)->std::size_t { return (size + alignment - 1) / alignment * alignment; }
+		auto log_type_size(DataLogger::DataType type)->std::uint32_t { return type == DataLogger::INT32 || type == DataLogger::FLOAT32 ? 4 : 8; }
+		const char LOG_MAGIC[8]{ 'A','R','I','S','L','O','G','1' };
+		const std::uint32_t LOG_VERSION = 1;
+		const std::uint32_t LOG_BLOCK_ROWS = 1024;
+		const std::size_t LOG_FILE_HEADER_SIZE = 8 + 5 * sizeof(std::uint32_t);
+		const std::size_t LOG_CHANNEL_HEADER_SIZE = 12;
+		const std::size_t LOG_BLOCK_HEADER_SIZE = 16;
+
 		struct DataLogger::Imp
 		{
+			struct Channel
+			{
+				std::string name_, unit_;
+				DataType type_;
+				std::uint32_t size_, record_offset_, column_offset_;
+			};
+
 			aris::core::Pipe *log_pipe_;
-			aris::core::MsgFix<MAX_LOG_DATA_SIZE> log_msg_;
+			aris::core::Pipe *binary_pipe_;
+			std::unique_ptr<aris::core::PipeMsg> log_msg_;
 
 			std::unique_ptr<aris::core::MsgStream> log_msg_stream_;
 
@@ -35,49 +163,176 @@ namespace aris
 			std::mutex mu_running_;
 			std::atomic_bool is_running_;
 
-			Imp() :log_msg_(), is_running_(false) { log_msg_stream_.reset(new aris::core::MsgStream(log_msg_)); }
+			// 二进制日志，只在 start 之前修改 //
+			std::vector<Channel> channels_;
+			std::uint32_t record_size_{ sizeof(std::uint64_t) }, block_size_{ 0 };
+			bool direct_io_{ false };
+
+			// 日志线程结束后在 stop 中检查写入错误 //
+			std::string file_name_;
+			std::shared_ptr<LogBlockFile> block_file_;
+
+			// 每次 start 加一，实时线程观察到变化时将序号清零，日志线程丢弃不属于本次的记录 //
+			std::atomic<std::int64_t> session_{ 0 };
+
+			// rt thread //
+			char *record_{ nullptr };
+			std::int64_t rt_session_{ 0 };
+			std::uint64_t record_index_{ 0 };
+
+			auto headerData()const->std::vector<char>
+			{
+				std::size_t size = LOG_FILE_HEADER_SIZE;
+				for (auto &c : channels_) size += LOG_CHANNEL_HEADER_SIZE + c.name_.size() + c.unit_.size();
+				std::vector<char> data(log_align(size, LogAlignedBuffer::LOG_ALIGNMENT), 0);
+
+				auto p = data.data();
+				auto put = [&p](const void *src, std::size_t n) { std::memcpy(p, src, n); p += n; };
+				auto put_u8 = [&put](std::uint8_t v) { put(&v, 1); };
+				auto put_u16 = [&put](std::uint16_t v) { put(&v, 2); };
+				auto put_u32 = [&put](std::uint32_t v) { put(&v, 4); };
+
+				put(LOG_MAGIC, 8);
+				put_u32(LOG_VERSION);
+				put_u32(static_cast<std::uint32_t>(channels_.size()));
+				put_u32(LOG_BLOCK_ROWS);
+				put_u32(block_size_);
+				put_u32(static_cast<std::uint32_t>(data.size()));
+				for (auto &c : channels_)
+				{
+					put_u8(c.type_);
+					put_u8(static_cast<std::uint8_t>(c.size_));
+					put_u16(static_cast<std::uint16_t>(c.name_.size()));
+					put_u16(static_cast<std::uint16_t>(c.unit_.size()));
+					put_u16(0);
+					put_u32(c.column_offset_);
+					put(c.name_.data(), c.name_.size());
+					put(c.unit_.data(), c.unit_.size());
+				}
+				return data;
+			}
+
+			// lout() 直接写在 log_pipe_ 的缓冲区中 //
+			auto bindLogPipe(aris::core::Pipe *pipe)->void
+			{
+				log_pipe_ = pipe;
+				log_msg_.reset(new aris::core::PipeMsg(*pipe, MAX_LOG_DATA_SIZE));
+				log_msg_stream_.reset(new aris::core::MsgStream(*log_msg_));
+			}
+
+			Imp() :is_running_(false) {}
 		};
 		auto DataLogger::saveXml(aris::core::XmlElement &xml_ele) const->void { Object::saveXml(xml_ele); }
 		auto DataLogger::loadXml(const aris::core::XmlElement &xml_ele)->void 
 		{ 
 			Object::loadXml(xml_ele);
-			imp_->log_pipe_ = findOrInsert<aris::core::Pipe>("pipe", 16384);
+			imp_->bindLogPipe(findOrInsert<aris::core::Pipe>("pipe", 16384));
+			imp_->binary_pipe_ = findOrInsert<aris::core::Pipe>("binary_pipe", 262144);
 		}
 		auto DataLogger::start(const std::string &log_file_name)->void
 		{
 			std::unique_lock<std::mutex> running_lck(imp_->mu_running_);
 			if (imp_->is_running_)throw std::runtime_error("failed to start DataLogger, because it's running");
-			imp_->is_running_ = true;
 
 			aris::core::createLogDir();
-			auto file_name = aris::core::logDirPath() + (log_file_name.empty() ? "logdata_" + aris::core::logFileTimeFormat(std::chrono::system_clock::now()) + ".txt" : log_file_name);
+			const bool binary = !imp_->channels_.empty();
+			auto file_name = aris::core::logDirPath() + (log_file_name.empty() ? "logdata_" + aris::core::logFileTimeFormat(std::chrono::system_clock::now()) + (binary ? ".bin" : ".txt") : log_file_name);
+
+			// 二进制日志在这里打开文件，以便抛出异常 //
+			std::shared_ptr<LogBlockFile> block_file;
+			if (binary)
+			{
+				block_file.reset(new LogBlockFile);
+				if (!block_file->open(file_name, imp_->direct_io_))throw std::runtime_error("failed to start DataLogger, because can't open file \"" + file_name + "\"");
+
+				auto header = imp_->headerData();
+				LogAlignedBuffer buf;
+				buf.resize(header.size());
+				std::copy(header.begin(), header.end(), buf.data());
+				if (!block_file->write(buf.data(), header.size()))
+				{
+					block_file->close();
+					throw std::runtime_error("failed to start DataLogger, because can't write file \"" + file_name + "\": " + block_file->error());
+				}
+			}
+			imp_->file_name_ = file_name;
+			imp_->block_file_ = block_file;
+
+			// 管道的发送端只由实时线程操作，lout() 在 send() 中重新预留，record_index_ 在 beginRecord() 中清零 //
+			const auto session = ++imp_->session_;
+			imp_->is_running_ = true;
 
 			std::promise<void> thread_ready;
 			auto fut = thread_ready.get_future();
-			imp_->log_thread_ = std::thread([this, file_name](std::promise<void> thread_ready)
+			imp_->log_thread_ = std::thread([this, file_name, binary, block_file, session](std::promise<void> thread_ready)
 			{
+				// 二进制模式下 lout() 的文本写入同名的 .txt 文件 //
 				std::fstream file;
-				file.open(file_name.c_str(), std::ios::out | std::ios::trunc);
+				if (!binary)file.open(file_name.c_str(), std::ios::out | std::ios::trunc);
 
-				aris::core::MsgFix<MAX_LOG_DATA_SIZE> recv_msg;
+				LogAlignedBuffer block;
+				std::uint32_t row{ 0 };
+				if (binary)block.resize(imp_->block_size_);
 
 				thread_ready.set_value();
 
-				long long count = 0;
-				while (imp_->is_running_)
+				// 直接在管道缓冲区中读取日志，不再拷贝到消息中 //
+				auto write_log = [&]()->bool
 				{
-					if (imp_->log_pipe_->recvMsg(recv_msg))
+					auto header = imp_->log_pipe_->peek();
+					if (!header) return false;
+					if (header->msg_size_ > 0)
 					{
-						file << recv_msg.data();
+						if (!file.is_open())file.open((file_name + ".txt").c_str(), std::ios::out | std::ios::trunc);
+						file << reinterpret_cast<const char *>(header + 1);
 					}
-					else
+					imp_->log_pipe_->release();
+					return true;
+				};
+				auto flush_block = [&]()
+				{
+					if (row == 0)return;
+					auto first_index = *reinterpret_cast<std::uint64_t*>(block.data() + LOG_BLOCK_HEADER_SIZE);
+					std::memcpy(block.data(), &row, sizeof(row));
+					std::memcpy(block.data() + 8, &first_index, sizeof(first_index));
+					block_file->write(block.data(), imp_->block_size_);
+					std::fill_n(block.data(), imp_->block_size_, 0);
+					row = 0;
+				};
+				// 将行存的记录转置到块内的各列中 //
+				auto write_record = [&]()->bool
+				{
+					if (!binary)return false;
+					auto header = imp_->binary_pipe_->peek();
+					if (!header) return false;
+					// 上次 stop 时尚未提交的记录在这里丢弃 //
+					if (header->msg_size_ == static_cast<aris::core::MsgSize>(imp_->record_size_) && header->reserved1_ == session)
 					{
-						std::this_thread::sleep_for(std::chrono::microseconds(10));
+						auto record = reinterpret_cast<const char *>(header + 1);
+						std::memcpy(block.data() + LOG_BLOCK_HEADER_SIZE + row * sizeof(std::uint64_t), record, sizeof(std::uint64_t));
+						for (auto &c : imp_->channels_)
+							std::memcpy(block.data() + c.column_offset_ + row * c.size_, record + c.record_offset_, c.size_);
+						if (++row == LOG_BLOCK_ROWS)flush_block();
 					}
+					imp_->binary_pipe_->release();
+					return true;
+				};
+
+				while (imp_->is_running_)
+				{
+					auto wrote_log = write_log();
+					auto wrote_record = write_record();
+					if (!wrote_log && !wrote_record)std::this_thread::sleep_for(std::chrono::microseconds(10));
 				}
 
 				// clean pipe //
-				while (imp_->log_pipe_->recvMsg(recv_msg))file << recv_msg.data();
+				while (write_log());
+				while (write_record());
+				if (binary)
+				{
+					flush_block();
+					block_file->close();
+				}
 				file.close();
 			}, std::move(thread_ready));
 
@@ -89,26 +344,276 @@ namespace aris
 			if (!imp_->is_running_)throw std::runtime_error("failed to stop DataLogger, because it's not running");
 			imp_->is_running_ = false;
 			imp_->log_thread_.join();
+
+			auto block_file = std::move(imp_->block_file_);
+			if (block_file && !block_file->error().empty())
+				throw std::runtime_error("DataLogger failed to write file \"" + imp_->file_name_ + "\": " + block_file->error() + ", data after the error are lost");
+		}
+		auto DataLogger::addChannel(const std::string &name, DataType type, const std::string &unit)->std::size_t
+		{
+			std::unique_lock<std::mutex> running_lck(imp_->mu_running_);
+			if (imp_->is_running_)throw std::runtime_error("failed to add channel to DataLogger, because it's running");
+			if (type > FLOAT64)throw std::runtime_error("failed to add channel to DataLogger, because data type is invalid");
+			if (name.size() > 0xFFFF || unit.size() > 0xFFFF)throw std::runtime_error("failed to add channel to DataLogger, because name or unit is too long");
+
+			Imp::Channel c{ name, unit, type, log_type_size(type), imp_->record_size_, 0 };
+			imp_->channels_.push_back(c);
+			imp_->record_size_ += c.size_;
+
+			// 列的位置：块头，index 列，之后依次为各通道的列 //
+			std::size_t offset = LOG_BLOCK_HEADER_SIZE + LOG_BLOCK_ROWS * sizeof(std::uint64_t);
+			for (auto &ch : imp_->channels_)
+			{
+				ch.column_offset_ = static_cast<std::uint32_t>(offset);
+				offset += LOG_BLOCK_ROWS * ch.size_;
+			}
+			imp_->block_size_ = static_cast<std::uint32_t>(log_align(offset, LogAlignedBuffer::LOG_ALIGNMENT));
+
+			return imp_->channels_.size() - 1;
+		}
+		auto DataLogger::clearChannels()->void
+		{
+			std::unique_lock<std::mutex> running_lck(imp_->mu_running_);
+			if (imp_->is_running_)throw std::runtime_error("failed to clear channels of DataLogger, because it's running");
+			imp_->channels_.clear();
+			imp_->record_size_ = sizeof(std::uint64_t);
+			imp_->block_size_ = 0;
+		}
+		auto DataLogger::channelSize()const->std::size_t { return imp_->channels_.size(); }
+		auto DataLogger::setDirectIo(bool direct_io)->void { imp_->direct_io_ = direct_io; }
+		auto DataLogger::beginRecord()->bool
+		{
+			const auto session = imp_->session_.load();
+			if (session != imp_->rt_session_)
+			{
+				imp_->rt_session_ = session;
+				imp_->record_index_ = 0;
+			}
+			auto index = imp_->record_index_++;
+			if (imp_->channels_.empty() || !imp_->is_running_)return false;
+			auto header = imp_->binary_pipe_->reserve(imp_->record_size_);
+			if (!header) return false;
+			header->reserved1_ = session;
+
+			imp_->record_ = reinterpret_cast<char*>(header + 1);
+			std::fill_n(imp_->record_, imp_->record_size_, 0);
+			std::memcpy(imp_->record_, &index, sizeof(index));
+			return true;
+		}
+		auto DataLogger::setChannel(std::size_t id, double value)->void
+		{
+			if (!imp_->record_ || id >= imp_->channels_.size())return;
+			auto &c = imp_->channels_[id];
+			auto p = imp_->record_ + c.record_offset_;
+			switch (c.type_)
+			{
+			case INT32: { auto v = static_cast<std::int32_t>(value); std::memcpy(p, &v, 4); break; }
+			case INT64: { auto v = static_cast<std::int64_t>(value); std::memcpy(p, &v, 8); break; }
+			case FLOAT32: { auto v = static_cast<float>(value); std::memcpy(p, &v, 4); break; }
+			case FLOAT64: { std::memcpy(p, &value, 8); break; }
+			}
+		}
+		auto DataLogger::setChannel(std::size_t id, std::int64_t value)->void
+		{
+			if (!imp_->record_ || id >= imp_->channels_.size())return;
+			auto &c = imp_->channels_[id];
+			auto p = imp_->record_ + c.record_offset_;
+			switch (c.type_)
+			{
+			case INT32: { auto v = static_cast<std::int32_t>(value); std::memcpy(p, &v, 4); break; }
+			case INT64: { std::memcpy(p, &value, 8); break; }
+			case FLOAT32: { auto v = static_cast<float>(value); std::memcpy(p, &v, 4); break; }
+			case FLOAT64: { auto v = static_cast<double>(value); std::memcpy(p, &v, 8); break; }
+			}
+		}
+		auto DataLogger::commitRecord()->void
+		{
+			if (!imp_->record_)return;
+			imp_->binary_pipe_->commit();
+			imp_->record_ = nullptr;
 		}
 		auto DataLogger::lout()->aris::core::MsgStream & { return *imp_->log_msg_stream_; }
 		auto DataLogger::send()->void
 		{
 			lout().update();
-			if (!imp_->log_msg_.empty())
+			if (!imp_->log_msg_->empty())
 			{
 				lout() << '\0';
 				lout().update();
-				imp_->log_pipe_->sendMsg(imp_->log_msg_);
-				imp_->log_msg_.resize(0);
+				imp_->log_msg_->send();
 				lout().resetBuf();
 			}
 		}
 		DataLogger::~DataLogger() = default;
 		DataLogger::DataLogger(const std::string &name) :Object(name), imp_(new Imp)
 		{
-			imp_->log_pipe_ = &add<aris::core::Pipe>("pipe", 16384);
+			imp_->bindLogPipe(&add<aris::core::Pipe>("pipe", 16384));
+			imp_->binary_pipe_ = &add<aris::core::Pipe>("binary_pipe", 262144);
 		}
 
+		struct DataLogReader::Imp
+		{
+			std::string file_name_;
+			std::vector<Channel> channels_;
+			std::uint32_t block_rows_{ 0 }, block_size_{ 0 }, header_size_{ 0 };
+			std::vector<std::uint32_t> block_row_num_;
+
+			// 读取每个块中的一列，row_size 为每行的字节数 //
+			auto readColumn(std::size_t column_offset, std::size_t row_size, const std::function<void(const char*, std::uint32_t)> &func)const->void
+			{
+				std::ifstream file(file_name_.c_str(), std::ios::in | std::ios::binary);
+				if (!file.is_open())throw std::runtime_error("failed to read log file \"" + file_name_ + "\"");
+
+				std::vector<char> buf(block_rows_ * row_size);
+				for (std::size_t i = 0; i < block_row_num_.size(); ++i)
+				{
+					file.seekg(static_cast<std::streamoff>(header_size_) + static_cast<std::streamoff>(i) * block_size_ + column_offset);
+					file.read(buf.data(), block_row_num_[i] * row_size);
+					if (!file)throw std::runtime_error("failed to read log file \"" + file_name_ + "\", because file is truncated");
+					func(buf.data(), block_row_num_[i]);
+				}
+			}
+		};
+		auto DataLogReader::open(const std::string &file_name)->void
+		{
+			std::ifstream file(file_name.c_str(), std::ios::in | std::ios::binary);
+			if (!file.is_open())throw std::runtime_error("failed to open log file \"" + file_name + "\"");
+
+			char magic[8];
+			std::uint32_t version, channel_num, block_rows, block_size, header_size;
+			file.read(magic, 8);
+			file.read(reinterpret_cast<char*>(&version), 4);
+			file.read(reinterpret_cast<char*>(&channel_num), 4);
+			file.read(reinterpret_cast<char*>(&block_rows), 4);
+			file.read(reinterpret_cast<char*>(&block_size), 4);
+			file.read(reinterpret_cast<char*>(&header_size), 4);
+			if (!file || !std::equal(magic, magic + 8, LOG_MAGIC))throw std::runtime_error("failed to open log file \"" + file_name + "\", because it's not an aris log file");
+			if (version != LOG_VERSION)throw std::runtime_error("failed to open log file \"" + file_name + "\", because version " + std::to_string(version) + " is not supported");
+
+			std::vector<Channel> channels;
+			for (std::uint32_t i = 0; i < channel_num; ++i)
+			{
+				std::uint8_t type, size;
+				std::uint16_t name_len, unit_len, reserved;
+				std::uint32_t column_offset;
+				file.read(reinterpret_cast<char*>(&type), 1);
+				file.read(reinterpret_cast<char*>(&size), 1);
+				file.read(reinterpret_cast<char*>(&name_len), 2);
+				file.read(reinterpret_cast<char*>(&unit_len), 2);
+				file.read(reinterpret_cast<char*>(&reserved), 2);
+				file.read(reinterpret_cast<char*>(&column_offset), 4);
+				std::string name(name_len, '\0'), unit(unit_len, '\0');
+				file.read(&name[0], name_len);
+				file.read(&unit[0], unit_len);
+				if (!file || type > DataLogger::FLOAT64)throw std::runtime_error("failed to open log file \"" + file_name + "\", because channel header is invalid");
+				channels.push_back(Channel{ name, unit, static_cast<DataLogger::DataType>(type), size, column_offset });
+			}
+
+			std::vector<std::uint32_t> block_row_num;
+			for (std::streamoff pos = header_size;; pos += block_size)
+			{
+				std::uint32_t row_num;
+				file.seekg(pos);
+				file.read(reinterpret_cast<char*>(&row_num), 4);
+				if (!file)break;
+				block_row_num.push_back(std::min(row_num, block_rows));
+			}
+
+			imp_->file_name_ = file_name;
+			imp_->channels_ = std::move(channels);
+			imp_->block_rows_ = block_rows;
+			imp_->block_size_ = block_size;
+			imp_->header_size_ = header_size;
+			imp_->block_row_num_ = std::move(block_row_num);
+		}
+		auto DataLogReader::channels()const->const std::vector<Channel>& { return imp_->channels_; }
+		auto DataLogReader::rowSize()const->std::size_t { return std::accumulate(imp_->block_row_num_.begin(), imp_->block_row_num_.end(), std::size_t(0)); }
+		auto DataLogReader::indexColumn()const->std::vector<std::uint64_t>
+		{
+			std::vector<std::uint64_t> ret;
+			ret.reserve(rowSize());
+			imp_->readColumn(LOG_BLOCK_HEADER_SIZE, sizeof(std::uint64_t), [&](const char *data, std::uint32_t row_num)
+			{
+				auto begin = reinterpret_cast<const std::uint64_t*>(data);
+				ret.insert(ret.end(), begin, begin + row_num);
+			});
+			return ret;
+		}
+		auto DataLogReader::column(std::size_t channel_id)const->std::vector<double>
+		{
+			if (channel_id >= imp_->channels_.size())throw std::runtime_error("failed to read column " + std::to_string(channel_id) + " of log file, because it's out of range");
+			auto &c = imp_->channels_[channel_id];
+
+			std::vector<double> ret;
+			ret.reserve(rowSize());
+			imp_->readColumn(c.column_offset_, c.size_, [&](const char *data, std::uint32_t row_num)
+			{
+				for (std::uint32_t i = 0; i < row_num; ++i)
+				{
+					auto p = data + i * c.size_;
+					switch (c.type_)
+					{
+					case DataLogger::INT32: { std::int32_t v; std::memcpy(&v, p, 4); ret.push_back(v); break; }
+					case DataLogger::INT64: { std::int64_t v; std::memcpy(&v, p, 8); ret.push_back(static_cast<double>(v)); break; }
+					case DataLogger::FLOAT32: { float v; std::memcpy(&v, p, 4); ret.push_back(v); break; }
+					case DataLogger::FLOAT64: { double v; std::memcpy(&v, p, 8); ret.push_back(v); break; }
+					}
+				}
+			});
+			return ret;
+		}
+		auto DataLogReader::intColumn(std::size_t channel_id)const->std::vector<std::int64_t>
+		{
+			if (channel_id >= imp_->channels_.size())throw std::runtime_error("failed to read column " + std::to_string(channel_id) + " of log file, because it's out of range");
+			auto &c = imp_->channels_[channel_id];
+			if (c.type_ != DataLogger::INT32 && c.type_ != DataLogger::INT64)throw std::runtime_error("failed to read column \"" + c.name_ + "\" of log file as integer, because it's a float channel");
+
+			std::vector<std::int64_t> ret;
+			ret.reserve(rowSize());
+			imp_->readColumn(c.column_offset_, c.size_, [&](const char *data, std::uint32_t row_num)
+			{
+				for (std::uint32_t i = 0; i < row_num; ++i)
+				{
+					if (c.type_ == DataLogger::INT32) { std::int32_t v; std::memcpy(&v, data + i * 4, 4); ret.push_back(v); }
+					else { std::int64_t v; std::memcpy(&v, data + i * 8, 8); ret.push_back(v); }
+				}
+			});
+			return ret;
+		}
+		auto DataLogReader::writeCsv(std::ostream &os)const->void
+		{
+			auto is_int = [](const Channel &c) { return c.type_ == DataLogger::INT32 || c.type_ == DataLogger::INT64; };
+
+			// 整数通道单独读取，不经过 double //
+			auto index = indexColumn();
+			std::vector<std::vector<double>> columns(imp_->channels_.size());
+			std::vector<std::vector<std::int64_t>> int_columns(imp_->channels_.size());
+			for (std::size_t i = 0; i < imp_->channels_.size(); ++i)
+			{
+				if (is_int(imp_->channels_[i])) int_columns[i] = intColumn(i);
+				else columns[i] = column(i);
+			}
+
+			os << "index";
+			for (auto &c : imp_->channels_) os << "," << c.name_ << (c.unit_.empty() ? "" : "[" + c.unit_ + "]");
+			os << "\n";
+
+			auto precision = os.precision(std::numeric_limits<double>::max_digits10);
+			for (std::size_t r = 0; r < index.size(); ++r)
+			{
+				os << index[r];
+				for (std::size_t i = 0; i < columns.size(); ++i)
+				{
+					if (is_int(imp_->channels_[i])) os << "," << int_columns[i][r];
+					else os << "," << columns[i][r];
+				}
+				os << "\n";
+			}
+			os.precision(precision);
+		}
+		DataLogReader::~DataLogReader() = default;
+		DataLogReader::DataLogReader() :imp_(new Imp) {}
+
 		struct Slave::Imp
 		{
 		public:
@@ -135,31 +640,146 @@ namespace aris
 		Slave& Slave::operator=(const Slave &other) = default;
 		Slave& Slave::operator=(Slave &&other) = default;
 
+		// 实时日志在管道中的记录，之后紧跟 arg_num_ 个 RtLogArg //
+		struct RtLogRecord
+		{
+			const char *format_;
+			std::int32_t arg_num_;
+			std::int32_t dropped_num_;// 在这条记录之前因缓冲区满而丢弃的记录数
+		};
+		auto format_rt_log(const RtLogRecord &record)->std::string
+		{
+			auto args = reinterpret_cast<const RtLogArg *>(&record + 1);
+			auto print_arg = [](std::ostream &os, const RtLogArg &arg)
+			{
+				switch (arg.type_)
+				{
+				case RtLogArg::INT: os << arg.i_; break;
+				case RtLogArg::UINT: os << arg.u_; break;
+				case RtLogArg::DOUBLE: os << arg.d_; break;
+				case RtLogArg::STRING: os << (arg.s_ ? arg.s_ : "(null)"); break;
+				default: break;
+				}
+			};
+
+			std::ostringstream os;
+			if (record.dropped_num_)os << "(" << record.dropped_num_ << " rt log dropped) ";
+
+			int i = 0;
+			for (auto p = record.format_; *p; ++p)
+			{
+				if (p[0] == '{' && p[1] == '}' && i < record.arg_num_) { print_arg(os, args[i++]); ++p; }
+				else os << *p;
+			}
+			for (; i < record.arg_num_; ++i) { os << ' '; print_arg(os, args[i]); }
+			return os.str();
+		}
+
 		struct Master::Imp
 		{
 		public:
+			// 单写多读的直方图，只有实时线程写入 //
+			struct Histogram
+			{
+				enum { BUCKET_NS = 1000, BUCKET_SIZE = 2048 };
+				std::atomic<std::int64_t> count_, sum_, min_, max_;
+				std::atomic<std::int64_t> buckets_[BUCKET_SIZE];
+
+				auto reset()->void
+				{
+					count_.store(0, std::memory_order_relaxed);
+					sum_.store(0, std::memory_order_relaxed);
+					min_.store(std::numeric_limits<std::int64_t>::max(), std::memory_order_relaxed);
+					max_.store(0, std::memory_order_relaxed);
+					for (auto &b : buckets_)b.store(0, std::memory_order_relaxed);
+				}
+				auto record(std::int64_t ns)->void
+				{
+					ns = std::max(ns, std::int64_t(0));
+					auto &bucket = buckets_[std::min(ns / BUCKET_NS, std::int64_t(BUCKET_SIZE - 1))];
+					bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					sum_.store(sum_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+					if (ns < min_.load(std::memory_order_relaxed))min_.store(ns, std::memory_order_relaxed);
+					if (ns > max_.load(std::memory_order_relaxed))max_.store(ns, std::memory_order_relaxed);
+					count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+				}
+				auto statistics()const->RtPhaseStatistics
+				{
+					RtPhaseStatistics s;
+					auto count = count_.load(std::memory_order_acquire);
+					if (count == 0) return s;
+
+					s.min_ns_ = min_.load(std::memory_order_relaxed);
+					s.max_ns_ = max_.load(std::memory_order_relaxed);
+					s.avr_ns_ = sum_.load(std::memory_order_relaxed) / count;
+
+					// 读取期间实时线程可能继续写入，因此以桶的总数为准 //
+					std::int64_t snapshot[BUCKET_SIZE], total{ 0 };
+					for (int i = 0; i < BUCKET_SIZE; ++i)total += (snapshot[i] = buckets_[i].load(std::memory_order_relaxed));
+
+					auto percentile = [&](double p)->std::int64_t
+					{
+						std::int64_t target = static_cast<std::int64_t>(std::ceil(p * total)), accumulated{ 0 };
+						for (int i = 0; i < BUCKET_SIZE - 1; ++i)
+							if ((accumulated += snapshot[i]) >= target) return std::max(s.min_ns_, std::min(s.max_ns_, static_cast<std::int64_t>(i + 1) * BUCKET_NS));
+						return s.max_ns_;
+					};
+					s.p50_ns_ = percentile(0.5);
+					s.p99_ns_ = percentile(0.99);
+					s.p999_ns_ = percentile(0.999);
+					return s;
+				}
+			};
+			enum { LATENCY = 0, RECV, STRATEGY, SYNC, SEND, CYCLE, PHASE_SIZE };
+
 			static auto rt_task_func(void *master)->void
 			{
 				auto &mst = *reinterpret_cast<Master*>(master);
 
 				aris_rt_task_set_periodic(mst.imp_->sample_period_ns_);
 
+				auto &stat = mst.imp_->histograms_;
+				auto reset = [&]()
+				{
+					for (auto &h : stat)h.reset();
+					mst.imp_->overrun_count_.store(0, std::memory_order_relaxed);
+				};
+				reset();
+				
+				auto expected_time = aris_rt_timer_read();
 				while (mst.imp_->is_running_)
 				{
 					// rt timer //
 					aris_rt_task_wait_period();
+					expected_time += mst.imp_->sample_period_ns_;
+					if (mst.imp_->reset_statistics_.load(std::memory_order_relaxed) && mst.imp_->reset_statistics_.exchange(false))reset();
+					auto wake_time = aris_rt_timer_read();
 
 					// receive //
 					mst.recv();
+					auto recv_time = aris_rt_timer_read();
 
 					// tragectory generator //
 					if (mst.imp_->strategy_)mst.imp_->strategy_();
+					auto strategy_time = aris_rt_timer_read();
 
 					// sync
 					mst.sync();
+					auto sync_time = aris_rt_timer_read();
 
 					// send
 					mst.send();
+					auto send_time = aris_rt_timer_read();
+
+					// statistics //
+					stat[LATENCY].record(wake_time - expected_time);
+					stat[RECV].record(recv_time - wake_time);
+					stat[STRATEGY].record(strategy_time - recv_time);
+					stat[SYNC].record(sync_time - strategy_time);
+					stat[SEND].record(send_time - sync_time);
+					stat[CYCLE].record(send_time - wake_time);
+					if (send_time - expected_time > mst.imp_->sample_period_ns_)
+						mst.imp_->overrun_count_.store(mst.imp_->overrun_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 				}
 			}
 
@@ -170,12 +790,61 @@ namespace aris
 			// for log //
 			DataLogger* data_logger_;
 
+			// rt task config //
+			RTTimer* rt_timer_;
+
+			// for rt log //
+			aris::core::Pipe *rt_log_pipe_;
+			std::thread rt_log_thread_;
+			std::atomic_bool is_rt_log_running_{ false };
+			std::function<void(const std::string &)> rt_log_handler_{ [](const std::string &text) { aris::core::log(text); } };
+			std::int32_t rt_log_dropped_num_{ 0 };
+
+			auto startRtLog()->void
+			{
+				is_rt_log_running_ = true;
+				rt_log_thread_ = std::thread([this]()
+				{
+					auto write_log = [this]()->bool
+					{
+						auto header = rt_log_pipe_->peek();
+						if (!header) return false;
+						if (header->msg_size_ > 0) rt_log_handler_(format_rt_log(*reinterpret_cast<const RtLogRecord *>(header + 1)));
+						rt_log_pipe_->release();
+						return true;
+					};
+
+					while (is_rt_log_running_)
+					{
+						if (!write_log())std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					}
+
+					// clean pipe //
+					while (write_log());
+				});
+			}
+			auto stopRtLog()->void
+			{
+				if (!rt_log_thread_.joinable()) return;
+				is_rt_log_running_ = false;
+				rt_log_thread_.join();
+			}
+
 			// for msg in and out //
 			aris::core::Pipe *pipe_in_;
 			aris::core::Pipe *pipe_out_;
-			aris::core::MsgFix<MAX_MSG_SIZE> out_msg_, in_msg_;
+			aris::core::MsgFix<MAX_MSG_SIZE> in_msg_;
+			std::unique_ptr<aris::core::PipeMsg> out_msg_;
 			std::unique_ptr<aris::core::MsgStream> out_msg_stream_;
 
+			// mout() 直接写在 pipe_out_ 的缓冲区中 //
+			auto bindOutPipe(aris::core::Pipe *pipe)->void
+			{
+				pipe_out_ = pipe;
+				out_msg_.reset(new aris::core::PipeMsg(*pipe, MAX_MSG_SIZE));
+				out_msg_stream_.reset(new aris::core::MsgStream(*out_msg_));
+			}
+
 			// strategy //
 			std::function<void()> strategy_{ nullptr };
 
@@ -185,11 +854,20 @@ namespace aris
 
 			const int sample_period_ns_{ 1000000 };
 
+			// rt statistics //
+			Histogram histograms_[PHASE_SIZE];
+			std::atomic<std::int64_t> overrun_count_{ 0 };
+			std::atomic_bool reset_statistics_{ false };
+
 			aris::core::ImpPtr<Handle> rt_task_handle_;
 			aris::core::ImpPtr<Handle> ec_handle_;
 
 
-			Imp() { out_msg_stream_.reset(new aris::core::MsgStream(out_msg_)); }
+			Imp() 
+			{ 
+				for (auto &h : histograms_)h.reset();
+			}
+			~Imp() { stopRtLog(); }
 
 			friend class Slave;
 			friend class Master;
@@ -201,16 +879,17 @@ namespace aris
 			imp_->slave_pool_ = findByName("slave_pool") == children().end() ? &add<aris::core::ObjectPool<Slave, Object> >("slave_pool") : static_cast<aris::core::ObjectPool<Slave, Object> *>(&(*findByName("slave_pool")));
 			imp_->data_logger_ = findByName("data_logger") == children().end() ? &add<DataLogger>("data_logger") : static_cast<DataLogger*>(&(*findByName("data_logger")));
 			imp_->pipe_in_ = findOrInsert<aris::core::Pipe>("msg_pipe_in");
-			imp_->pipe_out_ = findOrInsert<aris::core::Pipe>("msg_pipe_out");
+			imp_->bindOutPipe(findOrInsert<aris::core::Pipe>("msg_pipe_out"));
+			imp_->rt_timer_ = findOrInsert<RTTimer>("rt_timer");
+			imp_->rt_log_pipe_ = findOrInsert<aris::core::Pipe>("rt_log_pipe", 65536);
 		}
 		auto Master::start()->void
 		{
 			std::unique_lock<std::mutex> running_lck(imp_->mu_running_);
 			if (imp_->is_running_)throw std::runtime_error("master already running, so cannot start");
-			imp_->is_running_ = true;
-
 
 			// make mot_vec_phy2abs //
+			imp_->sla_vec_phy2abs_.clear();
 			for (auto &sla : slavePool())
 			{
 				imp_->sla_vec_phy2abs_.resize(std::max(static_cast<aris::Size>(sla.phyId() + 1), imp_->sla_vec_phy2abs_.size()), -1);
@@ -220,14 +899,34 @@ namespace aris
 
 			// init child master //
 			init();
+			imp_->is_running_ = true;
 			
 			// lock memory // 
 			aris_mlockall();
 
-			// create and start rt task //
-			imp_->rt_task_handle_.reset(aris_rt_task_create());
-			if (imp_->rt_task_handle_.get() == nullptr) throw std::runtime_error("rt_task_create failed");
-			if (aris_rt_task_start(imp_->rt_task_handle_.get(), &Imp::rt_task_func, this))throw std::runtime_error("rt_task_start failed");
+			// mout() 从这里开始直接写入管道 //
+			mout().update();
+			imp_->out_msg_->acquire();
+			mout().resetBuf();
+
+			// start rt log thread //
+			imp_->rt_log_dropped_num_ = 0;
+			imp_->startRtLog();
+
+			// create and start rt task, 失败时回滚到未启动的状态，之后可以再次 start //
+			auto rollback = [this](const std::string &what)
+			{
+				imp_->is_running_ = false;
+				imp_->stopRtLog();
+				imp_->rt_task_handle_.reset(nullptr);
+				release();
+				throw std::runtime_error(what);
+			};
+			imp_->rt_task_handle_.reset(aris_rt_task_create(rtTimer().config()));
+			if (imp_->rt_task_handle_.get() == nullptr) rollback("rt_task_create failed");
+			if (auto ret = aris_rt_task_start(imp_->rt_task_handle_.get(), &Imp::rt_task_func, this))
+				rollback("rt_task_start failed: " + std::string(std::strerror(-ret)) + " (errno " + std::to_string(-ret) + ", priority " 
+					+ std::to_string(rtTimer().config().priority_) + ", cpu " + std::to_string(rtTimer().config().cpu_) + ")");
 		}
 		auto Master::stop()->void
 		{
@@ -240,6 +939,9 @@ namespace aris
 			
 			// release child resources //
 			release();
+
+			// write remaining rt log //
+			imp_->stopRtLog();
 		}
 		auto Master::setControlStrategy(std::function<void()> strategy)->void
 		{
@@ -247,16 +949,52 @@ namespace aris
 			if (imp_->is_running_)throw std::runtime_error("master already running, cannot set control strategy");
 			imp_->strategy_ = strategy;
 		}
+		auto Master::statistics()const->RtStatistics
+		{
+			RtStatistics s;
+			s.latency_ = imp_->histograms_[Imp::LATENCY].statistics();
+			s.recv_ = imp_->histograms_[Imp::RECV].statistics();
+			s.strategy_ = imp_->histograms_[Imp::STRATEGY].statistics();
+			s.sync_ = imp_->histograms_[Imp::SYNC].statistics();
+			s.send_ = imp_->histograms_[Imp::SEND].statistics();
+			s.cycle_ = imp_->histograms_[Imp::CYCLE].statistics();
+			s.cycle_count_ = imp_->histograms_[Imp::CYCLE].count_.load(std::memory_order_acquire);
+			s.overrun_count_ = imp_->overrun_count_.load(std::memory_order_relaxed);
+			return s;
+		}
+		auto Master::resetStatistics()->void { imp_->reset_statistics_ = true; }
+		auto Master::setRtLogHandler(std::function<void(const std::string &)> handler)->void
+		{
+			std::unique_lock<std::mutex> running_lck(imp_->mu_running_);
+			if (imp_->is_running_)throw std::runtime_error("master already running, cannot set rt log handler");
+			imp_->rt_log_handler_ = handler;
+		}
+		auto Master::rtLogArgs(const char *format, const RtLogArg *args, int arg_num)->void
+		{
+			auto header = imp_->rt_log_pipe_->reserve(static_cast<aris::core::MsgSize>(sizeof(RtLogRecord) + arg_num * sizeof(RtLogArg)));
+			if (!header)
+			{
+				++imp_->rt_log_dropped_num_;
+				return;
+			}
+
+			auto record = reinterpret_cast<RtLogRecord *>(header + 1);
+			record->format_ = format;
+			record->arg_num_ = arg_num;
+			record->dropped_num_ = imp_->rt_log_dropped_num_;
+			std::memcpy(record + 1, args, arg_num * sizeof(RtLogArg));
+			imp_->rt_log_pipe_->commit();
+			imp_->rt_log_dropped_num_ = 0;
+		}
 		auto Master::rtHandle()->Handle* { return imp_->rt_task_handle_.get(); }
 		auto Master::msgIn()->aris::core::MsgFix<MAX_MSG_SIZE>& { return imp_->in_msg_; }
-		auto Master::msgOut()->aris::core::MsgFix<MAX_MSG_SIZE>& { return imp_->out_msg_; }
+		auto Master::msgOut()->aris::core::MsgBase& { return *imp_->out_msg_; }
 		auto Master::mout()->aris::core::MsgStream & { return *imp_->out_msg_stream_; }
 		auto Master::sendOut()->void
 		{
-			if (!imp_->out_msg_.empty())
+			if (!imp_->out_msg_->empty())
 			{
-				imp_->pipe_out_->sendMsg(imp_->out_msg_);
-				imp_->out_msg_.resize(0);
+				imp_->out_msg_->send();
 				mout().resetBuf();
 			}
 		}
@@ -266,6 +1004,7 @@ namespace aris
 		auto Master::slaveAtPhy(aris::Size id)->Slave& { return slavePool().at(imp_->sla_vec_phy2abs_.at(id)); }
 		auto Master::slavePool()->aris::core::ObjectPool<Slave, aris::core::Object>& { return *imp_->slave_pool_; }
 		auto Master::dataLogger()->DataLogger& { return *imp_->data_logger_; }
+		auto Master::rtTimer()->RTTimer& { return *imp_->rt_timer_; }
 		Master::~Master() = default;
 		Master::Master(const std::string &name) :imp_(new Imp), Object(name)
 		{
@@ -277,7 +1016,9 @@ namespace aris
 			imp_->slave_pool_ = &add<aris::core::ObjectPool<Slave> >("slave_pool");
 			imp_->data_logger_ = &add<DataLogger>("data_logger");
 			imp_->pipe_in_ = &add<aris::core::Pipe>("msg_pipe_in");
-			imp_->pipe_out_ = &add<aris::core::Pipe>("msg_pipe_out");
+			imp_->bindOutPipe(&add<aris::core::Pipe>("msg_pipe_out"));
+			imp_->rt_timer_ = &add<RTTimer>("rt_timer");
+			imp_->rt_log_pipe_ = &add<aris::core::Pipe>("rt_log_pipe", 65536);
 		}
     }
 }
@@ -4,6 +4,11 @@
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <ostream>
 
 #include <aris_core.h>
 #include <aris_control_rt_timer.h>
@@ -19,9 +24,11 @@ namespace aris
 			auto virtual type() const->const std::string& override{ return Type(); }
 			auto virtual saveXml(aris::core::XmlElement &xml_ele) const->void override;
 			auto virtual loadXml(const aris::core::XmlElement &xml_ele)->void override;
+			auto config()const->const RtTaskConfig&;
+			auto setConfig(const RtTaskConfig &config)->void;
 
 			virtual ~RTTimer();
-			explicit RTTimer(const std::string &name = "rt_timer");
+			explicit RTTimer(const std::string &name = "rt_timer", int priority = 0, int cpu = -1, int spin_ns = 0);
 			RTTimer(const RTTimer &) = delete;
 			RTTimer(RTTimer &&) = delete;
 			RTTimer& operator=(const RTTimer &) = delete;
@@ -35,16 +42,33 @@ namespace aris
 		{
 		public:
 			enum { MAX_LOG_DATA_SIZE = 8192 };
+			/// 二进制日志中通道的数据类型
+			enum DataType : std::uint8_t { INT32 = 0, INT64 = 1, FLOAT32 = 2, FLOAT64 = 3 };
 			static auto Type()->const std::string &{ static const std::string type("DataLogger"); return std::ref(type); }
 			auto virtual type() const->const std::string& override{ return Type(); }
 			auto virtual saveXml(aris::core::XmlElement &xml_ele) const->void override;
 			auto virtual loadXml(const aris::core::XmlElement &xml_ele)->void override;
+			/// 声明过通道时以二进制列存格式写入，否则写入 lout() 的文本
 			auto start(const std::string &log_file_name = std::string())->void;
 			auto stop()->void;
+			// 二进制通道，只能在 start 之前修改，返回通道的 id //
+			auto addChannel(const std::string &name, DataType type, const std::string &unit = std::string())->std::size_t;
+			auto clearChannels()->void;
+			auto channelSize()const->std::size_t;
+			// 使用 O_DIRECT 写入二进制日志，文件系统不支持时退化为普通写入 //
+			auto setDirectIo(bool direct_io)->void;
 			// use in rt thread //
 			auto send()->void;
 			auto lout()->aris::core::MsgStream &;
 			auto lout()const->const aris::core::MsgStream &{ return const_cast<DataLogger*>(this)->lout(); };
+			// 在管道中直接预留一条记录，未 set 的通道为 0，管道满时返回 false 并丢弃这条记录 //
+			auto beginRecord()->bool;
+			auto setChannel(std::size_t id, double value)->void;
+			auto setChannel(std::size_t id, std::int64_t value)->void;
+			/// 其余整数类型（int、unsigned、std::size_t 等）都按 int64 写入，避免与上面两个重载产生歧义
+			template<typename T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, std::int64_t>::value>* = nullptr>
+			auto setChannel(std::size_t id, T value)->void { setChannel(id, static_cast<std::int64_t>(value)); }
+			auto commitRecord()->void;
 
 			virtual ~DataLogger();
 			explicit DataLogger(const std::string &name = "data_logger");
@@ -53,6 +77,44 @@ namespace aris
 			DataLogger& operator=(const DataLogger &) = delete;
 			DataLogger& operator=(DataLogger &&) = delete;
 
+		private:
+			struct Imp;
+			aris::core::ImpPtr<Imp> imp_;
+		};
+		/// 读取 DataLogger 写出的二进制日志，按列读取时只访问该列的数据
+		///
+		/// 文件格式（本机字节序）：
+		///   文件头，长度为 header_size，按 4096 对齐：
+		///     "ARISLOG1", version, channel_num, block_rows, block_size, header_size (均为 uint32)
+		///     每个通道：type (uint8), size (uint8), name_len (uint16), unit_len (uint16), reserved (uint16), column_offset (uint32), name, unit
+		///   之后为若干长度为 block_size 的数据块：
+		///     row_num (uint32), reserved (uint32), first_index (uint64)
+		///     index 列：block_rows 个 uint64，为 beginRecord 的序号，不连续说明有记录被丢弃
+		///     各通道的列：位于块内 column_offset 处，block_rows 个数据
+		class DataLogReader
+		{
+		public:
+			struct Channel
+			{
+				std::string name_, unit_;
+				DataLogger::DataType type_;
+				std::uint32_t size_, column_offset_;
+			};
+			auto open(const std::string &file_name)->void;
+			auto channels()const->const std::vector<Channel>&;
+			auto rowSize()const->std::size_t;
+			auto indexColumn()const->std::vector<std::uint64_t>;
+			/// INT64 通道超过 2^53 时会损失精度，此时使用 intColumn
+			auto column(std::size_t channel_id)const->std::vector<double>;
+			/// 只能读取 INT32 与 INT64 通道，不经过 double
+			auto intColumn(std::size_t channel_id)const->std::vector<std::int64_t>;
+			auto writeCsv(std::ostream &os)const->void;
+
+			~DataLogReader();
+			DataLogReader();
+			DataLogReader(const DataLogReader &) = delete;
+			DataLogReader& operator=(const DataLogReader &) = delete;
+
 		private:
 			struct Imp;
 			aris::core::ImpPtr<Imp> imp_;
@@ -80,6 +142,37 @@ namespace aris
 			struct Imp;
 			aris::core::ImpPtr<Imp> imp_;
 		};
+		/// 实时日志的参数，只保存原始数值，在后台线程中格式化
+		/// 字符串参数只保存指针，必须在日志写出之前一直有效，通常使用字符串字面量
+		struct RtLogArg
+		{
+			enum Type : std::uint8_t { NONE, INT, UINT, DOUBLE, STRING };
+			Type type_;
+			union { std::int64_t i_; std::uint64_t u_; double d_; const char *s_; };
+
+			RtLogArg() :type_(NONE), i_(0) {}
+			RtLogArg(const char *s) :type_(STRING), s_(s) {}
+			template<typename T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>* = nullptr>
+			RtLogArg(T value) :type_(INT), i_(value) {}
+			template<typename T, std::enable_if_t<std::is_integral<T>::value && !std::is_signed<T>::value>* = nullptr>
+			RtLogArg(T value) :type_(UINT), u_(value) {}
+			template<typename T, std::enable_if_t<std::is_floating_point<T>::value>* = nullptr>
+			RtLogArg(T value) :type_(DOUBLE), d_(value) {}
+		};
+		/// 实时周期中某个阶段的耗时统计，单位为 ns，百分位数的分辨率为 1 us
+		struct RtPhaseStatistics
+		{
+			std::int64_t min_ns_{ 0 }, max_ns_{ 0 }, avr_ns_{ 0 }, p50_ns_{ 0 }, p99_ns_{ 0 }, p999_ns_{ 0 };
+		};
+		/// 实时周期的统计，时间由 aris_rt_timer_read() 测得
+		struct RtStatistics
+		{
+			std::int64_t cycle_count_{ 0 };
+			std::int64_t overrun_count_{ 0 };  // send 结束时已经超过下个周期的次数
+			RtPhaseStatistics latency_;        // 唤醒时刻相对理想时刻的延迟
+			RtPhaseStatistics recv_, strategy_, sync_, send_;
+			RtPhaseStatistics cycle_;          // 从唤醒到 send 结束的总时间
+		};
 		class Master : public aris::core::Object
 		{
 		public:
@@ -91,15 +184,28 @@ namespace aris
 			auto start()->void;
 			auto stop()->void;
 			auto setControlStrategy(std::function<void()> strategy)->void;
+			// 可在实时线程运行时读取，reset 在下个周期生效 //
+			auto statistics()const->RtStatistics;
+			auto resetStatistics()->void;
+			// 设置后台线程写实时日志的函数，默认写入 aris::core::log //
+			auto setRtLogHandler(std::function<void(const std::string &)> handler)->void;
 			
 			// used in rt thread //
 			auto mout()->aris::core::MsgStream &;
 			auto msgIn()->aris::core::MsgFix<MAX_MSG_SIZE>&;
-			auto msgOut()->aris::core::MsgFix<MAX_MSG_SIZE>&;
+			auto msgOut()->aris::core::MsgBase&;
 			auto sendOut()->void;
 			auto recvOut(aris::core::MsgBase &recv_msg)->int;
 			auto sendIn(const aris::core::MsgBase &send_msg)->void;
 			auto recvIn()->int;
+			// 只拷贝 format 指针与参数，由后台线程将 format 中的 "{}" 依次替换为参数，缓冲区满时丢弃 //
+			template<typename... Args>
+			auto rtLog(const char *format, Args... args)->void
+			{
+				const RtLogArg arg_vec[] = { RtLogArg(), RtLogArg(args)... };
+				rtLogArgs(format, arg_vec + 1, static_cast<int>(sizeof...(Args)));
+			}
+			auto rtLogArgs(const char *format, const RtLogArg *args, int arg_num)->void;
 			auto slaveAtAbs(aris::Size id)->Slave& { return slavePool().at(id); }
 			auto slaveAtAbs(aris::Size id)const->const Slave& { return const_cast<std::decay_t<decltype(*this)> *>(this)->slaveAtAbs(id); }
 			auto slaveAtPhy(aris::Size id)->Slave&;
@@ -108,6 +214,8 @@ namespace aris
 			auto slavePool()const->const aris::core::ObjectPool<Slave>&{ return const_cast<std::decay_t<decltype(*this)> *>(this)->slavePool(); }
 			auto dataLogger()->DataLogger&;
 			auto dataLogger()const->const DataLogger&{ return const_cast<std::decay_t<decltype(*this)> *>(this)->dataLogger(); }
+			auto rtTimer()->RTTimer&;
+			auto rtTimer()const->const RTTimer&{ return const_cast<std::decay_t<decltype(*this)> *>(this)->rtTimer(); }
 			auto rtHandle()->Handle*;
 			auto rtHandle()const->const Handle*{ return const_cast<std::decay_t<decltype(*this)> *>(this)->rtHandle(); }
 
@@ -7,10 +7,26 @@ extern "C"
 }
 #endif
 
+#if defined(UNIX) && !defined(USE_XENOMAI)
+extern "C"
+{
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+}
+#endif
+
 #include <chrono>
 #include <thread>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <future>
+#include <cstring>
+#include <stdexcept>
 
 #include "aris_control_ethercat_kernel.h"
 
@@ -19,22 +35,95 @@ namespace aris
 	namespace control
 	{
 #ifndef USE_XENOMAI
-        // should not have global variables
-		int nanoseconds{1000};
-		std::chrono::time_point<std::chrono::high_resolution_clock> last_time, begin_time;
-		//
+		// 超实时运行的配置，需在实时线程启动前设置 //
+		std::atomic<double> time_scale{ 1.0 };
+
+		// 周期状态只属于调用 aris_rt_task_set_periodic 的实时线程 //
+		struct RtTimerState
+		{
+			std::int64_t period_ns_{ 1000000 };
+			std::int64_t next_ns_{ 0 };
+			std::int64_t virtual_ns_{ 0 };
+			int spin_ns_{ 0 };
+		};
+		thread_local RtTimerState rt_timer_state;
+
+		struct RtTaskHandle :public Handle { std::thread task; RtTaskConfig config_; };
+
+#ifdef UNIX
+		auto now_ns()->std::int64_t
+		{
+			timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+		}
+		auto sleep_until_ns(std::int64_t ns)->void
+		{
+			timespec ts{ static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000) };
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR);
+		}
+		auto setup_rt_thread(const RtTaskConfig &config)->int
+		{
+			if (config.cpu_ >= 0)
+			{
+				if (config.cpu_ >= CPU_SETSIZE)return -EINVAL;
+				cpu_set_t cpu_set;
+				CPU_ZERO(&cpu_set);
+				CPU_SET(config.cpu_, &cpu_set);
+				if (auto err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set))return -err;
+			}
+			if (config.priority_ > 0)
+			{
+				sched_param param;
+				param.sched_priority = config.priority_;
+				if (auto err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param))return -err;
+			}
 
-		struct RtTaskHandle :public Handle { std::thread task; };
+			// 普通调度的线程默认有 50us 的 timer slack //
+			prctl(PR_SET_TIMERSLACK, 1);
 
+			// 预先访问栈，避免实时循环中的缺页 //
+			volatile char stack[256 * 1024];
+			for (std::size_t i = 0; i < sizeof(stack); i += 4096)stack[i] = 0;
+			return 0;
+		}
+		auto aris_mlockall()->void
+		{
+			// 非 root 或 RLIMIT_MEMLOCK 不足时会失败，此时不锁定内存，仅用于开发调试 //
+			mlockall(MCL_CURRENT | MCL_FUTURE);
+		}
+#else
+		auto now_ns()->std::int64_t { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+		auto sleep_until_ns(std::int64_t ns)->void { std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns))); }
+		auto setup_rt_thread(const RtTaskConfig &config)->int { return 0; }
 		auto aris_mlockall()->void {}
-		auto aris_rt_task_create()->Handle*
+#endif
+		auto aris_rt_task_create(const RtTaskConfig &config)->Handle*
 		{
 			std::unique_ptr<Handle> handle(new RtTaskHandle);
+			static_cast<RtTaskHandle*>(handle.get())->config_ = config;
 			return handle.release();
 		}
 		auto aris_rt_task_start(Handle* handle, void(*task_func)(void*), void*param)->int
 		{
-			static_cast<RtTaskHandle*>(handle)->task = std::thread(task_func, param);
+			auto rt_handle = static_cast<RtTaskHandle*>(handle);
+
+			// 调度策略与绑核需在实时线程中设置，失败时不运行 task_func //
+			std::promise<int> setup_ret;
+			auto fut = setup_ret.get_future();
+			rt_handle->task = std::thread([task_func, param](std::promise<int> setup_ret, RtTaskConfig config)
+			{
+				auto ret = setup_rt_thread(config);
+				rt_timer_state.spin_ns_ = config.spin_ns_;
+				setup_ret.set_value(ret);
+				if (ret == 0) task_func(param);
+			}, std::move(setup_ret), rt_handle->config_);
+
+			if (auto ret = fut.get())
+			{
+				rt_handle->task.join();
+				return ret;
+			}
 			return 0;
 		}
 		auto aris_rt_task_join(Handle* handle)->int
@@ -44,37 +133,49 @@ namespace aris
 		}
 		auto aris_rt_task_set_periodic(int nanoseconds)->int
 		{ 
-			control::nanoseconds = nanoseconds;
-			last_time = begin_time = std::chrono::high_resolution_clock::now();
+			rt_timer_state.period_ns_ = nanoseconds;
+			rt_timer_state.virtual_ns_ = 0;
+			rt_timer_state.next_ns_ = now_ns();
 			return 0;
 		};
 		auto aris_rt_task_wait_period()->int
 		{
-			last_time = last_time + std::chrono::nanoseconds(nanoseconds);
-			std::this_thread::sleep_until(last_time);
+			auto &s = rt_timer_state;
+			const auto scale = time_scale.load(std::memory_order_relaxed);
+
+			s.virtual_ns_ += s.period_ns_;
+			if (scale <= 0.0) return 0;
+
+			s.next_ns_ += static_cast<std::int64_t>(s.period_ns_ * scale);
+
+			// 先睡眠到唤醒前 spin_ns，再自旋到唤醒时刻 //
+			sleep_until_ns(s.next_ns_ - s.spin_ns_);
+			if (s.spin_ns_ > 0) while (now_ns() < s.next_ns_);
 			return 0;
 		};
 		auto aris_rt_timer_read()->std::int64_t
 		{
-			auto now = std::chrono::high_resolution_clock::now();
-			return std::chrono::duration_cast<std::chrono::nanoseconds>(now - begin_time).count();
+			return time_scale.load(std::memory_order_relaxed) != 1.0 ? rt_timer_state.virtual_ns_ : now_ns();
 		}
+		auto aris_rt_set_time_scale(double scale)->void { time_scale = scale; }
 #endif
 
 #ifdef USE_XENOMAI
 		struct RtTaskHandle :public Handle { RT_TASK task; };
 
 		auto aris_mlockall()->void { if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1) throw std::runtime_error("lock failed"); }
-		auto aris_rt_task_create()->Handle*
+		auto aris_rt_task_create(const RtTaskConfig &config)->Handle*
 		{
 			std::unique_ptr<Handle> handle(new RtTaskHandle);
-			return rt_task_create(&static_cast<RtTaskHandle*>(handle.get())->task, "realtime core", 0, 99, T_FPU | T_JOINABLE) ? nullptr : handle.release();
+			const int mode = T_FPU | T_JOINABLE | (config.cpu_ >= 0 ? T_CPU(config.cpu_) : 0);
+			return rt_task_create(&static_cast<RtTaskHandle*>(handle.get())->task, "realtime core", 0, config.priority_ > 0 ? config.priority_ : 99, mode) ? nullptr : handle.release();
 		}
 		auto aris_rt_task_start(Handle* handle, void(*task_func)(void*), void*param)->int{return rt_task_start(&static_cast<RtTaskHandle*>(handle)->task, task_func, param);}
 		auto aris_rt_task_join(Handle* handle)->int { return rt_task_join(&static_cast<RtTaskHandle*>(handle)->task); }
 		auto aris_rt_task_set_periodic(int nanoseconds)->int { return rt_task_set_periodic(NULL, TM_NOW, nanoseconds); }
 		auto aris_rt_task_wait_period()->int { return rt_task_wait_period(NULL); }
 		auto aris_rt_timer_read()->std::int64_t { return rt_timer_read(); }
+		auto aris_rt_set_time_scale(double scale)->void {}
 #endif
 	}
 }
@@ -1,20 +1,34 @@
 ﻿#ifndef ARIS_CONTROL_RT_TIMER_H
 #define ARIS_CONTROL_RT_TIMER_H
 
+#include <cstdint>
+
 namespace aris
 {
 	namespace control
 	{	
 		struct Handle { virtual ~Handle() = default; };
 
+		// 实时线程的配置，非 Xenomai 下对应 PREEMPT_RT 的 SCHED_FIFO 线程 //
+		struct RtTaskConfig
+		{
+			int priority_{ 0 };  // SCHED_FIFO 优先级，0 表示使用默认调度（Xenomai 下为 99）
+			int cpu_{ -1 };      // 绑定的 cpu，通常与 isolcpus 隔离的 cpu 一致，-1 表示不绑定
+			int spin_ns_{ 0 };   // 提前该时间醒来并自旋到周期时刻，以降低唤醒抖动，0 表示不自旋
+		};
+
 		auto aris_mlockall()->void;
 
-		auto aris_rt_task_create()->Handle*;
+		auto aris_rt_task_create(const RtTaskConfig &config = RtTaskConfig())->Handle*;
+		// 成功返回 0，失败返回 -errno，此时 task_func 不会运行 //
 		auto aris_rt_task_start(Handle* handle, void(*task_func)(void*), void*param)->int;
 		auto aris_rt_task_join(Handle* handle)->int;
 		auto aris_rt_task_set_periodic(int nanoseconds)->int;
 		auto aris_rt_task_wait_period()->int;
 		auto aris_rt_timer_read()->std::int64_t;
+		// 非实时系统下有效：每个周期实际等待 scale 倍的周期时间，1.0 为实时，0.0 为不等待
+		// scale 不为 1.0 时，aris_rt_timer_read 返回按周期累加的仿真时间
+		auto aris_rt_set_time_scale(double scale)->void;
 	}
 }
 
@@ -5,6 +5,12 @@
 #include <sstream>
 #include <iostream>
 #include <functional>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 
 namespace aris
 {
@@ -33,7 +39,6 @@ namespace aris
 
 		struct ParamBase::Imp 
 		{ 
-			bool is_taken_{ false };
 			std::string help_{ "" };
 
 			Imp(const std::string &help = std::string("")):help_(help) {}
@@ -172,153 +177,102 @@ namespace aris
 		UniqueParam& UniqueParam::operator=(const UniqueParam &) = default;
 		UniqueParam& UniqueParam::operator=(UniqueParam &&) = default;
 
-		struct Command::Imp
+		// 编译后的命令语法，参数树按深度优先顺序展开，解析时只查表 //
+		struct CommandGrammar
 		{
-			bool is_taken_;
-			std::string default_value_{ "" };
-			std::string help_{ "" };
-			std::map<std::string, Param*> param_map_;
-			std::map<char, std::string> abbreviation_map_;
-
-			Imp(const std::string &default_param = std::string(""), const std::string &help = std::string("")) :help_(help), default_value_(default_param) {}
-
-			static auto take(Object* param)->void
+			enum Kind { COMMAND, GROUP, UNIQUE, PARAM };
+			struct Node
 			{
-				if (dynamic_cast<Param*>(param))
-				{
-					auto p = dynamic_cast<Param*>(param);
-					if (p->ParamBase::imp_->is_taken_)
-						throw std::runtime_error("parse command error: command \"" + p->command().name() + "\"'s param \"" + p->name() + "\" has been set more than once");
-					p->ParamBase::imp_->is_taken_ = true;
-					take(&param->father());
-				}
-				else if (dynamic_cast<GroupParam*>(param))
-				{
-					auto p = dynamic_cast<GroupParam*>(param);
-					if (!p->ParamBase::imp_->is_taken_)
-					{
-						p->ParamBase::imp_->is_taken_ = true;
-						take(&param->father());
-					}
-				}
-				else if (dynamic_cast<UniqueParam*>(param))
-				{
-					auto p = dynamic_cast<UniqueParam*>(param);
-					if (p->ParamBase::imp_->is_taken_)
-						throw std::runtime_error("parse command error: command \"" + p->command().name() + "\"'s UNIQUE param \"" + p->name() + "\" has been set more than once");
-					p->ParamBase::imp_->is_taken_ = true;
-					take(&param->father());
-				}
-				else if (dynamic_cast<Command*>(param))
-				{
-					auto p = dynamic_cast<Command*>(param);
-					if (p->imp_->is_taken_)
-						throw std::runtime_error("invalid param: some params of command \"" + p->name() + "\" has been set more than once");
-					p->imp_->is_taken_ = true;
-				}
-				else
-				{
-					throw std::runtime_error("wrong type when cmd parse in take");
-				}
-			}
-			static auto reset(Object* param)->void
+				const Object *obj;
+				std::string name;
+				Kind kind;
+				int father, first_child, next_sibling;
+				char abbreviation;
+			};
+
+			auto compileNode(const Object &obj, int father)->int
 			{
-				if (dynamic_cast<Param*>(param)) 
-				{
-					dynamic_cast<Param*>(param)->ParamBase::imp_->is_taken_ = false;
-				}
-				else if (dynamic_cast<GroupParam*>(param))
-				{
-					dynamic_cast<GroupParam*>(param)->ParamBase::imp_->is_taken_ = false;
-					for (auto &child : *dynamic_cast<GroupParam*>(param))reset(&child);
-				}
-				else if (dynamic_cast<UniqueParam*>(param))
-				{
-					dynamic_cast<UniqueParam*>(param)->ParamBase::imp_->is_taken_ = false;
-					for (auto &child : *dynamic_cast<UniqueParam*>(param))reset(&child);
-				}
-				else if (dynamic_cast<Command*>(param))
+				Kind kind;
+				if (dynamic_cast<const Param*>(&obj)) kind = PARAM;
+				else if (dynamic_cast<const GroupParam*>(&obj)) kind = GROUP;
+				else if (dynamic_cast<const UniqueParam*>(&obj)) kind = UNIQUE;
+				else if (dynamic_cast<const Command*>(&obj)) kind = COMMAND;
+				else throw std::runtime_error("wrong type when cmd parse in compile");
+
+				int idx = static_cast<int>(nodes_.size());
+				nodes_.push_back(Node{ &obj, obj.name(), kind, father, -1, -1, kind == PARAM ? static_cast<const Param&>(obj).abbreviation() : char(0) });
+
+				if (kind == UNIQUE)
 				{
-					dynamic_cast<Command*>(param)->imp_->is_taken_ = false;
-					for (auto &child : *dynamic_cast<Command*>(param))reset(&child);
+					auto &unique = static_cast<const UniqueParam&>(obj);
+					if ((unique.defaultParam() != "") && (unique.findByName(unique.defaultParam()) == unique.end()))
+						throw std::runtime_error("Unique param \"" + unique.name() + "\" has invalid default param name");
 				}
-				else
+
+				int prev = -1;
+				for (auto &child : obj.children())
 				{
-					throw std::runtime_error("wrong type when cmd parse in reset");
+					auto child_idx = compileNode(child, idx);
+					(prev < 0 ? nodes_[idx].first_child : nodes_[prev].next_sibling) = child_idx;
+					prev = child_idx;
 				}
+				return idx;
 			}
-			static auto addDefaultParam(Object* param, std::map<std::string, std::string> &param_map_out)->void
+			auto compile(const Command &cmd)->void
 			{
-				if (dynamic_cast<Param*>(param))
-				{
-					auto p = dynamic_cast<Param*>(param);
-					if (!p->ParamBase::imp_->is_taken_)param_map_out.insert(std::make_pair(p->name(), p->imp_->default_value_));
-				}
-				else if (dynamic_cast<GroupParam*>(param))
-				{
-					auto p = dynamic_cast<GroupParam*>(param);
-					for (auto &child : *p) { addDefaultParam(&child, param_map_out); }
-				}
-				else if (dynamic_cast<UniqueParam*>(param))
-				{
-					auto p = dynamic_cast<UniqueParam*>(param);
-
-					if (p->size() == 0)return;
+				nodes_.clear();
+				params_.clear();
+				abbreviations_.fill(-1);
 
-					auto default_param_iter = std::find_if(p->begin(), p->end(), [](ParamBase &param)->bool { return param.imp_->is_taken_; });
-					auto default_param_ptr = p->imp_->default_value_ == "" ? nullptr : &*p->findByName(p->imp_->default_value_);
-					auto default_param = default_param_iter == p->end() ? default_param_ptr : &*default_param_iter;
-					default_param = p->size() == 1 ? &p->front() : default_param;
+				compileNode(cmd, -1);
 
-					if (!default_param)throw std::runtime_error("failed to find default param in command \"" + p->command().name() + "\" param \"" + p->name() + "\"");
-
-					addDefaultParam(default_param, param_map_out);
-				}
-				else if (dynamic_cast<Command*>(param))
+				for (int i = 0; i < static_cast<int>(nodes_.size()); ++i)
 				{
-					auto p = dynamic_cast<Command*>(param);
-					if (p->size() == 0)return;
+					auto &node = nodes_[i];
+					if (node.kind != PARAM) continue;
 
-					auto default_param_iter = std::find_if(p->begin(), p->end(), [](ParamBase &param)->bool { return param.imp_->is_taken_; });
-					auto default_param_ptr = p->imp_->default_value_ == "" ? nullptr : &*p->findByName(p->imp_->default_value_);
-					auto default_param = default_param_iter == p->end() ? default_param_ptr : &*default_param_iter;
-					default_param = p->size() == 1 ? &p->front() : default_param;
+					if (findParam(node.name.data(), node.name.size()) >= 0)
+						throw std::runtime_error("failed to add param \"" + node.name + "\" to cmd \"" + cmd.name() + "\", because this param already exists");
+					if (node.abbreviation != 0 && abbreviations_[static_cast<unsigned char>(node.abbreviation)] >= 0)
+						throw std::runtime_error("failed to add param \"" + node.name + "\" to cmd \"" + cmd.name() + "\", because its abbreviation already exists");
 
-					if (!default_param)throw std::runtime_error("failed to find default param in command \"" + p->name() + "\"");
-
-					addDefaultParam(default_param, param_map_out);
-				}
-				else
-				{
-					throw std::runtime_error("wrong type when cmd parse in addDefaultParam");
+					params_.insert(std::lower_bound(params_.begin(), params_.end(), node.name, [this](int a, const std::string &b) { return nodes_[a].name < b; }), i);
+					if (node.abbreviation != 0) abbreviations_[static_cast<unsigned char>(node.abbreviation)] = i;
 				}
 			}
-			static auto add_param_map_and_check_default(Command *cmd, ParamBase &param)->void
+			// 检查参数树是否在编译之后改变过，不分配内存 //
+			auto matchNode(const Object &obj, int idx)const->bool
 			{
-				if (dynamic_cast<Param*>(&param))
-				{
-					if (cmd->imp_->param_map_.find(param.name()) != cmd->imp_->param_map_.end())
-						throw std::runtime_error("failed to add param \"" + param.name() + "\" to cmd \"" + cmd->name() + "\", because this param already exists");
-					if (cmd->imp_->abbreviation_map_.find(dynamic_cast<Param&>(param).abbreviation()) != cmd->imp_->abbreviation_map_.end() && dynamic_cast<Param&>(param).abbreviation() != 0)
-						throw std::runtime_error("failed to add param \"" + param.name() + "\" to cmd \"" + cmd->name() + "\", because its abbreviation already exists");
+				auto &node = nodes_[idx];
+				if (node.obj != &obj || node.name != obj.name()) return false;
+				if (node.kind == PARAM && node.abbreviation != static_cast<const Param&>(obj).abbreviation()) return false;
 
-					cmd->imp_->param_map_.insert(std::make_pair(param.name(), dynamic_cast<Param*>(&param)));
-					cmd->imp_->abbreviation_map_.insert(std::make_pair(dynamic_cast<Param&>(param).abbreviation(), param.name()));
-				}
-				else if (dynamic_cast<UniqueParam*>(&param))
-				{
-					auto unique = dynamic_cast<UniqueParam*>(&param);
-					if ((unique->imp_->default_value_ != "") && (unique->findByName(unique->imp_->default_value_) == unique->end()))
-					{
-						throw std::runtime_error("Unique param \"" + unique->name() + "\" has invalid default param name");
-					}
-					for (auto &sub_param : param) add_param_map_and_check_default(cmd, sub_param);
-				}
-				else if (dynamic_cast<GroupParam*>(&param))
+				int child_idx = node.first_child;
+				for (auto &child : obj.children())
 				{
-					for (auto &sub_param : param) add_param_map_and_check_default(cmd, sub_param);
+					if (child_idx < 0 || !matchNode(child, child_idx)) return false;
+					child_idx = nodes_[child_idx].next_sibling;
 				}
+				return child_idx < 0;
+			}
+			auto match(const Command &cmd)const->bool { return !nodes_.empty() && matchNode(cmd, 0); }
+			auto findParam(const char *name, std::size_t size)const->int
+			{
+				auto found = std::lower_bound(params_.begin(), params_.end(), 0, [&](int a, int) { return nodes_[a].name.compare(0, std::string::npos, name, size) < 0; });
+				return found != params_.end() && nodes_[*found].name.compare(0, std::string::npos, name, size) == 0 ? *found : -1;
 			}
+
+			std::vector<Node> nodes_;
+			std::vector<int> params_; // Param节点，按名字排序
+			std::array<int, 256> abbreviations_;
+		};
+		struct Command::Imp
+		{
+			std::string default_value_{ "" };
+			std::string help_{ "" };
+			CommandGrammar grammar_;
+
+			Imp(const std::string &default_param = std::string(""), const std::string &help = std::string("")) :help_(help), default_value_(default_param) {}
 		};
 		auto Command::saveXml(aris::core::XmlElement &xml_ele) const->void
 		{
@@ -358,92 +312,275 @@ namespace aris
 		Command& Command::operator=(const Command &) = default;
 		Command& Command::operator=(Command &&) = default;
 
-		struct CommandParser::Imp { ObjectPool<Command>* command_pool_; };
+		struct ParamView::Imp
+		{
+			const Command *command_{ nullptr };
+			std::string input_;
+			std::vector<char> taken_;
+			std::vector<const char *> values_; // 按语法节点
+			std::vector<int> params_;          // 出现的Param节点，按出现顺序
+
+			// 拷贝时把指向输入副本的参数值移到新的副本上 //
+			auto assign(const Imp &other)->void
+			{
+				command_ = other.command_;
+				input_ = other.input_;
+				taken_ = other.taken_;
+				params_ = other.params_;
+				values_.resize(other.values_.size());
+				for (std::size_t i = 0; i < values_.size(); ++i)
+				{
+					auto v = other.values_[i];
+					bool in_input = v && !other.input_.empty() && v >= other.input_.data() && v <= other.input_.data() + other.input_.size();
+					values_[i] = in_input ? input_.data() + (v - other.input_.data()) : v;
+				}
+			}
+			Imp() = default;
+			Imp(const Imp &other) { assign(other); }
+			auto operator=(const Imp &other)->Imp& { if (this != &other) assign(other); return *this; }
+
+			auto grammar()const->const CommandGrammar & 
+			{
+				if (!command_)throw std::runtime_error("failed in ParamView : no command has been parsed");
+				return command_->imp_->grammar_;
+			}
+			auto take(int idx)->void
+			{
+				auto &g = command_->imp_->grammar_;
+				for (; idx >= 0; idx = g.nodes_[idx].father)
+				{
+					auto &node = g.nodes_[idx];
+					switch (node.kind)
+					{
+					case CommandGrammar::PARAM:
+						if (taken_[idx])throw std::runtime_error("parse command error: command \"" + command_->name() + "\"'s param \"" + node.name + "\" has been set more than once");
+						break;
+					case CommandGrammar::GROUP:
+						if (taken_[idx]) return;
+						break;
+					case CommandGrammar::UNIQUE:
+						if (taken_[idx])throw std::runtime_error("parse command error: command \"" + command_->name() + "\"'s UNIQUE param \"" + node.name + "\" has been set more than once");
+						break;
+					case CommandGrammar::COMMAND:
+						if (taken_[idx])throw std::runtime_error("invalid param: some params of command \"" + node.name + "\" has been set more than once");
+						break;
+					}
+					taken_[idx] = 1;
+				}
+			}
+			auto set(int idx, const char *value)->void
+			{
+				if (!values_[idx]) { values_[idx] = value; params_.push_back(idx); }
+			}
+			auto addDefault(int idx)->void
+			{
+				auto &g = command_->imp_->grammar_;
+				auto &node = g.nodes_[idx];
+
+				switch (node.kind)
+				{
+				case CommandGrammar::PARAM:
+					if (!taken_[idx]) set(idx, static_cast<const Param*>(node.obj)->defaultParam().c_str());
+					break;
+				case CommandGrammar::GROUP:
+					for (int c = node.first_child; c >= 0; c = g.nodes_[c].next_sibling) addDefault(c);
+					break;
+				case CommandGrammar::UNIQUE:
+				case CommandGrammar::COMMAND:
+				{
+					if (node.first_child < 0) return;
+
+					// 优先选择已出现的子参数，其次为默认参数，只有一个子参数时直接选择它 //
+					auto &default_name = node.kind == CommandGrammar::UNIQUE ? static_cast<const UniqueParam*>(node.obj)->defaultParam() : static_cast<const Command*>(node.obj)->defaultParam();
+					int taken_child{ -1 }, default_child{ -1 }, child_num{ 0 };
+					for (int c = node.first_child; c >= 0; c = g.nodes_[c].next_sibling, ++child_num)
+					{
+						if (taken_child < 0 && taken_[c]) taken_child = c;
+						if (default_child < 0 && !default_name.empty() && g.nodes_[c].name == default_name) default_child = c;
+					}
+					auto chosen = child_num == 1 ? node.first_child : taken_child >= 0 ? taken_child : default_child;
+
+					if (chosen < 0)
+					{
+						if (node.kind == CommandGrammar::UNIQUE)
+							throw std::runtime_error("failed to find default param in command \"" + command_->name() + "\" param \"" + node.name + "\"");
+						else
+							throw std::runtime_error("failed to find default param in command \"" + node.name + "\"");
+					}
+
+					addDefault(chosen);
+					break;
+				}
+				}
+			}
+		};
+		auto ParamView::command()const->const Command & 
+		{
+			if (!imp_->command_)throw std::runtime_error("failed in ParamView : no command has been parsed");
+			return *imp_->command_;
+		}
+		auto ParamView::cmd()const->const std::string & { return command().name(); }
+		auto ParamView::size()const->std::size_t { return imp_->params_.size(); }
+		auto ParamView::name(std::size_t i)const->const std::string & { return imp_->grammar().nodes_[imp_->params_.at(i)].name; }
+		auto ParamView::value(std::size_t i)const->const char * { return imp_->values_[imp_->params_.at(i)]; }
+		auto ParamView::value(const std::string &param_name)const->const char *
+		{
+			auto idx = imp_->grammar().findParam(param_name.data(), param_name.size());
+			return idx < 0 ? nullptr : imp_->values_[idx];
+		}
+		auto ParamView::toDouble(const std::string &param_name)const->double
+		{
+			auto str = value(param_name);
+			if (!str)throw std::runtime_error("failed in ParamView::toDouble : param \"" + param_name + "\" is not set");
+			
+			char *end;
+			auto ret = std::strtod(str, &end);
+			if (end == str || *end != '\0')throw std::runtime_error("failed in ParamView::toDouble : param \"" + param_name + "\" is not a number \"" + str + "\"");
+			return ret;
+		}
+		auto ParamView::toInt64(const std::string &param_name)const->std::int64_t
+		{
+			auto str = value(param_name);
+			if (!str)throw std::runtime_error("failed in ParamView::toInt64 : param \"" + param_name + "\" is not set");
+
+			char *end;
+			auto ret = std::strtoll(str, &end, 10);
+			if (end == str || *end != '\0')throw std::runtime_error("failed in ParamView::toInt64 : param \"" + param_name + "\" is not an integer \"" + str + "\"");
+			return ret;
+		}
+		auto ParamView::toUint64(const std::string &param_name)const->std::uint64_t
+		{
+			auto str = value(param_name);
+			if (!str)throw std::runtime_error("failed in ParamView::toUint64 : param \"" + param_name + "\" is not set");
+
+			char *end;
+			auto ret = std::strtoull(str, &end, 10);
+			if (end == str || *end != '\0' || *str == '-')throw std::runtime_error("failed in ParamView::toUint64 : param \"" + param_name + "\" is not an unsigned integer \"" + str + "\"");
+			return ret;
+		}
+		auto ParamView::toMap()const->std::map<std::string, std::string>
+		{
+			std::map<std::string, std::string> ret;
+			for (std::size_t i = 0; i < size(); ++i) ret.insert(std::make_pair(name(i), std::string(value(i))));
+			return ret;
+		}
+		ParamView::~ParamView() = default;
+		ParamView::ParamView() = default;
+		ParamView::ParamView(const ParamView &other) = default;
+		ParamView::ParamView(ParamView &&other) = default;
+		ParamView& ParamView::operator=(const ParamView &other) = default;
+		ParamView& ParamView::operator=(ParamView &&other) = default;
+
+		struct CommandParser::Imp 
+		{ 
+			ObjectPool<Command>* command_pool_; 
+			std::vector<std::size_t> command_index_; // 按名字排序的命令序号
+			ParamView param_view_;
+
+			auto findCommand(const char *name)->Command *
+			{
+				auto found = std::lower_bound(command_index_.begin(), command_index_.end(), 0, [&](std::size_t a, int) { return a < command_pool_->size() && command_pool_->at(a).name().compare(name) < 0; });
+				return found != command_index_.end() && *found < command_pool_->size() && command_pool_->at(*found).name() == name ? &command_pool_->at(*found) : nullptr;
+			}
+			auto sortCommands()->void
+			{
+				command_index_.resize(command_pool_->size());
+				for (std::size_t i = 0; i < command_index_.size(); ++i)command_index_[i] = i;
+				std::stable_sort(command_index_.begin(), command_index_.end(), [this](std::size_t a, std::size_t b) { return command_pool_->at(a).name() < command_pool_->at(b).name(); });
+			}
+		};
 		auto CommandParser::loadXml(const aris::core::XmlElement &xml_ele)->void
 		{
 			Object::loadXml(xml_ele);
 			imp_->command_pool_ = findOrInsert<aris::core::ObjectPool<Command>>("command_pool");
+			imp_->command_index_.clear();
 		}
-		auto CommandParser::parse(const std::string &command_string, std::string &cmd_out, std::map<std::string, std::string> &param_out)->void
+		auto CommandParser::parse(const std::string &command_string, ParamView &param_out)->void
 		{
+			auto &v = *param_out.imp_;
+			v.command_ = nullptr;
+
 			try
 			{
-				std::string cmd;
-				std::map<std::string, std::string> param_map;
-				std::stringstream input_stream{ command_string };
-				std::string word;
-
-				if (!(input_stream >> cmd))throw std::runtime_error("invalid command string: please at least contain a word");
-
-				auto command = imp_->command_pool_->findByName(cmd);
-				if (command == imp_->command_pool_->end()) throw std::runtime_error("invalid command name: server does not have this command \"" + cmd + "\"");
+				// 在副本中原地分词，每个词以'\0'结尾，参数值直接指向副本 //
+				v.input_.assign(command_string);
+				char *p = &v.input_[0], *end = p + v.input_.size();
+				auto next_word = [&p, end](char *&word)->bool
+				{
+					while (p < end && std::isspace(static_cast<unsigned char>(*p)))++p;
+					if (p == end) return false;
+					word = p;
+					while (p < end && !std::isspace(static_cast<unsigned char>(*p)))++p;
+					if (p < end) *p++ = '\0';
+					return true;
+				};
+
+				char *word;
+				if (!next_word(word))throw std::runtime_error("invalid command string: please at least contain a word");
+
+				// 命令查找表只在查找失败时重建 //
+				auto command = imp_->findCommand(word);
+				if (!command) { imp_->sortCommands(); command = imp_->findCommand(word); }
+				if (!command) throw std::runtime_error("invalid command name: server does not have this command \"" + std::string(word) + "\"");
 				
-				// make map and abbrev map //
-				command->imp_->param_map_.clear();
-				command->imp_->abbreviation_map_.clear();
-				for (auto &param : *command) Command::Imp::add_param_map_and_check_default(&*command, param);
+				auto &g = command->imp_->grammar_;
+				if (!g.match(*command)) g.compile(*command);
 
-				Command::Imp::reset(&*command);
-				while (input_stream >> word)
+				v.command_ = command;
+				v.taken_.assign(g.nodes_.size(), 0);
+				v.values_.assign(g.nodes_.size(), nullptr);
+				v.params_.clear();
+
+				auto take_abbreviation = [&](char abbrev, const char *value)
 				{
-					std::string param_name_origin = word.substr(0, word.find_first_of('='));
+					auto idx = g.abbreviations_[static_cast<unsigned char>(abbrev)];
+					if (idx < 0) throw std::runtime_error(std::string("invalid param: param \"") + abbrev + "\" is not a abbreviation of any valid param");
+					v.set(idx, value ? value : static_cast<const Param*>(g.nodes_[idx].obj)->defaultParam().c_str());
+					v.take(idx);
+				};
 
-					if (param_name_origin == "")throw std::runtime_error("invalid param: param should not start with '='");
-					else if (param_name_origin == "-")throw std::runtime_error("invalid param: symbol \"-\" must be followed by an abbreviation of param");
-					else if (param_name_origin == "--")throw std::runtime_error("invalid param: symbol \"--\" must be followed by a full name of param");
-					else if (param_name_origin.size() > 2 && param_name_origin.data()[0] == '-' && param_name_origin.data()[1] != '-')throw std::runtime_error("invalid param: param start with single '-' must be an abbreviation");
-					else if (param_name_origin.size() == 2 && param_name_origin.data()[0] == '-' && param_name_origin.data()[1] != '-')
+				while (next_word(word))
+				{
+					auto eq = std::strchr(word, '=');
+					auto value = eq ? eq + 1 : nullptr;
+					std::size_t name_size = eq ? eq - word : std::strlen(word);
+
+					if (name_size == 0)throw std::runtime_error("invalid param: param should not start with '='");
+					else if (name_size == 1 && word[0] == '-')throw std::runtime_error("invalid param: symbol \"-\" must be followed by an abbreviation of param");
+					else if (name_size == 2 && word[0] == '-' && word[1] == '-')throw std::runtime_error("invalid param: symbol \"--\" must be followed by a full name of param");
+					else if (name_size > 2 && word[0] == '-' && word[1] != '-')throw std::runtime_error("invalid param: param start with single '-' must be an abbreviation");
+					else if (name_size == 2 && word[0] == '-' && word[1] != '-')
 					{
-						char abbrev = param_name_origin.data()[1];
-
-						if (command->imp_->abbreviation_map_.find(abbrev) == command->imp_->abbreviation_map_.end())
-							throw std::runtime_error(std::string("invalid param: param \"") + abbrev + "\" is not a abbreviation of any valid param");
-
-						auto param = command->imp_->param_map_.at(command->imp_->abbreviation_map_.at(abbrev));
-						auto param_name = command->imp_->abbreviation_map_.at(abbrev);
-						auto param_value = word.find('=') == std::string::npos ? param->defaultParam() : word.substr(word.find('=') + 1, std::string::npos);
-
-						param_map.insert(make_pair(param_name, param_value));
-						Command::Imp::take(param);
+						take_abbreviation(word[1], value);
 					}
-					else if (param_name_origin.data()[0] == '-' && param_name_origin.data()[1] == '-')
+					else if (word[0] == '-' && word[1] == '-')
 					{
-						auto param_name = word.substr(2, word.find('=') - 2);
-
-						if (command->imp_->param_map_.find(param_name) == command->imp_->param_map_.end())
-							throw std::runtime_error(std::string("invalid param: param \"") + param_name + "\" is not a valid param");
-
-						auto param = command->imp_->param_map_.at(param_name);
-						auto param_value = word.find('=') == std::string::npos ? param->defaultParam() : word.substr(word.find('=') + 1, std::string::npos);
-
-						param_map.insert(make_pair(param_name, param_value));
-						Command::Imp::take(param);
+						auto idx = g.findParam(word + 2, name_size - 2);
+						if (idx < 0) throw std::runtime_error(std::string("invalid param: param \"") + std::string(word + 2, name_size - 2) + "\" is not a valid param");
+						v.set(idx, value ? value : static_cast<const Param*>(g.nodes_[idx].obj)->defaultParam().c_str());
+						v.take(idx);
 					}
 					else
 					{
-						for (auto abbrev : param_name_origin)
-						{
-							if (command->imp_->abbreviation_map_.find(abbrev) == command->imp_->abbreviation_map_.end())
-								throw std::runtime_error(std::string("invalid param: param \"") + abbrev + "\" is not a abbreviation of any valid param");
-							
-							auto param = command->imp_->param_map_.at(command->imp_->abbreviation_map_.at(abbrev));
-							auto param_name = command->imp_->abbreviation_map_.at(abbrev);
-							auto param_value = param->defaultParam();
-							param_map.insert(make_pair(param_name, param_value));
-							Command::Imp::take(param);
-						}
+						for (std::size_t i = 0; i < name_size; ++i) take_abbreviation(word[i], nullptr);
 					}
 				}
-				Command::Imp::addDefaultParam(&*command, param_map);
-
-				cmd_out = cmd;
-				param_out = param_map;
+				v.addDefault(0);
 			}
 			catch (std::exception &e)
 			{
+				v.command_ = nullptr;
 				throw std::runtime_error(e.what() + std::string(", when parsing command string \"" + command_string +"\""));
 			}
 		}
+		auto CommandParser::parse(const std::string &command_string, std::string &cmd_out, std::map<std::string, std::string> &param_out)->void
+		{
+			parse(command_string, imp_->param_view_);
+
+			cmd_out = imp_->param_view_.cmd();
+			param_out.clear();
+			for (std::size_t i = 0; i < imp_->param_view_.size(); ++i) param_out.insert(std::make_pair(imp_->param_view_.name(i), std::string(imp_->param_view_.value(i))));
+		}
         auto CommandParser::commandPool()->ObjectPool<Command> & { return *imp_->command_pool_; }
         auto CommandParser::commandPool()const->const ObjectPool<Command> &{ return *imp_->command_pool_; }
 		auto CommandParser::help()const->std::string
@@ -2,6 +2,7 @@
 #define ARIS_CORE_COMMAND_H_
 
 #include <map>
+#include <cstdint>
 
 #include <aris_core_object.h>
 
@@ -229,14 +230,53 @@ namespace aris
 			ImpPtr<Imp> imp_;
 
 			friend class CommandParser;
+			friend class ParamView;
 			friend class ParamBase;
 		};
+		/// \class aris::core::ParamView
+		///  命令解析的结果，可以重复使用，缓冲区足够大之后再次解析不再分配内存
+		///
+		/// 参数值指向ParamView内部的命令字符串副本或Param的默认值，在下一次解析之前有效
+		///
+		class ParamView
+		{
+		public:
+			auto command()const->const Command &;
+			auto cmd()const->const std::string &;
+			auto size()const->std::size_t;
+			auto name(std::size_t i)const->const std::string &;
+			auto value(std::size_t i)const->const char *;
+			auto has(const std::string &param_name)const->bool { return value(param_name) != nullptr; }
+			/// 参数未出现时返回nullptr
+			///
+			auto value(const std::string &param_name)const->const char *;
+			auto toDouble(const std::string &param_name)const->double;
+			auto toInt64(const std::string &param_name)const->std::int64_t;
+			auto toUint64(const std::string &param_name)const->std::uint64_t;
+			auto toMap()const->std::map<std::string, std::string>;
+
+			virtual ~ParamView();
+			ParamView();
+			ParamView(const ParamView &);
+			ParamView(ParamView &&);
+			ParamView& operator=(const ParamView &);
+			ParamView& operator=(ParamView &&);
+
+		private:
+			struct Imp;
+			ImpPtr<Imp> imp_;
+
+			friend class CommandParser;
+		};
 		class CommandParser:public Object
 		{
 		public:
 			static auto Type()->const std::string &{ static const std::string type("CommandParser"); return std::ref(type); }
 			auto virtual type() const->const std::string& override{ return Type(); }
 			auto virtual loadXml(const aris::core::XmlElement &xml_ele)->void override;
+			/// 命令的语法在第一次解析时编译成查找表，参数树改变后自动重新编译
+			///
+			auto parse(const std::string &command_string, ParamView &param_out)->void;
 			auto parse(const std::string &command_string, std::string &cmd_out, std::map<std::string, std::string> &param_map_out)->void;
             auto help()const->std::string;
             auto commandPool()->ObjectPool<Command> &;
@@ -4,7 +4,9 @@
 #include <stdexcept>
 #include <cstring>
 #include <algorithm>
-#include <regex>
+#include <cctype>
+#include <cstdlib>
+#include <cstdio>
 
 #include "aris_core_expression_calculator.h"
 
@@ -155,13 +157,21 @@ namespace aris
 		{
 			std::stringstream stream;
 
-			stream.precision(15);
+			// 优先使用15位有效数字，无法精确还原时使用17位（max_digits10），保证再次解析得到相同的值 //
+			auto write = [&stream](double value)
+			{
+				char buf[32];
+				std::snprintf(buf, sizeof(buf), "%.15g", value);
+				if (std::strtod(buf, nullptr) != value) std::snprintf(buf, sizeof(buf), "%.17g", value);
+				stream << buf;
+			};
+
 			stream << "{";
 			for (Size i = 0; i < m(); ++i)
 			{
 				for (Size j = 0; j < n(); ++j)
 				{
-					stream << this->operator()(i, j);
+					write(this->operator()(i, j));
 					if (j<n() - 1)stream << " , ";
 				}
 				if (i<m() - 1)
@@ -642,26 +652,486 @@ namespace aris
 			return ret;
 		}
 
+		// 解析由Matrix::toString()生成的纯数字矩阵，例如 "{1 , 2 ;\n 3 , 4}"，不是纯数字时返回false //
+		auto parseLiteralMatrix(const std::string &str, Matrix &mat)->bool
+		{
+			auto p = str.c_str();
+			auto skip_space = [&p]() { while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')++p; };
+			// 只接受十进制字面量 [+-]digits[.digits][(e|E)[+-]digits]，十六进制、inf、nan 等交给完整的求值 //
+			auto scan_decimal = [](const char *c)->const char*
+			{
+				auto digits = [](const char *&q) { auto b = q; while (std::isdigit(static_cast<unsigned char>(*q)))++q; return q != b; };
+				if (*c == '+' || *c == '-')++c;
+				bool has_digit = digits(c);
+				if (*c == '.') { ++c; has_digit = digits(c) || has_digit; }
+				if (!has_digit) return nullptr;
+				if (*c == 'e' || *c == 'E')
+				{
+					++c;
+					if (*c == '+' || *c == '-')++c;
+					if (!digits(c)) return nullptr;
+				}
+				return c;
+			};
+
+			std::vector<double> data;
+			Size m{ 1 }, n{ 0 }, col{ 0 };
+
+			skip_space();
+			const bool brace = *p == '{';
+			if (brace) { ++p; skip_space(); }
+			if (brace && *p == '}') { mat = Matrix(); ++p; skip_space(); return *p == '\0'; }
+
+			for (;;)
+			{
+				auto scan_end = scan_decimal(p);
+				if (!scan_end) return false;
+				char *end;
+				data.push_back(std::strtod(p, &end));
+				if (end != scan_end) return false;
+				p = end;
+				++col;
+				skip_space();
+
+				if (brace && *p == ',') { ++p; skip_space(); }
+				else if (brace && *p == ';')
+				{
+					if (n != 0 && col != n) return false;
+					n = col;
+					col = 0;
+					++m;
+					++p;
+					skip_space();
+				}
+				else break;
+			}
+			if (n != 0 && col != n) return false;
+			n = col;
+
+			if (brace)
+			{
+				if (*p != '}') return false;
+				++p;
+				skip_space();
+			}
+			if (*p != '\0') return false;
+
+			mat = Matrix(m, n, data.data());
+			return true;
+		}
 		auto Calculator::calculateExpression(const std::string &expression) const->Matrix
 		{
+			// 快照和saveXml生成的属性均为纯数字，直接解析，跳过词法分析和求值 //
+			Matrix literal;
+			if (parseLiteralMatrix(expression, literal)) return literal;
+
+			std::lock_guard<std::mutex> lck(cache_.mu_);
+			auto found = cache_.map_.find(expression);
+			if (found == cache_.map_.end())
+			{
+				auto exp = compile(expression);
+				if (cache_.map_.size() >= ExpressionCache::MAX_SIZE) cache_.map_.clear();
+				found = cache_.map_.insert(std::make_pair(expression, std::move(exp))).first;
+			}
+			return found->second.evaluate();
+		}
+		auto Calculator::compile(const std::string &expression) const->Expression
+		{
+			Expression exp;
+			exp.calculator_ = this;
+			exp.version_ = cache_.version_;
+
 			auto tokens = Expression2Tokens(expression);
-			return CaculateTokens(tokens.begin(), tokens.end());
+			CompileTokens(tokens.begin(), tokens.end(), exp);
+
+			return exp;
 		}
-		auto Calculator::evaluateExpression(const std::string &expression)const->std::string
+		Size Calculator::CompileTokens(TokenVec::iterator beginToken, TokenVec::iterator endToken, Expression &exp) const
+		{
+			using Instruction = Expression::Instruction;
+
+			if (beginToken >= endToken)
+			{
+				throw std::runtime_error("invalid expression");
+			}
+
+			// 内置运算符直接翻译成指令，求值时不经过std::function //
+			auto unary_code = [this](const Operator *opr) 
+			{
+				return opr == &operator_map_.at("+") ? Instruction::PLUS : opr == &operator_map_.at("-") ? Instruction::NEGATE : Instruction::UNARY_LEFT;
+			};
+			auto binary_code = [this](const Operator *opr)
+			{
+				return opr == &operator_map_.at("+") ? Instruction::ADD : opr == &operator_map_.at("-") ? Instruction::MINUS
+					: opr == &operator_map_.at("*") ? Instruction::MULTIPLY : opr == &operator_map_.at("/") ? Instruction::DIVIDE : Instruction::BINARY;
+			};
+
+			auto i = beginToken;
+
+			Size value{ 0 };
+
+			bool isBegin = true;
+
+			while (i < endToken)
+			{
+				// 与CaculateTokens的解析过程一一对应，只是生成指令而不求值 //
+				if (isBegin)
+				{
+					isBegin = false;
+					switch (i->type)
+					{
+					case Token::PARENTHESIS_L:
+					{
+						auto beginPar = i + 1;
+						auto endPar = FindNextOutsideToken(i + 1, endToken, Token::PARENTHESIS_R);
+						i = endPar + 1;
+						value = CompileTokens(beginPar, endPar, exp);
+						break;
+					}
+					case Token::BRACE_L:
+					{
+						auto beginBce = i + 1;
+						auto endBce = FindNextOutsideToken(i + 1, endToken, Token::BRACE_R);
+						i = endBce + 1;
+
+						auto rows = CompileMatrices(beginBce, endBce, exp);
+						Instruction ins{ Instruction::BRACE, exp.operands_.size(), rows.size(), nullptr, nullptr, nullptr };
+						for (auto &row : rows)
+						{
+							exp.operands_.push_back(row.size());
+							exp.operands_.insert(exp.operands_.end(), row.begin(), row.end());
+						}
+						value = exp.emit(ins);
+						break;
+					}
+					case Token::NUMBER:
+						value = exp.emitConstant(Matrix(i->num));
+						i++;
+						break;
+					case Token::OPERATOR:
+					{
+						auto opr = i;
+						if (!opr->opr->fun_ul) throw std::runtime_error("expression not valid");
+						i = FindNextEqualLessPrecedenceBinaryOpr(opr + 1, endToken, opr->opr->priority_ul);
+						value = exp.emit(Instruction{ unary_code(opr->opr), CompileTokens(opr + 1, i, exp), 0, nullptr, opr->opr, nullptr });
+						break;
+					}
+					case Token::VARIABLE:
+						value = exp.emit(Instruction{ Instruction::VARIABLE, 0, 0, i->var, nullptr, nullptr });
+						i++;
+						break;
+					case Token::Function:
+					{
+						auto beginPar = i + 1;
+						if (i + 1 >= endToken) throw std::runtime_error("invalid expression");
+						if (beginPar->type != Token::PARENTHESIS_L)throw std::runtime_error("function must be followed by \"(\"");
+
+						auto endPar = FindNextOutsideToken(beginPar + 1, endToken, Token::PARENTHESIS_R);
+						auto matrices = CompileMatrices(beginPar + 1, endPar, exp);
+
+						if (matrices.size() != 1)throw std::runtime_error("function \"" + i->word + "\" + do not has invalid param type");
+
+						auto &params = matrices.front();
+						auto f = i->fun->funs.find(params.size());
+						if (f == i->fun->funs.end())throw std::runtime_error("function \"" + i->word + "\" + do not has invalid param num");
+
+						Instruction ins{ Instruction::FUNCTION, exp.operands_.size(), params.size(), nullptr, nullptr, &f->second };
+						exp.operands_.insert(exp.operands_.end(), params.begin(), params.end());
+						value = exp.emit(ins);
+
+						i = endPar + 1;
+						break;
+					}
+					default:
+						throw std::runtime_error("expression not valid");
+					}
+				}
+				else//如果有当前值,但没有操作符
+				{
+					if (i->type == Token::OPERATOR)
+					{
+						if (i->opr->priority_ur)
+						{
+							value = exp.emit(Instruction{ Instruction::UNARY_RIGHT, value, 0, nullptr, i->opr, nullptr });
+							i++;
+						}
+						else if (i->opr->priority_b > 0)
+						{
+							auto e = FindNextEqualLessPrecedenceBinaryOpr(i + 1, endToken, i->opr->priority_b);
+							auto right = CompileTokens(i + 1, e, exp);
+							value = exp.emit(Instruction{ binary_code(i->opr), value, right, nullptr, i->opr, nullptr });
+							i = e;
+						}
+						else
+						{
+							throw std::runtime_error("expression not valid");
+						}
+					}
+					else
+					{
+						throw std::runtime_error("expression not valid: lack operator");
+					}
+				}
+			}
+
+			return value;
+		}
+		auto Calculator::CompileMatrices(TokenVec::iterator beginToken, TokenVec::iterator endToken, Expression &exp)const->std::vector<std::vector<Size> >
 		{
-			auto ret = expression;
+			std::vector<std::vector<Size> > ret;
 
-			for (auto &var : string_map_)
+			auto rowBegin = beginToken;
+			while (rowBegin < endToken)
 			{
-				std::string exp{ "\\$\\{" + var.first + "\\}" };
+				auto rowEnd = FindNextOutsideToken(rowBegin, endToken, Token::SEMICOLON);
+				auto colBegin = rowBegin;
+
+				ret.push_back(std::vector<Size>());
+
+				while (colBegin < rowEnd)
+				{
+					auto colEnd = FindNextOutsideToken(colBegin, rowEnd, Token::COMMA);
+
+					ret.back().push_back(CompileTokens(colBegin, colEnd, exp));
 
-				std::regex var_rex{ exp };
-				ret = std::regex_replace(ret, var_rex, var.second);
+					colBegin = colEnd == endToken ? colEnd : colEnd + 1;
+				}
+
+				rowBegin = rowEnd == endToken ? rowEnd : rowEnd + 1;
 			}
 
+			return ret;
+		}
+		auto Calculator::Expression::emitConstant(Matrix value)->Size
+		{
+			program_.push_back(Instruction{ Instruction::CONSTANT, 0, 0, nullptr, nullptr, nullptr });
+			registers_.push_back(std::move(value));
+			values_.push_back(nullptr);
+			return program_.size() - 1;
+		}
+		auto Calculator::Expression::emit(Instruction ins)->Size
+		{
+			program_.push_back(ins);
+			registers_.push_back(Matrix());
+			values_.push_back(nullptr);
+			auto id = program_.size() - 1;
+
+			// 常量折叠，函数可能有副作用，不折叠 //
+			if (ins.code == Instruction::VARIABLE || ins.code == Instruction::FUNCTION) return id;
+
+			std::vector<Size> args;
+			switch (ins.code)
+			{
+			case Instruction::ADD:
+			case Instruction::MINUS:
+			case Instruction::MULTIPLY:
+			case Instruction::DIVIDE:
+			case Instruction::BINARY:
+				args = { ins.a, ins.b };
+				break;
+			case Instruction::BRACE:
+				for (Size r = 0, pos = ins.a; r < ins.b; ++r, pos += operands_[pos] + 1)
+					args.insert(args.end(), operands_.begin() + pos + 1, operands_.begin() + pos + 1 + operands_[pos]);
+				break;
+			default:
+				args = { ins.a };
+			}
+			for (auto arg : args) if (program_[arg].code != Instruction::CONSTANT) return id;
+
+			// 操作数都是常量时，它们必然是刚刚生成的最后几条指令 //
+			for (auto arg : args) values_[arg] = &registers_[arg];
+			run(id);
+			Matrix result = *values_[id];
+
+			auto first = id - args.size();
+			if (ins.code == Instruction::BRACE) operands_.resize(ins.a);
+			program_.resize(first);
+			registers_.resize(first);
+			values_.resize(first);
+			return emitConstant(std::move(result));
+		}
+		auto Calculator::Expression::run(Size i)->void
+		{
+			auto &ins = program_[i];
+			auto &ret = registers_[i];
+
+			switch (ins.code)
+			{
+			case Instruction::CONSTANT:
+				values_[i] = &ret;
+				return;
+			case Instruction::VARIABLE:
+				values_[i] = ins.var;
+				return;
+			case Instruction::PLUS:
+				values_[i] = values_[ins.a];
+				return;
+			case Instruction::NEGATE:
+			{
+				auto &m1 = *values_[ins.a];
+				ret.resize(m1.m(), m1.n());
+				for (Size r = 0; r < m1.m(); ++r)for (Size c = 0; c < m1.n(); ++c)ret(r, c) = -m1(r, c);
+				break;
+			}
+			case Instruction::ADD:
+			case Instruction::MINUS:
+			case Instruction::MULTIPLY:
+			case Instruction::DIVIDE:
+			{
+				// 与Matrix的运算符结果一致，但直接写入寄存器 //
+				auto &m1 = *values_[ins.a];
+				auto &m2 = *values_[ins.b];
+				auto apply = [&ins](double d1, double d2)->double 
+				{
+					return ins.code == Instruction::ADD ? d1 + d2 : ins.code == Instruction::MINUS ? d1 - d2 : ins.code == Instruction::MULTIPLY ? d1 * d2 : d1 / d2;
+				};
+
+				if (m1.size() == 1)
+				{
+					ret.resize(m2.m(), m2.n());
+					for (Size r = 0; r < m2.m(); ++r)for (Size c = 0; c < m2.n(); ++c)ret(r, c) = apply(m1(0, 0), m2(r, c));
+				}
+				else if (m2.size() == 1)
+				{
+					ret.resize(m1.m(), m1.n());
+					for (Size r = 0; r < m1.m(); ++r)for (Size c = 0; c < m1.n(); ++c)ret(r, c) = apply(m1(r, c), m2(0, 0));
+				}
+				else if (ins.code == Instruction::MULTIPLY)
+				{
+					if (m1.n() != m2.m()) throw std::runtime_error("Can't multiply matrices, the dimensions are not equal");
 
+					ret.resize(m1.m(), m2.n());
+					for (Size r = 0; r < m1.m(); ++r)
+					{
+						for (Size c = 0; c < m2.n(); ++c)
+						{
+							ret(r, c) = 0;
+							for (Size u = 0; u < m1.n(); ++u)ret(r, c) += m1(r, u) * m2(u, c);
+						}
+					}
+				}
+				else if (ins.code == Instruction::DIVIDE)
+				{
+					throw std::runtime_error("Right now, divide operator of matrices is not added");
+				}
+				else if ((m1.m() == m2.m()) && (m1.n() == m2.n()))
+				{
+					ret.resize(m1.m(), m1.n());
+					for (Size r = 0; r < m1.m(); ++r)for (Size c = 0; c < m1.n(); ++c)ret(r, c) = apply(m1(r, c), m2(r, c));
+				}
+				else
+				{
+					throw std::runtime_error(ins.code == Instruction::ADD ? "Can't plus matrices, the dimensions are not equal" : "Can't minus matrices, the dimensions are not equal");
+				}
+				break;
+			}
+			case Instruction::UNARY_LEFT:
+				ret = ins.opr->fun_ul(*values_[ins.a]);
+				break;
+			case Instruction::UNARY_RIGHT:
+				ret = ins.opr->fun_ur(*values_[ins.a]);
+				break;
+			case Instruction::BINARY:
+				ret = ins.opr->fun_b(*values_[ins.a], *values_[ins.b]);
+				break;
+			case Instruction::FUNCTION:
+			{
+				std::vector<Matrix> params;
+				params.reserve(ins.b);
+				for (Size k = 0; k < ins.b; ++k)params.push_back(*values_[operands_[ins.a + k]]);
+				ret = (*ins.fun)(std::move(params));
+				break;
+			}
+			case Instruction::BRACE:
+			{
+				// 与combineMatrices一致：先按行横向拼接，再将各行纵向拼接，空矩阵不参与尺寸计算 //
+				Size m{ 0 }, n{ 0 };
+				for (Size r = 0, pos = ins.a; r < ins.b; ++r, pos += operands_[pos] + 1)
+				{
+					Size row_m{ 0 }, row_n{ 0 };
+					for (Size k = 0; k < operands_[pos]; ++k)
+					{
+						auto &mat = *values_[operands_[pos + 1 + k]];
+						if (mat.size() == 0)continue;
+						if ((row_m != 0) && (row_m != mat.m()))throw std::runtime_error("input do not have valid size");
+						row_m = mat.m();
+						row_n += mat.n();
+					}
+
+					if (row_m * row_n == 0)continue;
+					if ((n != 0) && (n != row_n))throw std::runtime_error("input do not have valid size");
+					m += row_m;
+					n = row_n;
+				}
+
+				ret.resize(m, n);
+				Size begin_row{ 0 };
+				for (Size r = 0, pos = ins.a; r < ins.b; ++r, pos += operands_[pos] + 1)
+				{
+					Size begin_col{ 0 }, row_m{ 0 };
+					for (Size k = 0; k < operands_[pos]; ++k)
+					{
+						auto &mat = *values_[operands_[pos + 1 + k]];
+						for (Size i = 0; i < mat.m(); ++i)for (Size j = 0; j < mat.n(); ++j)ret(begin_row + i, begin_col + j) = mat(i, j);
+						begin_col += mat.n();
+						if (mat.size() != 0)row_m = mat.m();
+					}
+					begin_row += row_m;
+				}
+				break;
+			}
+			}
+
+			values_[i] = &ret;
+		}
+		auto Calculator::Expression::evaluate()->const Matrix&
+		{
+			if (!calculator_ || version_ != calculator_->cache_.version_)
+				throw std::runtime_error("failed in Calculator::Expression::evaluate : expression is empty or out of date, compile it again");
+
+			for (Size i = 0; i < program_.size(); ++i)run(i);
+			return *values_.back();
+		}
+		auto Calculator::evaluateExpression(const std::string &expression)const->std::string
+		{
+			std::string ret(expression);
+			SubstituteStrings(ret);
 			return ret;
 		}
+		void Calculator::SubstituteStrings(std::string &str) const
+		{
+			// 结果与按变量名顺序逐个替换"${name}"相同，包括跨越替换边界形成的引用，例如a为"${"时"${a}b}"得到"${b}"的值： //
+			// 每轮扫描一次当前字符串，找出出现在其中、名字排在上一个被替换变量之后的最小变量名，替换它的全部出现 //
+			// 只有被引用到的变量才需要一轮扫描，不再随变量总数增长 //
+			const std::string *last = nullptr;
+			std::string replaced;
+			for (;;)
+			{
+				auto next = string_map_.end();
+				for (auto begin = str.find("${"); begin != std::string::npos; begin = str.find("${", begin + 2))
+				{
+					auto end = str.find('}', begin + 2);
+					if (end == std::string::npos) break;
+
+					auto found = string_map_.find(str.substr(begin + 2, end - begin - 2));
+					if (found != string_map_.end() && (!last || *last < found->first) && (next == string_map_.end() || found->first < next->first)) next = found;
+				}
+				if (next == string_map_.end()) return;
+
+				// 与regex_replace相同，从左到右替换互不重叠的出现，代入的值在本轮中不再扫描 //
+				const std::string pattern = "${" + next->first + "}";
+				std::string::size_type pos = 0;
+				replaced.clear();
+				for (auto found = str.find(pattern); found != std::string::npos; found = str.find(pattern, pos))
+				{
+					replaced.append(str, pos, found - pos).append(next->second);
+					pos = found + pattern.size();
+				}
+				replaced.append(str, pos, std::string::npos);
+				str.swap(replaced);
+				last = &next->first;
+			}
+		}
 		auto Calculator::addVariable(const std::string &name, const Matrix &value)->void
 		{
 			if (function_map_.find(name) != function_map_.end())
@@ -683,6 +1153,16 @@ namespace aris
 			}
 			string_map_.insert(make_pair(name, value));
 		}
+		auto Calculator::setVariable(const std::string &name, const Matrix &value)->void
+		{
+			auto found = variable_map_.find(name);
+			if (found == variable_map_.end())
+			{
+				throw std::runtime_error("variable \"" + name + "\" does not exist, can't set variable");
+			}
+			// 原地修改，已编译表达式中的变量指针保持有效 //
+			found->second = value;
+		}
 		auto Calculator::addFunction(const std::string &name, std::function<Matrix(std::vector<Matrix>)> f, Size n)->void
 		{
 			if (variable_map_.find(name) != variable_map_.end())
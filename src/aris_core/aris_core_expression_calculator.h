@@ -12,6 +12,9 @@
 #include<initializer_list>
 #include<cmath>
 #include<algorithm>
+#include<mutex>
+#include<unordered_map>
+#include<cstdint>
 
 #include<aris_core_basic_type.h>
 
@@ -177,12 +180,19 @@ namespace aris
 				}, 1);
 			}
 
+			class Expression;
+			/// 计算表达式，编译结果按表达式字符串缓存，相同的表达式只解析一次
+			///
 			auto calculateExpression(const std::string &expression) const->Matrix;
+			/// 编译表达式，得到的Expression可以重复求值，变量的值通过setVariable修改
+			///
+			auto compile(const std::string &expression) const->Expression;
 			auto evaluateExpression(const std::string &expression)const->std::string;
 			auto addVariable(const std::string &name, const Matrix &value)->void;
 			auto addVariable(const std::string &name, const std::string &value)->void;
+			auto setVariable(const std::string &name, const Matrix &value)->void;
 			auto addFunction(const std::string &name, std::function<Matrix(std::vector<Matrix>)> f, Size n)->void;
-			auto clearVariables()->void { variable_map_.clear(); string_map_.clear(); }
+			auto clearVariables()->void { variable_map_.clear(); string_map_.clear(); cache_.clear(); }
 
 		private:
 			class Operator;
@@ -261,11 +271,69 @@ namespace aris
 			TokenVec::iterator FindNextEqualLessPrecedenceBinaryOpr(TokenVec::iterator beginToken, TokenVec::iterator endToken, Size precedence)const;
 			std::vector<std::vector<Matrix> > GetMatrices(TokenVec::iterator beginToken, TokenVec::iterator endToken)const;
 
+			Size CompileTokens(TokenVec::iterator beginToken, TokenVec::iterator endToken, Expression &exp) const;
+			void SubstituteStrings(std::string &str) const;
+			std::vector<std::vector<Size> > CompileMatrices(TokenVec::iterator beginToken, TokenVec::iterator endToken, Expression &exp)const;
+
+		public:
+			/// 编译后的表达式：常量已折叠，变量、运算符和函数已解析为指针，按指令顺序求值
+			/// 内置四则运算和矩阵拼接在预分配的寄存器中完成，重复求值不再分配内存
+			/// 持有Calculator内部的指针，Calculator析构、被赋值或clearVariables之后不能再使用
+			///
+			class Expression
+			{
+			public:
+				auto evaluate()->const Matrix&;
+				auto empty()const->bool { return program_.empty(); }
+
+			private:
+				struct Instruction
+				{
+					enum Code { CONSTANT, VARIABLE, PLUS, NEGATE, ADD, MINUS, MULTIPLY, DIVIDE, UNARY_LEFT, UNARY_RIGHT, BINARY, FUNCTION, BRACE };
+
+					Code code;
+					Size a, b; // 操作数所在的指令；FUNCTION和BRACE中为operands_中的起始位置和数量
+					const Matrix *var;
+					const Operator *opr;
+					const std::function<Matrix(std::vector<Matrix>)> *fun;
+				};
+
+				auto emit(Instruction ins)->Size;
+				auto emitConstant(Matrix value)->Size;
+				auto run(Size i)->void;
+
+				std::vector<Instruction> program_;
+				std::vector<Size> operands_;
+				std::vector<Matrix> registers_;
+				std::vector<const Matrix*> values_;
+				const Calculator *calculator_{ nullptr };
+				std::uint64_t version_{ 0 };
+
+				friend class Calculator;
+			};
+
 		private:
+			// 编译缓存，拷贝Calculator时不拷贝，被赋值时清空，避免指向其他Calculator的变量 //
+			struct ExpressionCache
+			{
+				static const std::size_t MAX_SIZE = 1024;
+
+				auto clear()->void { std::lock_guard<std::mutex> lck(mu_); map_.clear(); ++version_; }
+
+				ExpressionCache() = default;
+				ExpressionCache(const ExpressionCache &) {}
+				ExpressionCache& operator=(const ExpressionCache &) { clear(); return *this; }
+
+				std::mutex mu_;
+				std::unordered_map<std::string, Expression> map_;
+				std::uint64_t version_{ 0 };
+			};
+
 			std::map<std::string, Operator> operator_map_;
 			std::map<std::string, Function> function_map_;
 			std::map<std::string, Matrix> variable_map_;
 			std::map<std::string, std::string> string_map_;//string variable
+			mutable ExpressionCache cache_;
 		};
 	}
 }
@@ -3,9 +3,13 @@
 #include <functional>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <algorithm>
 #include <limits>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
 
 #include "aris_core_object.h"
 
@@ -33,6 +37,83 @@ namespace aris
 				return nullptr;
 			}
 
+			// 子节点的名字索引，name -> (第一个同名子节点的位置, 同名子节点数量) //
+			struct NameIndex
+			{
+				auto insert(const std::string &name, std::size_t pos)->void
+				{
+					auto ret = map_.insert(std::make_pair(name, std::make_pair(pos, std::size_t(1))));
+					if (!ret.second) { ret.first->second.first = std::min(ret.first->second.first, pos); ++ret.first->second.second; }
+				}
+				auto remove(const std::string &name, std::size_t pos)->bool
+				{
+					auto found = map_.find(name);
+					if (found == map_.end()) return false;
+					if (--found->second.second == 0) { map_.erase(found); return true; }
+					// 仍有同名节点且删掉的是第一个时，无法直接得知下一个位置，交由重建处理 //
+					return found->second.first != pos;
+				}
+				
+				std::unordered_map<std::string, std::pair<std::size_t, std::size_t>> map_;
+				std::size_t indexed_size_{ 0 };
+				std::uint64_t version_{ 0 };
+				bool valid_{ false };
+			};
+			// 子节点少于该数量时线性查找更快，不建索引 //
+			static const std::size_t NAME_INDEX_MIN_SIZE = 8;
+
+			// 索引只在修改子节点的函数中（add、loadXml、赋值、改名）更新，findByName 只读，可以被多个线程同时调用 //
+			// 通过 children() 直接修改容器后索引与子节点不再同步，此时 findByName 退化为线性查找，直到下一次更新 //
+			auto nameIndexSynced()const->bool
+			{
+				return name_index_ && name_index_->valid_ && name_index_->version_ == children_.version_ && name_index_->indexed_size_ == children_.size();
+			}
+			auto updateNameIndex()->void
+			{
+				if (children_.size() < NAME_INDEX_MIN_SIZE) { name_index_.reset(); return; }
+
+				if (!name_index_)name_index_.reset(new NameIndex);
+				auto &index = *name_index_;
+
+				if (!index.valid_ || index.version_ != children_.version_ || index.indexed_size_ > children_.size())
+				{
+					index.map_.clear();
+					index.indexed_size_ = 0;
+					index.version_ = children_.version_;
+					index.valid_ = true;
+				}
+
+				// 尾部追加的子节点增量加入索引 //
+				for (; index.indexed_size_ < children_.size(); ++index.indexed_size_)
+					index.insert(children_.container_[index.indexed_size_]->imp_->name_, index.indexed_size_);
+			}
+			auto rebuildNameIndex()->void
+			{
+				if (name_index_)name_index_->valid_ = false;
+				updateNameIndex();
+			}
+			auto rebuildFatherIndex()->void { if (father_ && father_->imp_->name_index_)father_->imp_->rebuildNameIndex(); }
+			static auto setName(Object &obj, std::string name)->void
+			{
+				auto &imp = *obj.imp_;
+				if (name == imp.name_) return;
+
+				// 同步父节点的名字索引，索引已经不同步时（例如 loadXml 的过程中）由之后的更新重建 //
+				bool rebuild{ false };
+				if (imp.father_ && imp.father_->imp_->nameIndexSynced())
+				{
+					auto &index = *imp.father_->imp_->name_index_;
+					auto &siblings = imp.father_->imp_->children_;
+
+					if (imp.id_ >= siblings.size() || siblings.container_[imp.id_].get() != &obj) rebuild = true;
+					else if (index.remove(imp.name_, imp.id_)) index.insert(name, imp.id_);
+					else rebuild = true;
+				}
+
+				imp.name_ = std::move(name);
+				if (rebuild) imp.rebuildFatherIndex();
+			}
+
 			// 不变属性 //
 			Object *father_;
 			std::size_t id_;
@@ -42,6 +123,7 @@ namespace aris
 			std::string default_type_;
 			std::map<std::string, TypeInfo> type_map_;
 			ImpContainer<Object> children_;
+			std::unique_ptr<NameIndex> name_index_;
 
 			Imp() = default;
 			Imp(const Imp &other) = delete;
@@ -49,6 +131,133 @@ namespace aris
 			Imp &operator=(const Imp &) = delete;
 			Imp &operator=(Imp &&) = delete;
 		};
+		// 二进制快照 //
+		// 头：magic[8] version(u32) reserved(u32) source_hash(u64) body_size(u64) body_hash(u64) //
+		// 元素：name attr_num(u32) {attr_name attr_value}... text child_num(u32) {元素}... ，字符串为 长度(u32)+内容 //
+		struct SnapshotHeader
+		{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t reserved;
+			std::uint64_t source_hash;
+			std::uint64_t body_size;
+			std::uint64_t body_hash;
+		};
+		static const char SNAPSHOT_MAGIC[8]{ 'A','R','I','S','O','B','J','1' };
+		static const std::uint32_t SNAPSHOT_VERSION = 1;
+		static auto snapshotHash(const char *data, std::size_t size)->std::uint64_t
+		{
+			// FNV-1a //
+			std::uint64_t hash = 14695981039346656037ULL;
+			for (std::size_t i = 0; i < size; ++i) { hash ^= static_cast<unsigned char>(data[i]); hash *= 1099511628211ULL; }
+			return hash;
+		}
+		static auto snapshotWriteU32(std::string &data, std::uint32_t value)->void { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+		static auto snapshotWriteStr(std::string &data, const char *str)->void
+		{
+			auto size = static_cast<std::uint32_t>(str ? std::strlen(str) : 0);
+			snapshotWriteU32(data, size);
+			data.append(str ? str : "", size);
+		}
+		static auto snapshotWriteElement(std::string &data, const aris::core::XmlElement &xml_ele)->void
+		{
+			snapshotWriteStr(data, xml_ele.Name());
+
+			std::uint32_t attr_num = 0;
+			for (auto attr = xml_ele.FirstAttribute(); attr; attr = attr->Next()) ++attr_num;
+			snapshotWriteU32(data, attr_num);
+			for (auto attr = xml_ele.FirstAttribute(); attr; attr = attr->Next())
+			{
+				snapshotWriteStr(data, attr->Name());
+				snapshotWriteStr(data, attr->Value());
+			}
+
+			snapshotWriteStr(data, xml_ele.GetText());
+
+			std::uint32_t child_num = 0;
+			for (auto ele = xml_ele.FirstChildElement(); ele; ele = ele->NextSiblingElement()) ++child_num;
+			snapshotWriteU32(data, child_num);
+			for (auto ele = xml_ele.FirstChildElement(); ele; ele = ele->NextSiblingElement()) snapshotWriteElement(data, *ele);
+		}
+		static auto snapshotWriteDoc(std::string &data, const aris::core::XmlDocument &doc, std::uint64_t source_hash)->void
+		{
+			data.assign(sizeof(SnapshotHeader), '\0');
+			snapshotWriteElement(data, *doc.RootElement());
+
+			SnapshotHeader header;
+			std::copy_n(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC), header.magic);
+			header.version = SNAPSHOT_VERSION;
+			header.reserved = 0;
+			header.source_hash = source_hash;
+			header.body_size = data.size() - sizeof(SnapshotHeader);
+			header.body_hash = snapshotHash(data.data() + sizeof(SnapshotHeader), data.size() - sizeof(SnapshotHeader));
+			std::memcpy(&data[0], &header, sizeof(header));
+		}
+		// loadXmlFile(filename, snapshot_filename) 读取xml时记录的表达式求值结果 //
+		struct SnapshotValue
+		{
+			const aris::core::XmlElement *ele_;
+			bool is_text_;
+			std::string attribute_, value_;
+		};
+		static thread_local std::vector<SnapshotValue> *snapshot_values_{ nullptr };
+		struct SnapshotReader
+		{
+			auto readU32()->std::uint32_t
+			{
+				std::uint32_t value;
+				if (end_ - p_ < static_cast<std::ptrdiff_t>(sizeof(value))) throw std::runtime_error("failed in Object::loadBinaryStr : snapshot is truncated");
+				std::memcpy(&value, p_, sizeof(value));
+				p_ += sizeof(value);
+				return value;
+			}
+			auto readStr()->std::string
+			{
+				auto size = readU32();
+				if (static_cast<std::size_t>(end_ - p_) < size) throw std::runtime_error("failed in Object::loadBinaryStr : snapshot is truncated");
+				std::string str(p_, size);
+				p_ += size;
+				return str;
+			}
+			auto readElement(aris::core::XmlDocument &doc)->aris::core::XmlElement*
+			{
+				auto xml_ele = doc.NewElement(readStr().c_str());
+				for (auto attr_num = readU32(); attr_num > 0; --attr_num)
+				{
+					auto attr_name = readStr();
+					xml_ele->SetAttribute(attr_name.c_str(), readStr().c_str());
+				}
+				auto text = readStr();
+				if (!text.empty())xml_ele->SetText(text.c_str());
+				for (auto child_num = readU32(); child_num > 0; --child_num) xml_ele->InsertEndChild(readElement(doc));
+				return xml_ele;
+			}
+
+			const char *p_, *end_;
+		};
+		// 校验头和数据完整性，不合法时返回nullptr //
+		static auto snapshotHeader(const std::string &data)->const SnapshotHeader*
+		{
+			if (data.size() < sizeof(SnapshotHeader)) return nullptr;
+			auto header = reinterpret_cast<const SnapshotHeader*>(data.data());
+			if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) || header->version != SNAPSHOT_VERSION) return nullptr;
+			if (header->body_size != data.size() - sizeof(SnapshotHeader)) return nullptr;
+			if (header->body_hash != snapshotHash(data.data() + sizeof(SnapshotHeader), data.size() - sizeof(SnapshotHeader))) return nullptr;
+			return header;
+		}
+		static auto snapshotReadFile(const std::string &filename, std::string &data)->bool
+		{
+			std::ifstream file(filename, std::ios::binary);
+			if (!file) return false;
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			return true;
+		}
+		static auto snapshotWriteFile(const std::string &filename, const std::string &data)->bool
+		{
+			std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+			return file && file.write(data.data(), data.size());
+		}
+
 		auto Object::attributeBool(const aris::core::XmlElement &xml_ele, const std::string &attribute_name)->bool
 		{
 			std::string error = "failed to get bool attribute \"" + attribute_name + "\" in element \"" + xml_ele.Name() + "\", because ";
@@ -358,7 +567,7 @@ namespace aris
 			if (xml_ele.Attribute("type") && type() != xml_ele.Attribute("type")) throw std::runtime_error("failed in Object::loadXml : you can't use a \"" + type() + "\" to load a \"" + xml_ele.Attribute("type") +"\" xml element");
 			
 			// set name and default child type //
-			imp_->name_ = xml_ele.Name();
+			Imp::setName(*this, xml_ele.Name());
 			imp_->default_type_ = xml_ele.Attribute("default_child_type") ? xml_ele.Attribute("default_child_type") : Object::Type();
 			
 			// insert children //
@@ -376,6 +585,7 @@ namespace aris
 				children().back().imp_->id_ = children().size() - 1;
 				children().back().loadXml(*ele);
 			}
+			imp_->rebuildNameIndex();
 		}
 		auto Object::saveXmlFile(const std::string &filename) const->void
 		{
@@ -394,6 +604,82 @@ namespace aris
 			loadXmlDoc(xmlDoc);
 		}
 		auto Object::loadXmlDoc(const aris::core::XmlDocument &xml_doc)->void { loadXml(*xml_doc.RootElement()); }
+		auto Object::saveBinaryStr(std::string &data, std::uint64_t source_hash)const->void
+		{
+			aris::core::XmlDocument doc;
+			saveXmlDoc(doc);
+			snapshotWriteDoc(data, doc, source_hash);
+		}
+		auto Object::loadBinaryStr(const std::string &data)->void
+		{
+			if (!snapshotHeader(data)) throw std::runtime_error("failed in Object::loadBinaryStr : invalid or corrupted snapshot");
+
+			SnapshotReader reader{ data.data() + sizeof(SnapshotHeader), data.data() + data.size() };
+			aris::core::XmlDocument doc;
+			doc.InsertEndChild(reader.readElement(doc));
+			if (reader.p_ != reader.end_) throw std::runtime_error("failed in Object::loadBinaryStr : snapshot has trailing data");
+
+			loadXmlDoc(doc);
+		}
+		auto Object::saveBinaryFile(const std::string &filename, std::uint64_t source_hash)const->void
+		{
+			std::string data;
+			saveBinaryStr(data, source_hash);
+			if (!snapshotWriteFile(filename, data)) throw std::runtime_error("could not write file:" + filename);
+		}
+		auto Object::loadBinaryFile(const std::string &filename)->void
+		{
+			std::string data;
+			if (!snapshotReadFile(filename, data)) throw std::runtime_error("could not open file:" + filename);
+			loadBinaryStr(data);
+		}
+		auto Object::loadXmlFile(const std::string &filename, const std::string &snapshot_filename)->void
+		{
+			std::string xml_str;
+			if (!snapshotReadFile(filename, xml_str)) throw std::runtime_error("could not open file:" + filename);
+			auto source_hash = snapshotHash(xml_str.data(), xml_str.size());
+
+			std::string snapshot;
+			auto header = snapshotReadFile(snapshot_filename, snapshot) ? snapshotHeader(snapshot) : nullptr;
+			if (header && header->source_hash == source_hash)
+			{
+				loadBinaryStr(snapshot);
+				return;
+			}
+
+			aris::core::XmlDocument doc;
+			if (doc.Parse(xml_str.c_str(), xml_str.size()) != 0)throw std::runtime_error("could not parse file:" + filename);
+
+			std::vector<SnapshotValue> values;
+			{
+				struct Recording
+				{
+					std::vector<SnapshotValue> *last_;
+					~Recording() { snapshot_values_ = last_; }
+				} recording{ snapshot_values_ };
+				snapshot_values_ = &values;
+				loadXmlDoc(doc);
+			}
+
+			// 快照保存xml文件本身的元素树而非saveXml的结果，其中的表达式替换为求值的结果 //
+			// 数值能被精确还原，读取快照时不再求值，得到的对象与读取xml完全相同 //
+			for (auto &v : values)
+			{
+				if (v.ele_->GetDocument() != &doc) continue;
+				auto ele = const_cast<aris::core::XmlElement*>(v.ele_);
+				if (v.is_text_) ele->SetText(v.value_.c_str());
+				else ele->SetAttribute(v.attribute_.c_str(), v.value_.c_str());
+			}
+
+			// 快照只是缓存，写入失败（例如只读文件系统）时忽略 //
+			snapshotWriteDoc(snapshot, doc, source_hash);
+			snapshotWriteFile(snapshot_filename, snapshot);
+		}
+		auto Object::snapshotRecording()->bool { return snapshot_values_ != nullptr; }
+		auto Object::recordSnapshotValue(const aris::core::XmlElement &xml_ele, const char *attribute_name, const std::string &value)->void
+		{
+			if (snapshot_values_) snapshot_values_->push_back(SnapshotValue{ &xml_ele, attribute_name == nullptr, attribute_name ? attribute_name : "", value });
+		}
 		auto Object::saveXmlDoc(aris::core::XmlDocument &xml_doc)const->void
 		{
 			xml_doc.DeleteChildren();
@@ -420,13 +706,32 @@ namespace aris
 		auto Object::children()->ImpContainer<Object>& { return imp_->children_; }
 		auto Object::findByName(const std::string &name)->ImpContainer<Object>::iterator
 		{
-			return std::find_if(children().begin(), children().end(), [&name, this](Object & p) {return (p.name() == name); });
+			if (children().size() < Imp::NAME_INDEX_MIN_SIZE || !imp_->nameIndexSynced())
+				return std::find_if(children().begin(), children().end(), [&name, this](Object & p) {return (p.name() == name); });
+
+			auto &map = imp_->name_index_->map_;
+			auto found = map.find(name);
+			return found == map.end() ? children().end() : children().begin() + found->second.first;
+		}
+		auto Object::findByPath(const std::string &path)->Object*
+		{
+			Object *obj = (!path.empty() && path.front() == '/') ? &root() : this;
+			for (std::size_t begin = 0, end = 0; obj && begin < path.size(); begin = end + 1)
+			{
+				end = std::min(path.find('/', begin), path.size());
+				if (end == begin) continue;
+
+				auto iter = obj->findByName(path.substr(begin, end - begin));
+				obj = iter == obj->children().end() ? nullptr : &*iter;
+			}
+			return obj;
 		}
 		auto Object::add(Object *obj)->Object &
 		{
 			children().push_back_ptr(obj);
 			children().back().imp_->id_ = children().size() - 1;
 			children().back().imp_->father_ = this;
+			imp_->updateNameIndex();
 
 			return children().back();
 		}
@@ -457,6 +762,7 @@ namespace aris
 				children().back().imp_->father_ = this;
 				children().back().imp_->id_ = children().size() - 1;
 			}
+			imp_->updateNameIndex();
 		}
 		Object::Object(Object &&other) : imp_(std::move(other.imp_)) 
 		{ 
@@ -466,7 +772,7 @@ namespace aris
 		}
 		Object& Object::operator=(const Object &other)
 		{
-			imp_->name_ = other.imp_->name_;
+			Imp::setName(*this, other.imp_->name_);
 			imp_->default_type_ = other.imp_->default_type_;
 			imp_->type_map_ = other.imp_->type_map_;
 
@@ -489,6 +795,7 @@ namespace aris
 				{
 					if (info->copy_construct_func == nullptr)throw std::runtime_error("type \"" + other.children().at(i).type() + "\" does not has copy construct function in Object::operator=(const Object &other)");
 					children().container_.at(i).reset(info->copy_construct_func(other.children().at(i)));
+					++children().version_;
 				}
 				else
 				{
@@ -499,6 +806,7 @@ namespace aris
 				children().at(i).imp_->id_ = i;
 				children().at(i).imp_->father_ = this;
 			}
+			imp_->rebuildNameIndex();
 
 			return *this;
 		}
@@ -521,6 +829,7 @@ namespace aris
 				{
 					if (info->move_construct_func == nullptr)throw std::runtime_error("type \"" + other.children().at(i).type() + "\" does not has move construct function in Object::operator=(Object &&other)");
 					children().container_.at(i).reset(info->move_construct_func(std::move(other.children().at(i))));
+					++children().version_;
 				}
 				else
 				{
@@ -532,7 +841,9 @@ namespace aris
 				children().at(i).imp_->father_ = this;
 			}
 
-			imp_->name_ = std::move(other.imp_->name_);
+			Imp::setName(*this, std::move(other.imp_->name_));
+			other.imp_->rebuildFatherIndex();
+			imp_->rebuildNameIndex();
 			imp_->default_type_ = std::move(other.imp_->default_type_);
 			imp_->type_map_ = std::move(other.imp_->type_map_);
 			return *this;
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <map>
 #include <utility>
+#include <cstdint>
 #include <sstream>
 
 #include <iostream>
@@ -428,23 +429,25 @@ namespace aris
 			auto operator[](size_type size)->reference { return *container_.operator[](size); } //optional
 			auto operator[](size_type size) const->const_reference { return *container_.operator[](size); } //optional
 
-			auto pop_back()->void { container_.pop_back(); } //optional
-			auto erase(iterator iter)->iterator { return container_.erase(iter.iter_); } //optional
-			auto erase(iterator begin_iter, iterator end_iter)->iterator { return container_.erase(begin_iter.iter_, end_iter.iter_); } //optional
-			auto clear()->void { container_.clear(); } //optional
+			auto pop_back()->void { ++version_; container_.pop_back(); } //optional
+			auto erase(iterator iter)->iterator { ++version_; return container_.erase(iter.iter_); } //optional
+			auto erase(iterator begin_iter, iterator end_iter)->iterator { ++version_; return container_.erase(begin_iter.iter_, end_iter.iter_); } //optional
+			auto clear()->void { ++version_; container_.clear(); } //optional
 			
 			auto push_back_ptr(T*ptr)->void { container_.push_back(ImpPtr<T>(ptr)); }
-			auto swap(ImpContainer& other)->void { return container_.swap(other.container_); }
+			auto swap(ImpContainer& other)->void { ++version_; ++other.version_; return container_.swap(other.container_); }
 
 			~ImpContainer() = default;
 			ImpContainer() = default;
 			ImpContainer(const ImpContainer&) = default;
 			ImpContainer(ImpContainer&&other) = default;
-			ImpContainer& operator=(const ImpContainer& other) = default;
-			ImpContainer& operator=(ImpContainer&& other) = default;
+			ImpContainer& operator=(const ImpContainer& other) { ++version_; container_ = other.container_; return *this; }
+			ImpContainer& operator=(ImpContainer&& other) { ++version_; ++other.version_; container_ = std::move(other.container_); return *this; }
 
 		private:
 			typename std::vector<ImpPtr<T>> container_;
+			// 除尾部追加外的所有修改都会改变版本号，Object的名字索引据此判断是否需要重建 //
+			std::uint64_t version_{ 0 };
 			friend class Object;
 		};
 
@@ -608,6 +611,23 @@ namespace aris
 			auto saveXmlFile(const std::string &filename) const->void;
 			auto loadXmlDoc(const aris::core::XmlDocument &xml_doc)->void;
 			auto saveXmlDoc(aris::core::XmlDocument &xml_doc)const->void;
+			/// 二进制快照，保存saveXml所得的已求值元素树，读取时跳过xml文本解析，数值属性不再经过表达式求值
+			/// 数值按能精确还原的位数保存，但由 pe 等导出的量（如 pm）可能与原对象相差舍入误差
+			///
+			auto saveBinaryStr(std::string &data, std::uint64_t source_hash = 0)const->void;
+			auto loadBinaryStr(const std::string &data)->void;
+			auto saveBinaryFile(const std::string &filename, std::uint64_t source_hash = 0)const->void;
+			auto loadBinaryFile(const std::string &filename)->void;
+			/// 以xml文件为准：快照中记录的hash与xml内容一致时读取快照，否则读取xml并重新生成快照
+			/// 此处快照保存xml文件本身的元素树，其中求值过的表达式（见recordSnapshotValue）替换为能精确还原的数值，
+			/// 读取快照时跳过文本解析与表达式求值，结果与读取xml完全相同
+			///
+			auto loadXmlFile(const std::string &filename, const std::string &snapshot_filename)->void;
+			/// 在 loadXml 中对属性（attribute_name 为 nullptr 时为元素的文本）求值之后调用，value 为结果的 Matrix::toString()，
+			/// 只在 loadXmlFile(filename, snapshot_filename) 读取xml的过程中记录，snapshotRecording() 为 false 时可以不必生成 value
+			///
+			static auto snapshotRecording()->bool;
+			static auto recordSnapshotValue(const aris::core::XmlElement &xml_ele, const char *attribute_name, const std::string &value)->void;
 			auto loadXmlStr(const std::string &xml_str)->void { aris::core::XmlDocument xml_doc; xml_doc.Parse(xml_str.c_str()); loadXmlDoc(xml_doc); };
 			auto saveXmlStr(std::string &xml_str)const->void { xml_str = xmlString(); };
 			auto xmlString()const->std::string;
@@ -621,8 +641,12 @@ namespace aris
 			auto children()const->const ImpContainer<Object>&{ return const_cast<std::decay_t<decltype(*this)> *>(this)->children(); }
 			auto findByName(const std::string &name)const->ImpContainer<Object>::const_iterator { return const_cast<std::decay_t<decltype(*this)> *>(this)->findByName(name); }
 			auto findByName(const std::string &name)->ImpContainer<Object>::iterator;
+			/// 按路径查找子孙节点，例如 "part_pool/part1/marker1"，以 '/' 开头时从根节点开始查找，找不到时返回nullptr
+			///
+			auto findByPath(const std::string &path)const->const Object* { return const_cast<std::decay_t<decltype(*this)> *>(this)->findByPath(path); }
+			auto findByPath(const std::string &path)->Object*;
 			template<typename T = Object>
-			auto findType(const std::string &name)const->const T*{ return const_cast<Object*>(this)->findType<T>(); };
+			auto findType(const std::string &name)const->const T*{ return const_cast<Object*>(this)->findType<T>(name); };
 			template<typename T = Object>
 			auto findType(const std::string &name)->T* { auto iter = findByName(name); return iter != children().end() && dynamic_cast<T*>(&*iter) ? dynamic_cast<T*>(&*iter) : nullptr; }
 			template<typename T = Object, typename ...Args>
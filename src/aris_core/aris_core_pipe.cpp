@@ -13,57 +13,160 @@ namespace aris
 	{
 		struct Pipe::Imp
 		{
-			std::size_t pool_size_;
-			std::unique_ptr<char[]> pool_;
-			std::atomic_size_t send_pos_{ 0 }, recv_pos_{ 0 };
+			// 每条消息（MsgHeader + 数据）在缓冲区中连续存放，按 MsgHeader 对齐，因此可以直接在缓冲区中读写 //
+			// 若末尾剩余空间放不下一条消息，则写入 msg_size_ 为 -1 的填充头（剩余空间不足一个头时省略）并回到起点 //
+			// send_pos_ 与 recv_pos_ 为单调递增的字节计数，pool_size_ 为2的幂，与 mask_ 按位与即为缓冲区中的位置 //
+			static const std::size_t CACHE_LINE = 64;
+
+			static auto recordSize(MsgSize msg_size)->std::size_t { return (sizeof(MsgHeader) + msg_size + alignof(MsgHeader) - 1) / alignof(MsgHeader) * alignof(MsgHeader); }
+			auto header(std::size_t pos)->MsgHeader* { return reinterpret_cast<MsgHeader*>(reinterpret_cast<char*>(pool_.get()) + (pos & mask_)); }
+			auto resetPool(std::size_t pool_size)->void
+			{
+				for (pool_size_ = alignof(MsgHeader); pool_size_ < std::max(pool_size, sizeof(MsgHeader)); pool_size_ <<= 1);
+				mask_ = pool_size_ - 1;
+				pool_.reset(new std::int64_t[pool_size_ / sizeof(std::int64_t)]());
+				send_pos_.store(0);
+				recv_pos_.store(0);
+				cached_recv_pos_ = 0;
+				cached_send_pos_ = 0;
+			}
+
+			std::size_t pool_size_, mask_;
+			std::unique_ptr<std::int64_t[]> pool_;
+
+			// 发送端与接收端各自的数据放在不同的缓存行中，避免伪共享 //
+			// 各端缓存对端的位置，只有在空间或数据看起来不够时才重新读取对端的原子变量 //
+			char padding0_[CACHE_LINE];
+			std::atomic_size_t send_pos_{ 0 };
+			std::size_t cached_recv_pos_{ 0 };
+			std::size_t reserve_pos_{ 0 };
+			MsgSize reserve_size_{ 0 };
+			MsgHeader *reserve_header_{ nullptr };
+
+			char padding1_[CACHE_LINE];
+			std::atomic_size_t recv_pos_{ 0 };
+			std::size_t cached_send_pos_{ 0 };
+			const MsgHeader *peek_header_{ nullptr };
+			char padding2_[CACHE_LINE];
 		};
 		auto Pipe::loadXml(const aris::core::XmlElement &xml_ele)->void
 		{
-			imp_->pool_size_ = attributeInt32(xml_ele, "pool_size", 16384);
-			imp_->pool_.reset(new char[imp_->pool_size_]());
+			imp_->resetPool(attributeInt32(xml_ele, "pool_size", 16384));
 
 			Object::loadXml(xml_ele);
 		}
+		auto Pipe::reserve(MsgSize size)->MsgHeader*
+		{
+			if (size < 0) return nullptr;
+
+			auto send_pos = imp_->send_pos_.load(std::memory_order_relaxed);
+
+			auto need = Imp::recordSize(size);
+			auto offset = send_pos & imp_->mask_;
+			auto padding = offset + need > imp_->pool_size_ ? imp_->pool_size_ - offset : 0;
+			if (padding + need > imp_->pool_size_ - (send_pos - imp_->cached_recv_pos_))
+			{
+				imp_->cached_recv_pos_ = imp_->recv_pos_.load(std::memory_order_acquire);
+				if (padding + need > imp_->pool_size_ - (send_pos - imp_->cached_recv_pos_)) return nullptr;
+			}
+
+			if (padding >= sizeof(MsgHeader)) imp_->header(send_pos)->msg_size_ = -1;
+
+			imp_->reserve_pos_ = send_pos + padding;
+			imp_->reserve_size_ = size;
+			imp_->reserve_header_ = imp_->header(imp_->reserve_pos_);
+			*imp_->reserve_header_ = MsgHeader{ size, 0, 0, 0, 0, 0 };
+			return imp_->reserve_header_;
+		}
+		auto Pipe::commit()->void
+		{
+			if (!imp_->reserve_header_) return;
+			imp_->reserve_header_->msg_size_ = std::max(MsgSize(0), std::min(imp_->reserve_header_->msg_size_, imp_->reserve_size_));
+			imp_->send_pos_.store(imp_->reserve_pos_ + Imp::recordSize(imp_->reserve_header_->msg_size_), std::memory_order_release);
+			imp_->reserve_header_ = nullptr;
+		}
+		auto Pipe::peek()->const MsgHeader*
+		{
+			if (imp_->peek_header_) return imp_->peek_header_;
+
+			for (auto recv_pos = imp_->recv_pos_.load(std::memory_order_relaxed);;)
+			{
+				if (recv_pos == imp_->cached_send_pos_)
+				{
+					imp_->cached_send_pos_ = imp_->send_pos_.load(std::memory_order_acquire);
+					if (recv_pos == imp_->cached_send_pos_) return nullptr;
+				}
+
+				auto offset = recv_pos & imp_->mask_;
+				if (imp_->pool_size_ - offset < sizeof(MsgHeader) || imp_->header(recv_pos)->msg_size_ < 0)
+				{
+					recv_pos += imp_->pool_size_ - offset;
+					imp_->recv_pos_.store(recv_pos, std::memory_order_release);
+					continue;
+				}
+
+				return imp_->peek_header_ = imp_->header(recv_pos);
+			}
+		}
+		auto Pipe::release()->void
+		{
+			if (!imp_->peek_header_) return;
+			imp_->recv_pos_.store(imp_->recv_pos_.load(std::memory_order_relaxed) + Imp::recordSize(imp_->peek_header_->msg_size_), std::memory_order_release);
+			imp_->peek_header_ = nullptr;
+		}
 		auto Pipe::sendMsg(const aris::core::MsgBase &msg)->bool
 		{
-			auto send_pos = imp_->send_pos_.load();
-			auto recv_pos = imp_->recv_pos_.load();
-			
-			std::size_t remain_data_size = (send_pos - recv_pos + imp_->pool_size_) % imp_->pool_size_;
-			if (remain_data_size + sizeof(MsgHeader) + msg.size()> imp_->pool_size_) return false;
-			std::size_t send_num1 = send_pos + sizeof(MsgHeader) + msg.size() > imp_->pool_size_ ? imp_->pool_size_ - send_pos : sizeof(MsgHeader) + msg.size();
-			std::size_t send_num2 = sizeof(MsgHeader) + msg.size() - send_num1;
-			std::copy_n(reinterpret_cast<const char *>(&msg.header()), send_num1, &imp_->pool_[send_pos]);
-			std::copy_n(reinterpret_cast<const char *>(&msg.header()) + send_num1, send_num2, &imp_->pool_[0]);
-			imp_->send_pos_.store( (send_pos + msg.size() + sizeof(MsgHeader)) % imp_->pool_size_);
+			auto header = reserve(msg.size());
+			if (!header) return false;
+			std::copy_n(reinterpret_cast<const char *>(&msg.header()), sizeof(MsgHeader) + msg.size(), reinterpret_cast<char *>(header));
+			commit();
 			return true;
 		}
 		auto Pipe::recvMsg(aris::core::MsgBase &msg)->bool
 		{
-			auto send_pos = imp_->send_pos_.load();
-			auto recv_pos = imp_->recv_pos_.load();
-			
-			MsgHeader header;
-			if (send_pos == recv_pos) return false;
-			std::size_t recv_num1 = recv_pos + sizeof(MsgHeader) > imp_->pool_size_ ? imp_->pool_size_ - recv_pos : sizeof(MsgHeader);
-			std::size_t recv_num2 = sizeof(MsgHeader) - recv_num1;
-			std::copy_n(&imp_->pool_[recv_pos], recv_num1, reinterpret_cast<char *>(&header));
-			std::copy_n(&imp_->pool_[0], recv_num2, reinterpret_cast<char *>(&header) + recv_num1);
-			msg.resize(header.msg_size_);
-			recv_num1 = recv_pos + sizeof(MsgHeader) + msg.size() > imp_->pool_size_ ? imp_->pool_size_ - recv_pos : sizeof(MsgHeader) + msg.size();
-			recv_num2 = sizeof(MsgHeader) + msg.size() - recv_num1;
-			std::copy_n(&imp_->pool_[recv_pos], recv_num1, reinterpret_cast<char *>(&msg.header()));
-			std::copy_n(&imp_->pool_[0], recv_num2, reinterpret_cast<char *>(&msg.header()) + recv_num1);
-			imp_->recv_pos_.store((recv_pos + msg.size() + sizeof(MsgHeader)) % imp_->pool_size_);
+			auto header = peek();
+			if (!header) return false;
+			msg.resize(header->msg_size_);
+			std::copy_n(reinterpret_cast<const char *>(header), sizeof(MsgHeader) + header->msg_size_, reinterpret_cast<char *>(&msg.header()));
+			release();
 			return true;
 		}
 		Pipe::~Pipe() = default;
 		Pipe::Pipe(const std::string &name, std::size_t pool_size) :Object(name), imp_(new Imp)
 		{
-			imp_->pool_size_ = pool_size;
-			imp_->pool_.reset(new char[imp_->pool_size_]());
+			imp_->resetPool(pool_size);
 		}
 		Pipe::Pipe(Pipe&&) = default;
 		Pipe& Pipe::operator=(Pipe&&) = default;
+
+		auto PipeMsg::acquire()->void
+		{
+			if (isInPipe()) return;
+			auto spill_size = header_->msg_size_;
+			if (auto reserved = pipe_->reserve(capacity_))
+			{
+				// 内部缓冲中已经写入的内容移到预留的位置 //
+				std::copy_n(reinterpret_cast<const char *>(header_), sizeof(MsgHeader) + spill_size, reinterpret_cast<char *>(reserved));
+				header_ = reserved;
+			}
+		}
+		auto PipeMsg::send()->bool
+		{
+			if (empty()) return true;
+
+			bool ret = true;
+			if (isInPipe()) pipe_->commit();
+			else ret = pipe_->sendMsg(*this);
+
+			header_ = reinterpret_cast<MsgHeader*>(spill_.get());
+			*header_ = MsgHeader{ 0, 0, 0, 0, 0, 0 };
+			acquire();
+			return ret;
+		}
+		PipeMsg::PipeMsg(Pipe &pipe, MsgSize capacity) :pipe_(&pipe), capacity_(capacity)
+			, spill_(new std::int64_t[(sizeof(MsgHeader) + capacity + sizeof(std::int64_t) - 1) / sizeof(std::int64_t)]())
+		{
+			header_ = reinterpret_cast<MsgHeader*>(spill_.get());
+		}
 	}
 }
@@ -19,8 +19,16 @@ namespace aris
 			auto virtual loadXml(const aris::core::XmlElement &xml_ele)->void override;
 			auto sendMsg(const aris::core::MsgBase &)->bool;
 			auto recvMsg(aris::core::MsgBase &)->bool;
+			/// 在缓冲区中直接预留一条 size 字节的消息，数据紧跟在返回的 MsgHeader 之后，空间不足时返回 nullptr
+			/// commit 之前可以减小 msg_size_，commit 后接收端才可见
+			auto reserve(MsgSize size)->MsgHeader*;
+			auto commit()->void;
+			/// 直接返回缓冲区中最早的一条消息，没有消息时返回 nullptr，release 之前该消息一直有效
+			auto peek()->const MsgHeader*;
+			auto release()->void;
 
 			virtual ~Pipe();
+			/// pool_size 会向上取整为2的幂
 			Pipe(const std::string &name = "pipe", std::size_t pool_size = 16384);
 			Pipe(const Pipe&) = delete;
 			Pipe(Pipe&&);
@@ -31,6 +39,34 @@ namespace aris
 			struct Imp;
 			aris::core::ImpPtr<Imp> imp_;
 		};
+		/// 直接写在 Pipe 缓冲区中的消息，供实时线程的发送端使用，MsgStream 可以绑定在它上面
+		///
+		/// acquire() 在缓冲区中预留 capacity 字节，此后的写入直接进入缓冲区，send() 提交时不再拷贝；
+		/// 缓冲区空间不足时退回到内部缓冲，send() 时拷贝一次。每次 send() 或 acquire() 之后，绑定的 MsgStream 需要 resetBuf()。
+		/// 只能由 Pipe 的发送线程使用，且预留期间不能再通过 sendMsg/reserve 向同一个 Pipe 发送，Pipe 重新分配缓冲区（loadXml）之后需要重新 acquire()。
+		class PipeMsg final :public MsgBase
+		{
+		public:
+			auto virtual resize(MsgSize size)->void override { header().msg_size_ = std::min(size, capacity_); }
+			auto virtual header()->MsgHeader& override { return *header_; }
+			auto virtual header()const->const MsgHeader& override { return *header_; }
+			auto virtual capacity()const->MsgSize override { return capacity_; }
+			auto acquire()->void;
+			auto isInPipe()const->bool { return header_ != reinterpret_cast<const MsgHeader*>(spill_.get()); }
+			/// 空消息不发送，返回 true；Pipe 已满时返回 false，消息被丢弃
+			auto send()->bool;
+
+			virtual ~PipeMsg() = default;
+			PipeMsg(Pipe &pipe, MsgSize capacity);
+			PipeMsg(const PipeMsg&) = delete;
+			PipeMsg& operator=(const PipeMsg&) = delete;
+
+		private:
+			Pipe *pipe_;
+			MsgSize capacity_;
+			MsgHeader *header_;
+			std::unique_ptr<std::int64_t[]> spill_;
+		};
 	}
 }
 
@@ -9,6 +9,11 @@
 #include <cstddef>
 #include <array>
 #include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 
 #include "aris_dynamic_block_matrix.h"
 
@@ -16,5 +21,107 @@ namespace aris
 {
 	namespace dynamic
 	{
+		// 常驻的工作线程池，每次只执行一批任务，任务下标通过原子计数器领取 //
+		class BlockThreadPool
+		{
+		public:
+			static auto instance()->BlockThreadPool& { static BlockThreadPool pool; return pool; }
+			auto threadCount()->Size { return workers_.size() + 1; }
+			auto setThreadCount(Size thread_count)->void
+			{
+				std::lock_guard<std::mutex> submit_lck(submit_mu_);
+				stopWorkers();
+				for (Size i = 1; i < thread_count; ++i) workers_.push_back(std::thread([this](std::uint64_t generation) { workerLoop(generation); }, generation_));
+			}
+			auto run(Size n, const std::function<void(Size)> &task)->void
+			{
+				std::lock_guard<std::mutex> submit_lck(submit_mu_);
+				{
+					std::lock_guard<std::mutex> lck(mu_);
+					task_ = &task;
+					n_ = n;
+					next_.store(0);
+					finished_ = 0;
+					acknowledged_ = 0;
+					++generation_;
+				}
+				cv_start_.notify_all();
+
+				const auto local = execute(task, n);
+
+				// 等待所有工作线程都领取过本批任务，保证没有线程在返回后还持有本批任务 //
+				std::unique_lock<std::mutex> lck(mu_);
+				finished_ += local;
+				cv_done_.wait(lck, [this]() { return finished_ == n_ && acknowledged_ == workers_.size(); });
+				task_ = nullptr;
+			}
+			~BlockThreadPool() { stopWorkers(); }
+
+		private:
+			static thread_local bool in_parallel_;
+
+			auto execute(const std::function<void(Size)> &task, Size n)->Size
+			{
+				in_parallel_ = true;
+				Size local{ 0 };
+				for (Size i; (i = next_.fetch_add(1)) < n; ++local) task(i);
+				in_parallel_ = false;
+				return local;
+			}
+			auto workerLoop(std::uint64_t generation)->void
+			{
+				for (;;)
+				{
+					std::unique_lock<std::mutex> lck(mu_);
+					cv_start_.wait(lck, [&]() { return stop_ || generation_ != generation; });
+					if (stop_) return;
+
+					generation = generation_;
+					auto task = task_;
+					auto n = n_;
+					lck.unlock();
+
+					const auto local = execute(*task, n);
+
+					lck.lock();
+					finished_ += local;
+					++acknowledged_;
+					if (finished_ == n_ && acknowledged_ == workers_.size()) cv_done_.notify_all();
+				}
+			}
+			auto stopWorkers()->void
+			{
+				{
+					std::lock_guard<std::mutex> lck(mu_);
+					stop_ = true;
+				}
+				cv_start_.notify_all();
+				for (auto &t : workers_) t.join();
+				workers_.clear();
+				stop_ = false;
+			}
+
+			friend auto s_blk_thread_count()->Size;
+
+			std::vector<std::thread> workers_;
+			std::mutex submit_mu_, mu_;
+			std::condition_variable cv_start_, cv_done_;
+			const std::function<void(Size)> *task_{ nullptr };
+			Size n_{ 0 }, finished_{ 0 }, acknowledged_{ 0 };
+			std::atomic<Size> next_{ 0 };
+			std::uint64_t generation_{ 0 };
+			bool stop_{ false };
+		};
+		thread_local bool BlockThreadPool::in_parallel_{ false };
+
+		auto s_blk_thread_count()->Size { return BlockThreadPool::in_parallel_ ? 1 : BlockThreadPool::instance().threadCount(); }
+		auto s_blk_set_thread_count(Size thread_count)->void { BlockThreadPool::instance().setThreadCount(std::max(thread_count, Size(1))); }
+		auto s_blk_parallel_run(Size n, const std::function<void(Size)> &task)->void { BlockThreadPool::instance().run(n, task); }
+		auto s_blk_parallel_run(Size thread_count, Size n, const std::function<void(Size)> &task)->void
+		{
+			BlockThreadPool pool;
+			pool.setThreadCount(std::max(thread_count, Size(1)));
+			pool.run(n, task);
+		}
 	}
 }
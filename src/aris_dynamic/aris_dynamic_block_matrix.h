@@ -42,6 +42,20 @@ namespace aris
 		auto inline next_rid(Size id, BlockStride blk_s)->Size { return next_rid(id, blk_s.self_stride); }
 		auto inline next_cid(Size id, BlockStride blk_s)->Size { return next_cid(id, blk_s.self_stride); }
 
+		// 块矩阵运算的并行线程数（包含调用线程），默认为1即串行计算；在工作线程内部调用时总是返回1，防止嵌套并行 //
+		auto s_blk_thread_count()->Size;
+		auto s_blk_set_thread_count(Size thread_count)->void;
+		// 将 [0, n) 个互相独立的任务分配到线程池中执行，调用线程也参与计算，所有任务完成后返回 //
+		auto s_blk_parallel_run(Size n, const std::function<void(Size)> &task)->void;
+		// 同上，但使用临时建立的 thread_count 个线程（包含调用线程），不影响全局线程池，任务中的块矩阵运算为串行 //
+		auto s_blk_parallel_run(Size thread_count, Size n, const std::function<void(Size)> &task)->void;
+		template <typename Task>
+		auto inline s_blk_parallel_for(Size n, Task &&task)->void
+		{
+			if (n > 1 && s_blk_thread_count() > 1) s_blk_parallel_run(n, std::function<void(Size)>(std::ref(task)));
+			else for (Size i(-1); ++i < n;) task(i);
+		}
+
 		template <typename AType, typename BType>
 		auto inline s_blk_map(const BlockSize &blk_m, const BlockSize &blk_n, double *A, AType a_t, BlockData &blk_A, BType blk_a_t)noexcept->void
 		{
@@ -155,48 +169,46 @@ namespace aris
 		template <typename AType, typename BType, typename CType>
 		auto inline s_blk_mma(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, const BlockData &A, AType a_t, const BlockData &B, BType b_t, BlockData &C, CType c_t)noexcept->void
 		{
-			for (Size i(-1), a_row{ 0 }, c_row{ 0 }; ++i < blk_m.size(); a_row = next_rid(a_row, a_t), c_row = next_rid(c_row, c_t))
+			// C 的各个块互相独立，按块分配到各线程 //
+			s_blk_parallel_for(blk_m.size() * blk_n.size(), [&](Size tile)
 			{
-				for (Size j(-1), b_col{ 0 }, c_id{ c_row }; ++j < blk_n.size(); b_col = next_cid(b_col, b_t), c_id = next_cid(c_id, c_t))
+				const Size i{ tile / blk_n.size() }, j{ tile % blk_n.size() }, c_id{ id(i, j, c_t) };
+				for (Size u(-1), a_id{ id(i, 0, a_t) }, b_id{ id(0, j, b_t) }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
 				{
-					for (Size u(-1), a_id{ a_row }, b_id{ b_col }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
+					if (!(A[a_id].is_zero || B[b_id].is_zero))
 					{
-						if (!(A[a_id].is_zero || B[b_id].is_zero))
+						if (C[c_id].is_zero)
 						{
-							if (C[c_id].is_zero)
-							{
-								C[c_id].is_zero = false;
-								s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
-							}
-
-							s_mma(blk_m[i], blk_n[j], blk_k[u], A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
+							C[c_id].is_zero = false;
+							s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
 						}
+
+						s_mma(blk_m[i], blk_n[j], blk_k[u], A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
 					}
 				}
-			}
+			});
 		}
 		template <typename AType, typename BType, typename CType>
 		auto inline s_blk_mma(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, double alpha, const BlockData &A, AType a_t, const BlockData &B, BType b_t, BlockData &C, CType c_t)noexcept->void
 		{
-			for (Size i(-1), a_row{ 0 }, c_row{ 0 }; ++i < blk_m.size(); a_row = next_rid(a_row, a_t), c_row = next_rid(c_row, c_t))
+			// C 的各个块互相独立，按块分配到各线程 //
+			s_blk_parallel_for(blk_m.size() * blk_n.size(), [&](Size tile)
 			{
-				for (Size j(-1), b_col{ 0 }, c_id{ c_row }; ++j < blk_n.size(); b_col = next_cid(b_col, b_t), c_id = next_cid(c_id, c_t))
+				const Size i{ tile / blk_n.size() }, j{ tile % blk_n.size() }, c_id{ id(i, j, c_t) };
+				for (Size u(-1), a_id{ id(i, 0, a_t) }, b_id{ id(0, j, b_t) }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
 				{
-					for (Size u(-1), a_id{ a_row }, b_id{ b_col }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
+					if (!(A[a_id].is_zero || B[b_id].is_zero))
 					{
-						if (!(A[a_id].is_zero || B[b_id].is_zero))
+						if (C[c_id].is_zero)
 						{
-							if (C[c_id].is_zero)
-							{
-								C[c_id].is_zero = false;
-								s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
-							}
-
-							s_mma(blk_m[i], blk_n[j], blk_k[u], alpha, A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
+							C[c_id].is_zero = false;
+							s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
 						}
+
+						s_mma(blk_m[i], blk_n[j], blk_k[u], alpha, A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
 					}
 				}
-			}
+			});
 		}
 		auto inline s_blk_mma(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, const BlockData &A, const BlockData &B, BlockData &C)noexcept->void
 		{
@@ -213,50 +225,48 @@ namespace aris
 		template <typename AType, typename BType, typename CType>
 		auto inline s_blk_mm(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, const BlockData &A, AType a_t, const BlockData &B, BType b_t, BlockData &C, CType c_t)noexcept->void
 		{
-			for (Size i(-1), a_row{ 0 }, c_row{ 0 }; ++i < blk_m.size(); a_row = next_rid(a_row, a_t), c_row = next_rid(c_row, c_t))
+			// C 的各个块互相独立，按块分配到各线程 //
+			s_blk_parallel_for(blk_m.size() * blk_n.size(), [&](Size tile)
 			{
-				for (Size j(-1), b_col{ 0 }, c_id{ c_row }; ++j < blk_n.size(); b_col = next_cid(b_col, b_t), c_id = next_cid(c_id, c_t))
+				const Size i{ tile / blk_n.size() }, j{ tile % blk_n.size() }, c_id{ id(i, j, c_t) };
+				C[c_id].is_zero = true;
+				for (Size u(-1), a_id{ id(i, 0, a_t) }, b_id{ id(0, j, b_t) }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
 				{
-					C[c_id].is_zero = true;
-					for (Size u(-1), a_id{ a_row }, b_id{ b_col }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
+					if (!(A[a_id].is_zero || B[b_id].is_zero))
 					{
-						if (!(A[a_id].is_zero || B[b_id].is_zero))
+						if (C[c_id].is_zero)
 						{
-							if (C[c_id].is_zero)
-							{
-								C[c_id].is_zero = false;
-								s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
-							}
-							
-							s_mma(blk_m[i], blk_n[j], blk_k[u], A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
+							C[c_id].is_zero = false;
+							s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
 						}
+						
+						s_mma(blk_m[i], blk_n[j], blk_k[u], A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
 					}
 				}
-			}
+			});
 		}
 		template <typename AType, typename BType, typename CType>
 		auto inline s_blk_mm(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, double alpha, const BlockData &A, AType a_t, const BlockData &B, BType b_t, BlockData &C, CType c_t)noexcept->void
 		{
-			for (Size i(-1), a_row{ 0 }, c_row{ 0 }; ++i < blk_m.size(); a_row = next_rid(a_row, a_t), c_row = next_rid(c_row, c_t))
+			// C 的各个块互相独立，按块分配到各线程 //
+			s_blk_parallel_for(blk_m.size() * blk_n.size(), [&](Size tile)
 			{
-				for (Size j(-1), b_col{ 0 }, c_id{ c_row }; ++j < blk_n.size(); b_col = next_cid(b_col, b_t), c_id = next_cid(c_id, c_t))
+				const Size i{ tile / blk_n.size() }, j{ tile % blk_n.size() }, c_id{ id(i, j, c_t) };
+				C[c_id].is_zero = true;
+				for (Size u(-1), a_id{ id(i, 0, a_t) }, b_id{ id(0, j, b_t) }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
 				{
-					C[c_id].is_zero = true;
-					for (Size u(-1), a_id{ a_row }, b_id{ b_col }; ++u < blk_k.size(); a_id = next_cid(a_id, a_t), b_id = next_rid(b_id, b_t))
+					if (!(A[a_id].is_zero || B[b_id].is_zero))
 					{
-						if (!(A[a_id].is_zero || B[b_id].is_zero))
+						if (C[c_id].is_zero)
 						{
-							if (C[c_id].is_zero)
-							{
-								C[c_id].is_zero = false;
-								s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
-							}
-
-							s_mma(blk_m[i], blk_n[j], blk_k[u], alpha, A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
+							C[c_id].is_zero = false;
+							s_fill(blk_m[i], blk_n[j], 0.0, C[c_id].data, c_t.block_stride);
 						}
+
+						s_mma(blk_m[i], blk_n[j], blk_k[u], alpha, A[a_id].data, a_t.block_stride, B[b_id].data, b_t.block_stride, C[c_id].data, c_t.block_stride);
 					}
 				}
-			}
+			});
 		}
 		auto inline s_blk_mm(const BlockSize &blk_m, const BlockSize &blk_n, const BlockSize &blk_k, const BlockData &A, const BlockData &B, BlockData &C)noexcept->void
 		{
@@ -286,8 +296,10 @@ namespace aris
 
 				s_llt(blk_m[j], blk_llt[l_jj].data, l_t.block_stride, blk_llt[l_jj].data, l_t.block_stride);
 
-				for (Size i(j), l_i0{ next_rid(l_j0,l_t) }, l_ji{ next_cid(l_jj, l_t) }, l_ij{ next_rid(l_jj, l_t) }, a_ij{ next_rid(a_jj,a_t) }; ++i < blk_m.size(); l_i0 = next_rid(l_i0, l_t), l_ji = next_cid(l_ji, l_t), l_ij = next_rid(l_ij, l_t), a_ij = next_rid(a_ij, a_t))
+				// 对角块求出后，第 j 列下方的各块只依赖于前 j 列的结果，互相独立，可以并行求解 //
+				s_blk_parallel_for(blk_m.size() - j - 1, [&](Size t)
 				{
+					const Size i{ j + 1 + t }, l_i0{ id(i, 0, l_t) }, l_ji{ id(j, i, l_t) }, l_ij{ id(i, j, l_t) }, a_ij{ id(i, j, a_t) };
 					blk_llt[l_ij].is_zero = blk_A[a_ij].is_zero;
 					s_mc(blk_m[i], blk_m[j], blk_A[a_ij].data, a_t.block_stride, blk_llt[l_ij].data, l_t.block_stride);
 
@@ -312,7 +324,7 @@ namespace aris
 						s_sov_lm(blk_m[j], blk_m[i], blk_llt[l_jj].data, l_t.block_stride, blk_llt[l_ij].data, T(l_t.block_stride), blk_llt[l_ji].data, l_t.block_stride);
 						s_mc(blk_m[j], blk_m[i], blk_llt[l_ji].data, l_t.block_stride, blk_llt[l_ij].data, T(l_t.block_stride));
 					}
-				}
+				});
 			}
 		}
 		template <typename LltType, typename BType, typename XType>
@@ -331,6 +331,72 @@ namespace aris
 		}
 		auto inline s_mm(Size m, Size n, Size k, const double* A, const double* B, double *C) noexcept->void { s_fill(m, n, 0, C); s_mma(m, n, k, A, B, C); }
 		auto inline s_mm(Size m, Size n, Size k, double alpha, const double* A, const double* B, double *C) noexcept->void { s_mm(m, n, k, A, B, C); s_nm(m, n, alpha, C); }
+
+		// 编译期定长版本，形如 s_mm<6, 1, 6>(A, a_t, B, b_t, C, c_t)，循环上限为常量，编译器可完全展开并向量化 //
+		template<Size M, Size N, Size K, typename AType, typename BType, typename CType>
+		auto inline s_mma(const double* A, AType a_t, const double* B, BType b_t, double *C, CType c_t) noexcept->void
+		{
+			for (Size i(-1), ai0{ 0 }, ci0{ 0 }; ++i < M; ai0 = next_rid(ai0, a_t), ci0 = next_rid(ci0, c_t))
+			{
+				for (Size j(-1), b0j{ 0 }, cij{ ci0 }; ++j < N; b0j = next_cid(b0j, b_t), cij = next_cid(cij, c_t))
+				{
+					double value{ C[cij] };
+					for (Size u(-1), aiu{ ai0 }, buj{ b0j }; ++u < K; aiu = next_cid(aiu, a_t), buj = next_rid(buj, b_t))
+						value += A[aiu] * B[buj];
+					C[cij] = value;
+				}
+			}
+		}
+		template<Size M, Size N, Size K, typename AType, typename BType, typename CType>
+		auto inline s_mma(double alpha, const double* A, AType a_t, const double* B, BType b_t, double *C, CType c_t) noexcept->void
+		{
+			for (Size i(-1), ai0{ 0 }, ci0{ 0 }; ++i < M; ai0 = next_rid(ai0, a_t), ci0 = next_rid(ci0, c_t))
+			{
+				for (Size j(-1), b0j{ 0 }, cij{ ci0 }; ++j < N; b0j = next_cid(b0j, b_t), cij = next_cid(cij, c_t))
+				{
+					double value{ 0 };
+					for (Size u(-1), aiu{ ai0 }, buj{ b0j }; ++u < K; aiu = next_cid(aiu, a_t), buj = next_rid(buj, b_t))
+						value += A[aiu] * B[buj];
+					C[cij] += alpha*value;
+				}
+			}
+		}
+		template<Size M, Size N, Size K>
+		auto inline s_mma(const double* A, const double* B, double *C) noexcept->void { s_mma<M, N, K>(A, K, B, N, C, N); }
+		template<Size M, Size N, Size K>
+		auto inline s_mma(double alpha, const double* A, const double* B, double *C) noexcept->void { s_mma<M, N, K>(alpha, A, K, B, N, C, N); }
+		template<Size M, Size N, Size K, typename AType, typename BType, typename CType>
+		auto inline s_mm(const double* A, AType a_t, const double* B, BType b_t, double *C, CType c_t) noexcept->void
+		{
+			for (Size i(-1), ai0{ 0 }, ci0{ 0 }; ++i < M; ai0 = next_rid(ai0, a_t), ci0 = next_rid(ci0, c_t))
+			{
+				for (Size j(-1), b0j{ 0 }, cij{ ci0 }; ++j < N; b0j = next_cid(b0j, b_t), cij = next_cid(cij, c_t))
+				{
+					double value{ 0 };
+					for (Size u(-1), aiu{ ai0 }, buj{ b0j }; ++u < K; aiu = next_cid(aiu, a_t), buj = next_rid(buj, b_t))
+						value += A[aiu] * B[buj];
+					C[cij] = value;
+				}
+			}
+		}
+		template<Size M, Size N, Size K, typename AType, typename BType, typename CType>
+		auto inline s_mm(double alpha, const double* A, AType a_t, const double* B, BType b_t, double *C, CType c_t) noexcept->void
+		{
+			for (Size i(-1), ai0{ 0 }, ci0{ 0 }; ++i < M; ai0 = next_rid(ai0, a_t), ci0 = next_rid(ci0, c_t))
+			{
+				for (Size j(-1), b0j{ 0 }, cij{ ci0 }; ++j < N; b0j = next_cid(b0j, b_t), cij = next_cid(cij, c_t))
+				{
+					double value{ 0 };
+					for (Size u(-1), aiu{ ai0 }, buj{ b0j }; ++u < K; aiu = next_cid(aiu, a_t), buj = next_rid(buj, b_t))
+						value += A[aiu] * B[buj];
+					C[cij] = alpha*value;
+				}
+			}
+		}
+		template<Size M, Size N, Size K>
+		auto inline s_mm(const double* A, const double* B, double *C) noexcept->void { s_mm<M, N, K>(A, K, B, N, C, N); }
+		template<Size M, Size N, Size K>
+		auto inline s_mm(double alpha, const double* A, const double* B, double *C) noexcept->void { s_mm<M, N, K>(alpha, A, K, B, N, C, N); }
 		template<typename AType, typename BType, typename CType>
 		auto inline s_mmi(Size m, Size n, Size k, const double* A, AType a_t, const double* B, BType b_t, double *C, CType c_t) noexcept->void
 		{
@@ -407,6 +473,11 @@ namespace aris
 			}
 		}
 		auto inline s_llt(Size m, const double *A, double *L) noexcept->void { s_llt(m, A, m, L, m); };
+		// 编译期定长版本，只是将尺寸作为常量传给上面的实现，内联后由编译器展开 //
+		template<Size M, typename AType, typename LType>
+		auto inline s_llt(const double *A, AType a_t, double *L, LType l_t) noexcept->void { s_llt(M, A, a_t, L, l_t); }
+		template<Size M>
+		auto inline s_llt(const double *A, double *L) noexcept->void { s_llt<M>(A, M, L, M); };
 		// L can be the same as inv_L, only when they have same type
 		template<typename LType, typename InvLType>
 		auto inline s_inv_lm(Size m, const double *L, LType l_t, double *inv_L, InvLType inv_l_t) noexcept->void
@@ -509,6 +580,11 @@ namespace aris
 			}
 		}
 		auto inline s_householder_ut(Size m, Size n, const double *A, double *U, double *tau, double zero_check = 1e-10)noexcept->void { s_householder_ut(m, n, A, n, U, n, tau, 1, zero_check); }
+		// 编译期定长版本，只是将尺寸作为常量传给上面的实现，内联后由编译器展开 //
+		template<Size M, Size N, typename AType, typename UType, typename TauType>
+		auto inline s_householder_ut(const double *A, AType a_t, double *U, UType u_t, double *tau, TauType tau_t, double zero_check = 1e-10)noexcept->void { s_householder_ut(M, N, A, a_t, U, u_t, tau, tau_t, zero_check); }
+		template<Size M, Size N>
+		auto inline s_householder_ut(const double *A, double *U, double *tau, double zero_check = 1e-10)noexcept->void { s_householder_ut<M, N>(A, N, U, N, tau, 1, zero_check); }
 		// U can be the same as R
 		template<typename UType, typename TauType, typename QType, typename RType>
 		auto inline s_householder_ut2qr(Size m, Size n, const double *U, UType u_t, const double *tau, TauType tau_t, double *Q, QType q_t, double *R, RType r_t)noexcept->void
@@ -207,6 +207,8 @@ namespace aris
 			registerType<UniversalSolver>();
 			registerType<ForwardKinematicSolver>();
 			registerType<InverseKinematicSolver>();
+			registerType<StewartInverseKinematicSolver>();
+			registerType<ScaraInverseKinematicSolver>();
 			registerType<ForwardDynamicSolver>();
 			registerType<InverseDynamicSolver>();
 
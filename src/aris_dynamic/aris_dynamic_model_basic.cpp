@@ -29,6 +29,7 @@ namespace aris
 			try
 			{
 				mat = this->model().calculator().calculateExpression(xml_ele.Attribute(attribute_name.c_str()));
+				if (snapshotRecording()) recordSnapshotValue(xml_ele, attribute_name.c_str(), mat.toString());
 			}
 			catch (std::exception &e)
 			{
@@ -91,6 +92,7 @@ namespace aris
 		auto MatrixVariable::loadXml(const aris::core::XmlElement &xml_ele)->void
 		{
 			data() = model().calculator().calculateExpression(xml_ele.GetText());
+			if (snapshotRecording()) recordSnapshotValue(xml_ele, nullptr, data().toString());
 			Variable::loadXml(xml_ele);
 			model().calculator().addVariable(name(), data());
 		}
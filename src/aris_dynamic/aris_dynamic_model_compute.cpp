@@ -9,6 +9,10 @@
 #include <regex>
 #include <limits>
 #include <type_traits>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
 
 #include "aris_dynamic_model.h"
 
@@ -21,8 +25,21 @@ namespace aris
 		{
 			Size max_iter_count_, iter_count_;
 			double max_error_, error_;
+			std::vector<std::unique_ptr<Model>> batch_models_;// kinPosBatch使用的模型副本，拷贝时不复制
+			std::string batch_xml_;// 建立副本时模型的xml
 
 			Imp(Size max_iter_count, double max_error) :max_iter_count_(max_iter_count), max_error_(max_error) {};
+			Imp(const Imp &other) :max_iter_count_(other.max_iter_count_), iter_count_(other.iter_count_), max_error_(other.max_error_), error_(other.error_) {}
+			auto operator=(const Imp &other)->Imp&
+			{
+				max_iter_count_ = other.max_iter_count_;
+				iter_count_ = other.iter_count_;
+				max_error_ = other.max_error_;
+				error_ = other.error_;
+				batch_models_.clear();
+				batch_xml_.clear();
+				return *this;
+			}
 		};
 		auto Solver::saveXml(aris::core::XmlElement &xml_ele) const->void
 		{
@@ -41,6 +58,99 @@ namespace aris
 		{
 			allocateMemory();
 		}
+		auto Solver::kinPosBatch(Size n, const double *input, double *output, bool *success, Size thread_count)->Size
+		{
+			// 末端激活而驱动未激活时为反解：输入末端位姿，输出驱动位置；否则为正解 //
+			bool is_inverse = std::any_of(model().generalMotionPool().begin(), model().generalMotionPool().end(), [](const GeneralMotion &gm) {return gm.active(); })
+				&& std::none_of(model().motionPool().begin(), model().motionPool().end(), [](const Motion &m) {return m.active(); });
+			const Size mot_size = model().motionPool().size(), gm_size = model().generalMotionPool().size();
+
+			if (thread_count == 0)thread_count = std::max<Size>(std::thread::hardware_concurrency(), 1);
+			thread_count = std::max<Size>(std::min(thread_count, n), 1);
+
+			// 模型副本通过xml复制，模型的任何参数（marker位置、标定参数、杆件位姿等）改变后xml不同，副本全部重建 //
+			auto &clones = imp_->batch_models_;
+			const std::string xml_str = model().xmlString();
+			if (xml_str != imp_->batch_xml_)
+			{
+				clones.clear();
+				imp_->batch_xml_ = xml_str;
+			}
+			if (clones.size() < thread_count)
+			{
+				while (clones.size() < thread_count)
+				{
+					std::unique_ptr<Model> m(new Model);
+					m->loadXmlStr(xml_str);
+					auto &s = m->solverPool().at(id());
+					if (auto us = dynamic_cast<UniversalSolver*>(&s))us->setPredictorOrder(0);
+					s.allocateMemory();
+					clones.push_back(std::move(m));
+				}
+			}
+
+			// 所有样本都从调用时模型的当前位姿出发，结果与线程数无关 //
+			const Size part_size = model().partPool().size();
+			std::vector<double> seed(part_size * 16);
+			for (Size i = 0; i < part_size; ++i)model().partPool().at(i).getPm(seed.data() + i * 16);
+			for (auto &m : clones)
+			{
+				for (Size j = 0; j < mot_size; ++j)m->motionPool().at(j).activate(model().motionPool().at(j).active());
+				for (Size j = 0; j < gm_size; ++j)m->generalMotionPool().at(j).activate(model().generalMotionPool().at(j).active());
+			}
+
+			std::atomic<Size> success_count{ 0 };
+			std::exception_ptr exception;
+			std::mutex exception_mutex;
+
+			// 第t个任务独占第t个副本，求解一段连续的样本；输入输出均为SoA，分量j的第i个样本位于[j*n + i] //
+			auto work = [&](Size t)
+			{
+				try
+				{
+					auto &m = *clones[t];
+					auto &s = m.solverPool().at(id());
+					double pm[16];
+
+					for (Size i = n * t / thread_count; i < n * (t + 1) / thread_count; ++i)
+					{
+						for (Size j = 0; j < part_size; ++j)m.partPool().at(j).setPm(seed.data() + j * 16);
+
+						if (is_inverse) for (Size j = 0; j < gm_size; ++j)
+						{
+							for (Size k = 0; k < 16; ++k)pm[k] = input[(j * 16 + k) * n + i];
+							m.generalMotionPool().at(j).setMpm(pm);
+						}
+						else for (Size j = 0; j < mot_size; ++j)m.motionPool().at(j).setMp(input[j * n + i]);
+
+						auto ret = s.kinPos();
+						if (success)success[i] = ret;
+						if (ret)++success_count;
+
+						if (is_inverse) for (Size j = 0; j < mot_size; ++j)output[j * n + i] = m.motionPool().at(j).mp();
+						else for (Size j = 0; j < gm_size; ++j)
+						{
+							m.generalMotionPool().at(j).updMpm();
+							m.generalMotionPool().at(j).getMpm(pm);
+							for (Size k = 0; k < 16; ++k)output[(j * 16 + k) * n + i] = pm[k];
+						}
+					}
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lck(exception_mutex);
+					if (!exception)exception = std::current_exception();
+				}
+			};
+
+			// 使用临时的线程池，不改变全局分块计算线程池的线程数，实时线程中的分块计算仍为串行 //
+			if (thread_count > 1)s_blk_parallel_run(thread_count, thread_count, std::function<void(Size)>(work));
+			else for (Size t = 0; t < thread_count; ++t)work(t);
+
+			if (exception)std::rethrow_exception(exception);
+			return success_count;
+		}
+		auto Solver::clearBatchModels()->void { imp_->batch_models_.clear(); imp_->batch_xml_.clear(); }
 		auto Solver::error()const->double { return imp_->error_; }
 		auto Solver::setError(double error)->void { imp_->error_ = error; }
 		auto Solver::maxError()const->double { return imp_->max_error_; }
@@ -70,7 +180,7 @@ namespace aris
 			Element::saveXml(xml_ele);
 
 			std::stringstream ss;
-			ss << std::setprecision(15);
+			ss << std::setprecision(std::numeric_limits<double>::max_digits10);
 			ss.str().reserve((25 * 1 + 1)*imp_->time_.size());
 
 			for (auto &t : imp_->time_)ss << t << std::endl;
@@ -109,7 +219,7 @@ namespace aris
 
 			xml_ele.SetAttribute("part", part().name().c_str());
 			std::stringstream ss;
-			ss << std::setprecision(15);
+			ss << std::setprecision(std::numeric_limits<double>::max_digits10);
 			ss.str().reserve((25 * 18 + 1)*imp_->pe_.size());
 
 			for (auto pe = imp_->pe_.begin(), vs = imp_->vs_.begin(), as = imp_->as_.begin(); pe < imp_->pe_.end(); ++pe, ++vs, ++as)
@@ -190,7 +300,7 @@ namespace aris
 			xml_ele.SetAttribute("constraint", constraint().name().c_str());
 
 			std::stringstream ss;
-			ss << std::setprecision(15);
+			ss << std::setprecision(std::numeric_limits<double>::max_digits10);
 			ss.str().reserve((25 * 6 + 1)*imp_->cf_.size());
 			for (auto &cf : imp_->cf_)
 			{
@@ -433,6 +543,7 @@ namespace aris
 				double dm[36], iv[10];
 				double pm1[16], pm2[16];
 				double *pm, *last_pm;
+				double hist_pm[3][16];// 最近3次收敛的位姿，hist_pm[0]为最新，用于预测下一次迭代的初值
 				double xp[6], bc[6], xc[6], bp[6];
 				Size rows;// in F
 				Part *part;
@@ -445,24 +556,35 @@ namespace aris
 			};
 			struct Remainder
 			{
-				struct Block { Diag* diag; bool is_I; };
+				struct Block { Diag* diag; bool is_I; Size f_blk_row; };
 
 				Diag *i_diag, *j_diag;
+				Size f_blk, f_blk_col;// 所属的FBlock及在其中的起始列
 				double cmI[36], cmJ[36];
 				double xp[6], bc[6], xc[6], bp[6];
 				std::vector<Block> cm_blk_series;
 				Relation rel_;
 			};
+			// F矩阵中相互独立的稠密块，在allocateMemory时根据cm_blk_series确定，迭代中不变 //
+			struct FBlock
+			{
+				std::vector<Size> rows;// 在F中的行
+				std::vector<Size> cols;// 在F中的列
+				Size pos;// 在FB中的起始位置
+			};
+			static const Size NO_F_BLK = Size(-1);
 
 			struct SubSystem
 			{
 				std::vector<Diag> diag_pool_;
 				std::vector<Remainder> remainder_pool_;
+				std::vector<FBlock> f_blk_pool_;
 
 				Size fm, fn, fr;
 
 				double *F, *FU, *FT;
 				Size* FP;
+				double *FB, *bcfb, *xpfb;
 				double *G, *GU, *GT;
 				Size *GP;
 
@@ -474,6 +596,7 @@ namespace aris
 				double *alpha;
 
 				bool has_ground_;
+				bool block_qr_{ true };
 
 				double max_error_;
 				double error_;
@@ -505,6 +628,7 @@ namespace aris
 				}
 
 				auto hasGround()->bool { return has_ground_; }
+				auto makeFBlkPool()->void;
 				auto rowAddInverseXp()->void;
 				auto rowAddBp()->void;
 				auto updDiagDm()->void;
@@ -515,6 +639,7 @@ namespace aris
 				auto updPfToBp()->void;
 				auto updRemainderCm()->void;
 				auto updF()->void;
+				auto updFDense()->void;
 				auto updXpf()->void;
 				auto updBcf()->void;
 				auto updXcf()->void;
@@ -535,6 +660,7 @@ namespace aris
 
 			std::vector<double> F_, FU_, FT_;
 			std::vector<Size> FP_;
+			std::vector<double> FB_, bcfb_, xpfb_;
 			std::vector<double> S_;
 			std::vector<double> G_, GU_, GT_;
 			std::vector<Size> GP_;
@@ -546,6 +672,51 @@ namespace aris
 
 			std::vector<double> general_jacobi_;
 
+			// 预测器，0表示关闭，1为线性外推，2为二次外推 //
+			Size predictor_order_{ 0 }, hist_count_{ 0 };
+			bool block_qr_{ true };
+			Size kin_pos_count_{ 0 }, total_iter_count_{ 0 }, peak_iter_count_{ 0 };
+
+			auto predict()->void
+			{
+				for (auto &sys : subsys_pool_)
+				{
+					for (auto &d : sys.diag_pool_)
+					{
+						// 在李代数上做差分：xi1 = log(pm0 * inv(pm1)), xi2 = log(pm1 * inv(pm2)) //
+						double dpm[16], xi1[6], xi[6];
+						s_pm_dot_inv_pm(d.hist_pm[0], d.hist_pm[1], dpm);
+						s_pm2ps(dpm, xi1);
+						s_vc(6, xi1, xi);
+
+						if (predictor_order_ > 1 && hist_count_ > 2)
+						{
+							double xi2[6];
+							s_pm_dot_inv_pm(d.hist_pm[1], d.hist_pm[2], dpm);
+							s_pm2ps(dpm, xi2);
+							s_va(6, xi1, xi);
+							s_vs(6, xi2, xi);
+						}
+
+						s_ps2pm(xi, dpm);
+						s_pm_dot_pm(dpm, d.hist_pm[0], d.pm);
+					}
+				}
+			}
+			auto record()->void
+			{
+				for (auto &sys : subsys_pool_)
+				{
+					for (auto &d : sys.diag_pool_)
+					{
+						s_vc(16, d.hist_pm[1], d.hist_pm[2]);
+						s_vc(16, d.hist_pm[0], d.hist_pm[1]);
+						s_vc(16, d.pm, d.hist_pm[0]);
+					}
+				}
+				hist_count_ = std::min(hist_count_ + 1, Size(3));
+			}
+
 			static auto one_constraint_upd_d(Diag *d)->void
 			{
 				double makI_pm[16], makJ_pm[16];
@@ -601,7 +772,7 @@ namespace aris
 				s_fill(6, 6, 0.0, tem);
 				s_fill(6, 1, 1.0, tem, 7);
 				s_inv_um(d->rel_.dim, R, d->rel_.dim, tem, 6);
-				s_mm(6, 6, 6, tem, 6, Q, dynamic::ColMajor{ 6 }, d->dm, 6);
+				s_mm<6, 6, 6>(tem, 6, Q, dynamic::ColMajor{ 6 }, d->dm, 6);
 			}
 		};
 		auto UniversalSolver::Imp::SubSystem::rowAddInverseXp()->void { for (auto d = diag_pool_.begin() + 1; d<diag_pool_.end(); ++d)s_va(6, d->rd->xp, d->xp); }
@@ -613,6 +784,27 @@ namespace aris
 			for (auto d = diag_pool_.begin() + 1; d < diag_pool_.end(); ++d)s_iv2iv(*d->part->pm(), d->part->prtIv(), d->iv);
 		}
 		auto UniversalSolver::Imp::SubSystem::updF()->void
+		{
+			// 分块求解时只更新各块，不再填充整个稠密的F //
+			if (block_qr_)
+			{
+				for (auto &blk : f_blk_pool_)s_fill(blk.rows.size(), blk.cols.size(), 0.0, FB + blk.pos);
+				for (auto &r : remainder_pool_)
+				{
+					auto &blk = f_blk_pool_[r.f_blk];
+					const Size n = blk.cols.size();
+					for (auto &b : r.cm_blk_series)
+					{
+						if (b.f_blk_row == NO_F_BLK)continue;
+						s_mm(6 - b.diag->rel_.dim, r.rel_.dim, 6, b.diag->dm + dynamic::id(b.diag->rel_.dim, 0, 6), 6, b.is_I ? r.cmI : r.cmJ, r.rel_.dim, FB + blk.pos + dynamic::id(b.f_blk_row, r.f_blk_col, n), n);
+					}
+				}
+				return;
+			}
+
+			updFDense();
+		}
+		auto UniversalSolver::Imp::SubSystem::updFDense()->void
 		{
 			s_fill(fm, fn, 0.0, F);
 			
@@ -626,10 +818,84 @@ namespace aris
 				cols += r.rel_.dim;
 			}
 		}
+		auto UniversalSolver::Imp::SubSystem::makeFBlkPool()->void
+		{
+			// 以remainder为节点，在F中共享任意一行的remainder属于同一个块 //
+			std::vector<Size> rem_root(remainder_pool_.size());
+			for (Size i = 0; i < rem_root.size(); ++i)rem_root[i] = i;
+			auto root = [&rem_root](Size i)->Size { while (rem_root[i] != i)i = rem_root[i] = rem_root[rem_root[i]]; return i; };
+
+			std::vector<Size> row_owner(fm, NO_F_BLK);
+			for (Size i = 0; i < remainder_pool_.size(); ++i)
+			{
+				for (auto &b : remainder_pool_[i].cm_blk_series)
+				{
+					for (Size row = b.diag->rows; row < std::min(b.diag->rows + 6 - b.diag->rel_.dim, fm); ++row)
+					{
+						if (row_owner[row] == NO_F_BLK) row_owner[row] = i;
+						else rem_root[root(row_owner[row])] = root(i);
+					}
+				}
+			}
+
+			// 生成块，块内行列保持在F中的顺序；没有被任何remainder引用的行在F中恒为0，不属于任何块 //
+			f_blk_pool_.clear();
+			std::vector<Size> blk_id(remainder_pool_.size(), NO_F_BLK);
+			for (Size i = 0, cols = 0; i < remainder_pool_.size(); cols += remainder_pool_[i].rel_.dim, ++i)
+			{
+				if (blk_id[root(i)] == NO_F_BLK)
+				{
+					blk_id[root(i)] = f_blk_pool_.size();
+					f_blk_pool_.push_back(FBlock());
+				}
+				auto &blk = f_blk_pool_[blk_id[root(i)]];
+				remainder_pool_[i].f_blk = blk_id[root(i)];
+				remainder_pool_[i].f_blk_col = blk.cols.size();
+				for (Size j = 0; j < remainder_pool_[i].rel_.dim; ++j)blk.cols.push_back(cols + j);
+			}
+			for (Size row = 0; row < fm; ++row)if (row_owner[row] != NO_F_BLK)f_blk_pool_[blk_id[root(row_owner[row])]].rows.push_back(row);
+
+			// 各块在FB中连续存放，并记录每个cm块在所属FBlock中的起始行 //
+			Size pos{ 0 };
+			for (auto &blk : f_blk_pool_)
+			{
+				blk.pos = pos;
+				pos += blk.rows.size() * blk.cols.size();
+			}
+			for (auto &r : remainder_pool_)
+			{
+				auto &rows = f_blk_pool_[r.f_blk].rows;
+				for (auto &b : r.cm_blk_series)
+				{
+					auto found = std::lower_bound(rows.begin(), rows.end(), b.diag->rows);
+					b.f_blk_row = b.diag->rows < fm && found != rows.end() && *found == b.diag->rows ? Size(found - rows.begin()) : NO_F_BLK;
+				}
+			}
+		}
 		auto UniversalSolver::Imp::SubSystem::updXpf()->void
 		{
-			s_householder_utp(fn, fm, F, ColMajor{ fn }, FU, ColMajor{ fn }, FT, 1, FP, fr, max_error_);
-			s_householder_utp_sov(fn, fm, 1, fr, FU, ColMajor{ fn }, FT, 1, FP, bcf, 1, xpf, 1, max_error_);
+			if (!block_qr_)
+			{
+				s_householder_utp(fn, fm, F, ColMajor{ fn }, FU, ColMajor{ fn }, FT, 1, FP, fr, max_error_);
+				s_householder_utp_sov(fn, fm, 1, fr, FU, ColMajor{ fn }, FT, 1, FP, bcf, 1, xpf, 1, max_error_);
+				return;
+			}
+
+			// 各块互不耦合，分别求解 FB^T * xpfb = bcfb //
+			s_fill(fm, 1, 0.0, xpf);
+			fr = 0;
+			for (auto &blk : f_blk_pool_)
+			{
+				const Size m = blk.rows.size(), n = blk.cols.size();
+				for (Size j = 0; j < n; ++j)bcfb[j] = bcf[blk.cols[j]];
+
+				Size rank;
+				s_householder_utp(n, m, FB + blk.pos, ColMajor{ n }, FU, ColMajor{ n }, FT, 1, FP, rank, max_error_);
+				s_householder_utp_sov(n, m, 1, rank, FU, ColMajor{ n }, FT, 1, FP, bcfb, 1, xpfb, 1, max_error_);
+
+				for (Size i = 0; i < m; ++i)xpf[blk.rows[i]] = xpfb[i];
+				fr += rank;
+			}
 		}
 		auto UniversalSolver::Imp::SubSystem::updXcf()->void
 		{
@@ -643,7 +909,7 @@ namespace aris
 			{
 				double tem[6];
 
-				s_mm(6, 1, 6, d->dm, 6, d->bp, 1, tem, 1);
+				s_mm<6, 1, 6>(d->dm, 6, d->bp, 1, tem, 1);
 
 				s_vc(6, tem, d->bp);
 				s_vc(6 - d->rel_.dim, d->bp + d->rel_.dim, bpf + d->rows);
@@ -678,7 +944,7 @@ namespace aris
 				s_vc(d->rel_.dim, d->bc, tem);
 				s_vc(6 - d->rel_.dim, xpf + d->rows, tem + d->rel_.dim);
 
-				s_mm(6, 1, 6, d->dm, ColMajor{ 6 }, tem, 1, d->xp, 1);
+				s_mm<6, 1, 6>(d->dm, ColMajor{ 6 }, tem, 1, d->xp, 1);
 			}
 		}
 		auto UniversalSolver::Imp::SubSystem::updXc()->void
@@ -694,7 +960,7 @@ namespace aris
 				{
 					double tem[6];
 					s_mm(6, 1, r.rel_.dim, b.is_I ? r.cmJ : r.cmI, xcf + cols, tem);
-					s_mma(6, 1, 6, b.diag->dm, 6, tem, 1, b.diag->bp, 1);
+					s_mma<6, 1, 6>(b.diag->dm, 6, tem, 1, b.diag->bp, 1);
 				}
 
 				cols += r.rel_.dim;
@@ -967,7 +1233,7 @@ namespace aris
 			updRemainderCm();
 
 			// make and solve remainder equation
-			updF();
+			updFDense();
 			updBcf();
 
 			//////////////////////////////////////////// 求CT * xp = bc 的通解和特解 //////////////////////////////
@@ -1025,7 +1291,7 @@ namespace aris
 					//////////////////////// 可以优化 //////////////////
 					double tem[6]{ 0,0,0,0,0,0 };
 					s_vc(6 - d->rel_.dim, S + dynamic::id(d->rows, j, m_mimus_r), m_mimus_r, tem + d->rel_.dim, 1);
-					s_mm(6, 1, 6, d->dm, ColMajor{ 6 }, tem, 1, d->xp, 1);
+					s_mm<6, 1, 6>(d->dm, ColMajor{ 6 }, tem, 1, d->xp, 1);
 				}
 
 				// 乘以PT
@@ -1043,7 +1309,7 @@ namespace aris
 				{
 					/////////// 可以优化
 					double tem[6];
-					s_mm(6, 1, 6, d->dm, 6, d->bp, 1, tem, 1);
+					s_mm<6, 1, 6>(d->dm, 6, d->bp, 1, tem, 1);
 					s_mc(6 - d->rel_.dim, 1, tem + d->rel_.dim, 1, G + dynamic::id(d->rows, j, m_mimus_r), m_mimus_r);
 				}
 				if (!hasGround())s_vc(6, diag_pool_.begin()->bp, 1, G + dynamic::id(diag_pool_.begin()->rows, j, m_mimus_r), m_mimus_r);
@@ -1312,6 +1578,9 @@ namespace aris
 
 				max_fm = std::max(sys.fm, max_fm);
 				max_fn = std::max(sys.fn, max_fn);
+
+				// F的非零结构在此后不再改变，预先划分为独立的块 //
+				sys.makeFBlkPool();
 			}
 
 			// 分配计算所需内存 //
@@ -1323,6 +1592,12 @@ namespace aris
 			imp_->FT_.resize(std::max(max_fm, max_fn), 0.0);
 			imp_->FP_.clear();
 			imp_->FP_.resize(std::max(max_fm, max_fn), 0);
+			imp_->FB_.clear();
+			imp_->FB_.resize(max_fm*max_fn, 0.0);
+			imp_->bcfb_.clear();
+			imp_->bcfb_.resize(std::max(max_fn, max_fm), 0.0);
+			imp_->xpfb_.clear();
+			imp_->xpfb_.resize(std::max(max_fn, max_fm), 0.0);
 			imp_->G_.clear();
 			imp_->G_.resize(max_fm*max_fm, 0.0);
 			imp_->GU_.clear();
@@ -1359,6 +1634,10 @@ namespace aris
 				sys.FU = imp_->FU_.data();
 				sys.FT = imp_->FT_.data();
 				sys.FP = imp_->FP_.data();
+				sys.FB = imp_->FB_.data();
+				sys.block_qr_ = imp_->block_qr_;
+				sys.bcfb = imp_->bcfb_.data();
+				sys.xpfb = imp_->xpfb_.data();
 
 				sys.G = imp_->G_.data();
 				sys.GU = imp_->GU_.data();
@@ -1377,6 +1656,9 @@ namespace aris
 
 			// 分配内存给雅可比 //
 			imp_->general_jacobi_.resize(model().partPool().size() * 6 * (model().motionPool().size() + model().generalMotionPool().size() * 6));
+			
+			// 拓扑改变后，历史解失效 //
+			imp_->hist_count_ = 0;
 		}
 		auto UniversalSolver::kinPos()->bool
 		{
@@ -1386,19 +1668,56 @@ namespace aris
 			double pm[16]{ 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1 };
 			s_mc(4, 4, pm, const_cast<double *>(*model().ground().pm()));
 
+			auto iterate = [this]()
+			{
+				setError(0.0);
+				for (auto &sys : imp_->subsys_pool_)
+				{
+					sys.max_error_ = maxError();
+					sys.max_iter_count_ = maxIterCount();
+					sys.kinPos();
+
+					setIterCount(std::max(iterCount(), sys.iter_count_));
+					setError(std::max(error(), sys.error_));
+				}
+			};
+
 			setIterCount(0);
-			for (auto &sys : imp_->subsys_pool_) 
+			
+			// 用历史解外推初值，若外推后不收敛，则从杆件当前位置重新迭代 //
+			if (imp_->predictor_order_ > 0 && imp_->hist_count_ > 1)
 			{
-				sys.max_error_ = maxError();
-				sys.max_iter_count_ = maxIterCount();
-				sys.kinPos();
+				imp_->predict();
+				iterate();
 
-				setIterCount(std::max(iterCount(), sys.iter_count_));
-				setError(std::max(error(), sys.error_));
+				if (error() >= maxError())
+				{
+					auto predicted_iter_count = iterCount();
+					for (auto &sys : imp_->subsys_pool_)for (auto &d : sys.diag_pool_)d.part->getPm(d.pm);
+					setIterCount(0);
+					iterate();
+					setIterCount(iterCount() + predicted_iter_count);
+				}
+			}
+			else
+			{
+				iterate();
 			}
 
+			++imp_->kin_pos_count_;
+			imp_->total_iter_count_ += iterCount();
+			imp_->peak_iter_count_ = std::max(imp_->peak_iter_count_, iterCount());
+
 			// 迭代成功，设置各杆件 //
-			if (error() < maxError())for (auto &sys : imp_->subsys_pool_)for (auto &d : sys.diag_pool_)d.part->setPm(d.pm);
+			if (error() < maxError())
+			{
+				for (auto &sys : imp_->subsys_pool_)for (auto &d : sys.diag_pool_)d.part->setPm(d.pm);
+				if (imp_->predictor_order_ > 0)imp_->record();
+			}
+			else
+			{
+				imp_->hist_count_ = 0;
+			}
 			return error() < maxError();
 		}
 		auto UniversalSolver::kinVel()->void 
@@ -1715,6 +2034,34 @@ namespace aris
 				std::cout << "------------------------------------------------" << std::endl << std::endl;
 			}
 		}
+		auto UniversalSolver::saveXml(aris::core::XmlElement &xml_ele) const->void
+		{
+			Solver::saveXml(xml_ele);
+			xml_ele.SetAttribute("predictor_order", static_cast<std::int64_t>(imp_->predictor_order_));
+		}
+		auto UniversalSolver::loadXml(const aris::core::XmlElement &xml_ele)->void
+		{
+			imp_->predictor_order_ = attributeInt32(xml_ele, "predictor_order", 0);
+			Solver::loadXml(xml_ele);
+		}
+		auto UniversalSolver::predictorOrder()const->Size { return imp_->predictor_order_; }
+		auto UniversalSolver::setPredictorOrder(Size order)->void { imp_->predictor_order_ = std::min(order, Size(2)); imp_->hist_count_ = 0; }
+		auto UniversalSolver::resetPredictor()->void { imp_->hist_count_ = 0; }
+		auto UniversalSolver::blockQr()const->bool { return imp_->block_qr_; }
+		auto UniversalSolver::setBlockQr(bool use_block_qr)->void
+		{
+			imp_->block_qr_ = use_block_qr;
+			for (auto &sys : imp_->subsys_pool_)sys.block_qr_ = use_block_qr;
+		}
+		auto UniversalSolver::kinPosCount()const->Size { return imp_->kin_pos_count_; }
+		auto UniversalSolver::totalIterCount()const->Size { return imp_->total_iter_count_; }
+		auto UniversalSolver::peakIterCount()const->Size { return imp_->peak_iter_count_; }
+		auto UniversalSolver::resetIterStatistics()->void
+		{
+			imp_->kin_pos_count_ = 0;
+			imp_->total_iter_count_ = 0;
+			imp_->peak_iter_count_ = 0;
+		}
 		UniversalSolver::~UniversalSolver() = default;
 		UniversalSolver::UniversalSolver(const std::string &name, Size max_iter_count, double max_error) :Solver(name, max_iter_count, max_error){}
 		UniversalSolver::UniversalSolver(const UniversalSolver &other) = default;
@@ -1782,6 +2129,466 @@ namespace aris
 		InverseKinematicSolver& InverseKinematicSolver::operator=(const InverseKinematicSolver &other) = default;
 		InverseKinematicSolver& InverseKinematicSolver::operator=(InverseKinematicSolver &&other) = default;
 
+		// 绕过点pnt、方向为单位向量axis的轴线旋转theta角的位姿矩阵 //
+		static auto analyticRotAbout(const double *pnt, const double *axis, double theta, double *pm_out)->void
+		{
+			const double ra[3]{ axis[0] * theta, axis[1] * theta, axis[2] * theta };
+			s_ra2rm(ra, pm_out, 4);
+			for (Size i = 0; i < 3; ++i)pm_out[i * 4 + 3] = pnt[i] - s_vv(3, pm_out + i * 4, pnt);
+			pm_out[12] = 0.0; pm_out[13] = 0.0; pm_out[14] = 0.0; pm_out[15] = 1.0;
+		}
+		// 在两个候选角度中选取与上一次结果最接近的，保证解的连续 //
+		static auto analyticNearestAngle(const double *candidate, double last)->double
+		{
+			auto dist = [last](double a) { a = std::fmod(a - last, 2 * PI); if (a > PI)a -= 2 * PI; if (a < -PI)a += 2 * PI; return a; };
+			const double d0 = dist(candidate[0]), d1 = dist(candidate[1]);
+			return std::abs(d0) < std::abs(d1) ? last + d0 : last + d1;
+		}
+		// 模型中所有激活约束的最大误差，用来判断参考位形是否已经装配好 //
+		static auto analyticConstraintError(const Model &m)->double
+		{
+			double error{ 0.0 };
+			for (auto &jnt : m.jointPool())
+			{
+				if (!jnt.active())continue;
+				double cp[6]{ 0 };
+				jnt.cptCp(cp);
+				error = std::max(error, s_norm(jnt.dim(), cp));
+			}
+			return error;
+		}
+		// 与某个关节使用同一对marker的驱动 //
+		static auto analyticFindMotion(Model &m, const Joint &jnt)->Motion*
+		{
+			for (auto &mot : m.motionPool())if (&mot.makI() == &jnt.makI() && &mot.makJ() == &jnt.makJ())return &mot;
+			return nullptr;
+		}
+		static auto analyticOtherPart(Joint &jnt, const Part &prt)->Part& { return &jnt.makI().fatherPart() == &prt ? jnt.makJ().fatherPart() : jnt.makI().fatherPart(); }
+
+		struct StewartInverseKinematicSolver::Imp
+		{
+			struct Leg
+			{
+				Part *lower, *upper;
+				Motion *mot;
+				Marker *u_ground, *u_part, *s_up;
+
+				// 参考位形 //
+				double lower_pm0[16], upper_pm0[16];
+				double B[3], e1[3], g2[3], w[3], L0;
+
+				// 求解过程量 //
+				double theta2, lower_pm[16], upper_pm[16];
+			};
+
+			std::vector<Leg> legs_;
+			GeneralMotion *gm_{ nullptr };
+			Part *up_{ nullptr };
+			bool topology_matched_{ false }, reference_ok_{ false };
+
+			auto detect(Model &m)->bool
+			{
+				legs_.clear();
+				gm_ = nullptr;
+				up_ = nullptr;
+
+				// 只有一个末端，且末端参考系在地面上 //
+				for (auto &gm : m.generalMotionPool())
+				{
+					if (!gm.active())continue;
+					if (gm_)return false;
+					gm_ = &gm;
+				}
+				if (!gm_ || &gm_->makJ().fatherPart() != &m.ground() || &gm_->makI().fatherPart() == &m.ground())return false;
+				up_ = &gm_->makI().fatherPart();
+
+				auto other_joint = [&](const Part &prt, const Joint &except)->Joint*
+				{
+					Joint *ret{ nullptr };
+					for (auto &jnt : m.jointPool())
+					{
+						if (!jnt.active() || &jnt == &except)continue;
+						if (&jnt.makI().fatherPart() != &prt && &jnt.makJ().fatherPart() != &prt)continue;
+						if (ret)return nullptr;
+						ret = &jnt;
+					}
+					return ret;
+				};
+
+				// 每个驱动必须位于一条 U-P-S 腿的移动副上 //
+				for (auto &mot : m.motionPool())
+				{
+					Joint *p_jnt{ nullptr };
+					for (auto &jnt : m.jointPool())if (jnt.active() && &jnt.makI() == &mot.makI() && &jnt.makJ() == &mot.makJ())p_jnt = &jnt;
+					if (!dynamic_cast<PrismaticJoint*>(p_jnt) || mot.axis() != 2)return false;
+
+					Leg leg;
+					leg.mot = &mot;
+					leg.lower = &p_jnt->makJ().fatherPart();
+					leg.upper = &p_jnt->makI().fatherPart();
+
+					auto jl = other_joint(*leg.lower, *p_jnt), ju = other_joint(*leg.upper, *p_jnt);
+					if (!jl || !ju)return false;
+					if (&analyticOtherPart(*jl, *leg.lower) != &m.ground())
+					{
+						std::swap(leg.lower, leg.upper);
+						std::swap(jl, ju);
+					}
+					if (&analyticOtherPart(*jl, *leg.lower) != &m.ground() || &analyticOtherPart(*ju, *leg.upper) != up_)return false;
+					if (!dynamic_cast<UniversalJoint*>(jl) || !dynamic_cast<SphericalJoint*>(ju))return false;
+
+					leg.u_ground = &jl->makJ().fatherPart() == &m.ground() ? &jl->makJ() : &jl->makI();
+					leg.u_part = &jl->makJ().fatherPart() == &m.ground() ? &jl->makI() : &jl->makJ();
+					leg.s_up = &ju->makI().fatherPart() == up_ ? &ju->makI() : &ju->makJ();
+					leg.theta2 = 0.0;
+					legs_.push_back(leg);
+				}
+				if (legs_.size() != 6)return false;
+
+				// 除腿、地面、动平台以外不能有别的激活杆件与关节 //
+				Size prt_num{ 0 }, jnt_num{ 0 };
+				for (auto &prt : m.partPool())if (prt.active())++prt_num;
+				for (auto &jnt : m.jointPool())if (jnt.active())++jnt_num;
+				return prt_num == 2 + 2 * legs_.size() && jnt_num == 3 * legs_.size();
+			}
+			auto snapshot(const Model &m, double max_error)->bool
+			{
+				if (analyticConstraintError(m) > max_error)return false;
+
+				for (auto &leg : legs_)
+				{
+					leg.lower->getPm(leg.lower_pm0);
+					leg.upper->getPm(leg.upper_pm0);
+
+					const double T[3]{ leg.s_up->pm()[0][3], leg.s_up->pm()[1][3], leg.s_up->pm()[2][3] };
+					s_vc(3, &leg.u_ground->pm()[0][3], 4, leg.B, 1);
+					s_vc(3, &leg.u_ground->pm()[0][2], 4, leg.e1, 1);
+					s_vc(3, &leg.u_part->pm()[0][2], 4, leg.g2, 1);
+
+					s_vc(3, T, leg.w);
+					s_vs(3, leg.B, leg.w);
+					leg.L0 = s_norm(3, leg.w);
+					if (leg.L0 < max_error)return false;
+					s_nv(3, 1.0 / leg.L0, leg.w);
+
+					// U副中心、S副中心必须在移动副轴线上 //
+					double axis[3], d[3], c[3];
+					s_vc(3, &leg.mot->makJ().pm()[0][2], 4, axis, 1);
+					s_vc(3, &leg.mot->makJ().pm()[0][3], 4, d, 1);
+					s_vs(3, leg.B, d);
+					s_c3(axis, leg.w, c);
+					if (s_norm(3, c) > std::sqrt(max_error))return false;
+					s_c3(d, leg.w, c);
+					if (s_norm(3, c) > std::sqrt(max_error))return false;
+
+					leg.theta2 = 0.0;
+				}
+				return true;
+			}
+			auto solve(const double *up_pm)->bool
+			{
+				for (auto &leg : legs_)
+				{
+					// 腿的目标方向与长度 //
+					double d[3];
+					s_pm_dot_v3(up_pm, &leg.s_up->prtPm()[0][3], 4, d, 1);
+					d[0] += up_pm[3] - leg.B[0];
+					d[1] += up_pm[7] - leg.B[1];
+					d[2] += up_pm[11] - leg.B[2];
+					const double L = s_norm(3, d);
+					s_nv(3, 1.0 / L, d);
+
+					// 先绕腿上的U副轴线g2转theta2，使腿与地面轴线e1的夹角正确：A*cos + B*sin = c //
+					double g2xw[3];
+					s_c3(leg.g2, leg.w, g2xw);
+					const double A = s_vv(3, leg.w, leg.e1), B = s_vv(3, g2xw, leg.e1), K = std::sqrt(A*A + B*B);
+					double c = s_vv(3, d, leg.e1);
+					if (K < 1e-12 || std::abs(c) > K * (1 + 1e-12))return false;
+					c = std::max(-K, std::min(K, c));
+
+					double theta[2];
+					s_sov_theta(B, A, c, theta);
+					leg.theta2 = analyticNearestAngle(theta, leg.theta2);
+
+					// 再绕地面上的U副轴线e1转theta1，使腿与目标方向重合 //
+					double rot2[16], v[3], vxd[3];
+					analyticRotAbout(leg.B, leg.g2, leg.theta2, rot2);
+					s_pm_dot_v3(rot2, leg.w, v);
+					s_c3(v, d, vxd);
+					const double theta1 = std::atan2(s_vv(3, vxd, leg.e1), s_vv(3, v, d) - s_vv(3, v, leg.e1) * s_vv(3, d, leg.e1));
+
+					double rot1[16], rot[16];
+					analyticRotAbout(leg.B, leg.e1, theta1, rot1);
+					s_pm_dot_pm(rot1, rot2, rot);
+
+					s_pm_dot_pm(rot, leg.lower_pm0, leg.lower_pm);
+					s_pm_dot_pm(rot, leg.upper_pm0, leg.upper_pm);
+					s_va(3, L - leg.L0, d, 1, leg.upper_pm + 3, 4);
+				}
+				return true;
+			}
+		};
+		auto StewartInverseKinematicSolver::allocateMemory()->void
+		{
+			InverseKinematicSolver::allocateMemory();
+			imp_->topology_matched_ = imp_->detect(model());
+			imp_->reference_ok_ = imp_->topology_matched_ && imp_->snapshot(model(), maxError());
+		}
+		auto StewartInverseKinematicSolver::kinPos()->bool
+		{
+			// 参考位形不可用时，用迭代求解，收敛后的位形作为新的参考位形 //
+			if (!isAnalytic())
+			{
+				auto ret = InverseKinematicSolver::kinPos();
+				if (ret && imp_->topology_matched_)imp_->reference_ok_ = imp_->snapshot(model(), std::max(maxError(), error()));
+				return ret;
+			}
+
+			double tem[16], up_pm[16];
+			s_pm_dot_pm(*imp_->gm_->makJ().pm(), *imp_->gm_->mpm(), tem);
+			s_pm_dot_inv_pm(tem, *imp_->gm_->makI().prtPm(), up_pm);
+
+			setIterCount(0);
+			if (!imp_->solve(up_pm))
+			{
+				setError(std::numeric_limits<double>::infinity());
+				return false;
+			}
+			setError(0.0);
+
+			imp_->up_->setPm(up_pm);
+			for (auto &leg : imp_->legs_)
+			{
+				leg.lower->setPm(leg.lower_pm);
+				leg.upper->setPm(leg.upper_pm);
+				leg.mot->updMp();
+			}
+			return true;
+		}
+		auto StewartInverseKinematicSolver::isAnalytic()const->bool { return imp_->topology_matched_ && imp_->reference_ok_; }
+		StewartInverseKinematicSolver::~StewartInverseKinematicSolver() = default;
+		StewartInverseKinematicSolver::StewartInverseKinematicSolver(const std::string &name, Size max_iter_count, double max_error) :InverseKinematicSolver(name, max_iter_count, max_error) {}
+		StewartInverseKinematicSolver::StewartInverseKinematicSolver(const StewartInverseKinematicSolver &other) = default;
+		StewartInverseKinematicSolver::StewartInverseKinematicSolver(StewartInverseKinematicSolver &&other) = default;
+		StewartInverseKinematicSolver& StewartInverseKinematicSolver::operator=(const StewartInverseKinematicSolver &other) = default;
+		StewartInverseKinematicSolver& StewartInverseKinematicSolver::operator=(StewartInverseKinematicSolver &&other) = default;
+
+		struct ScaraInverseKinematicSolver::Imp
+		{
+			struct Link
+			{
+				Joint *jnt;
+				Motion *mot;
+				Part *prt;
+				bool is_revolute;
+				double A[3], pm0[16], pm[16];
+			};
+
+			std::vector<Link> chain_;
+			GeneralMotion *gm_{ nullptr };
+			Part *ee_{ nullptr };
+			Size r_[3];
+			double z_[3], x_[3], ee_pm0[16], last_delta2_{ 0.0 };
+			bool topology_matched_{ false }, reference_ok_{ false };
+
+			auto detect(Model &m)->bool
+			{
+				chain_.clear();
+				gm_ = nullptr;
+				ee_ = nullptr;
+
+				for (auto &gm : m.generalMotionPool())
+				{
+					if (!gm.active())continue;
+					if (gm_)return false;
+					gm_ = &gm;
+				}
+				if (!gm_ || &gm_->makJ().fatherPart() != &m.ground() || &gm_->makI().fatherPart() == &m.ground())return false;
+				ee_ = &gm_->makI().fatherPart();
+
+				// 从地面沿关节走到末端，每个杆件只能连接前后两个关节 //
+				Joint *last{ nullptr };
+				for (Part *cur = &m.ground(); cur != ee_;)
+				{
+					Joint *next{ nullptr };
+					for (auto &jnt : m.jointPool())
+					{
+						if (!jnt.active() || &jnt == last)continue;
+						if (&jnt.makI().fatherPart() != cur && &jnt.makJ().fatherPart() != cur)continue;
+						if (next)return false;
+						next = &jnt;
+					}
+					if (!next || chain_.size() == 4)return false;
+
+					Link link;
+					link.jnt = next;
+					link.prt = &analyticOtherPart(*next, *cur);
+					link.is_revolute = dynamic_cast<RevoluteJoint*>(next) != nullptr;
+					link.mot = analyticFindMotion(m, *next);
+					if (!link.is_revolute && !dynamic_cast<PrismaticJoint*>(next))return false;
+					if (!link.mot || link.mot->axis() != (link.is_revolute ? 5 : 2))return false;
+					chain_.push_back(link);
+
+					last = next;
+					cur = link.prt;
+				}
+
+				Size r_num{ 0 }, prt_num{ 0 }, jnt_num{ 0 };
+				for (Size i = 0; i < chain_.size(); ++i)if (chain_[i].is_revolute) { if (r_num == 3)return false; r_[r_num++] = i; }
+				for (auto &prt : m.partPool())if (prt.active())++prt_num;
+				for (auto &jnt : m.jointPool())if (jnt.active())++jnt_num;
+				return chain_.size() == 4 && r_num == 3 && m.motionPool().size() == 4 && prt_num == 5 && jnt_num == 4;
+			}
+			auto snapshot(const Model &m, double max_error)->bool
+			{
+				if (analyticConstraintError(m) > max_error)return false;
+
+				// 所有轴线必须平行 //
+				s_vc(3, &chain_[0].jnt->makI().pm()[0][2], 4, z_, 1);
+				for (auto &link : chain_)
+				{
+					double axis[3], c[3];
+					s_vc(3, &link.jnt->makI().pm()[0][2], 4, axis, 1);
+					s_c3(axis, z_, c);
+					if (s_norm(3, c) > std::sqrt(max_error))return false;
+
+					s_vc(3, &link.jnt->makI().pm()[0][3], 4, link.A, 1);
+					link.prt->getPm(link.pm0);
+				}
+				ee_->getPm(ee_pm0);
+
+				// 与z轴垂直的参考方向，用来计算绕z轴的转角 //
+				const double e[3]{ 1.0,0.0,0.0 }, f[3]{ 0.0,1.0,0.0 };
+				s_c3(std::abs(z_[0]) < 0.5 ? e : f, z_, x_);
+				s_nv(3, 1.0 / s_norm(3, x_), x_);
+
+				// 两段连杆在平面内的投影不能为零 //
+				for (Size i = 0; i < 2; ++i)
+				{
+					double a[3];
+					s_vc(3, chain_[r_[i + 1]].A, a);
+					s_vs(3, chain_[r_[i]].A, a);
+					s_va(3, -s_vv(3, a, z_), z_, a);
+					if (s_norm(3, a) < std::sqrt(max_error))return false;
+				}
+
+				last_delta2_ = 0.0;
+				return true;
+			}
+			auto solve(const double *ee_pm, double &error)->bool
+			{
+				// 末端相对于参考位形的转动只能绕z轴 //
+				double rm_rel[9], z_rel[3];
+				s_mm<3, 3, 3>(ee_pm, 4, ee_pm0, T(4), rm_rel, 3);
+				s_mm<3, 1, 3>(rm_rel, z_, z_rel);
+				s_vs(3, z_, z_rel);
+				error = s_norm(3, z_rel);
+				if (!(error < 1e-9))return false;
+
+				double x_rel[3], c[3];
+				s_mm<3, 1, 3>(rm_rel, x_, x_rel);
+				s_c3(x_, x_rel, c);
+				const double psi = std::atan2(s_vv(3, c, z_), s_vv(3, x_, x_rel));
+
+				// 末端的平移 = 平面内的两杆问题 + 沿z轴的移动 //
+				const double *A1 = chain_[r_[0]].A, *A2 = chain_[r_[1]].A, *A3 = chain_[r_[2]].A;
+				const double e0[3]{ ee_pm0[3], ee_pm0[7], ee_pm0[11] };
+				double rot[16], w[3], a[3], b[3];
+				analyticRotAbout(A3, z_, psi, rot);
+				s_pm_dot_v3(rot, e0, w);
+				for (Size i = 0; i < 3; ++i)
+				{
+					w[i] = ee_pm[i * 4 + 3] - (w[i] + rot[i * 4 + 3]) + A3[i] - A1[i];
+					a[i] = A2[i] - A1[i];
+					b[i] = A3[i] - A2[i];
+				}
+				const double delta_z = s_vv(3, w, z_) - s_vv(3, a, z_) - s_vv(3, b, z_);
+				s_va(3, -s_vv(3, w, z_), z_, w);
+				s_va(3, -s_vv(3, a, z_), z_, a);
+				s_va(3, -s_vv(3, b, z_), z_, b);
+
+				const double la = s_norm(3, a), lb = s_norm(3, b), lw = s_norm(3, w);
+				double cos_phi = (lw*lw - la*la - lb*lb) / (2 * la*lb);
+				if (std::abs(cos_phi) > 1 + 1e-12)return false;
+				cos_phi = std::max(-1.0, std::min(1.0, cos_phi));
+
+				double axb[3];
+				s_c3(a, b, axb);
+				const double phi0 = std::atan2(s_vv(3, axb, z_), s_vv(3, a, b));
+				const double candidate[2]{ std::acos(cos_phi) - phi0, -std::acos(cos_phi) - phi0 };
+				const double delta2 = analyticNearestAngle(candidate, last_delta2_);
+
+				double v[3], vxw[3];
+				analyticRotAbout(A2, z_, delta2, rot);
+				s_pm_dot_v3(rot, b, v);
+				s_va(3, a, v);
+				s_c3(v, w, vxw);
+				const double delta1 = std::atan2(s_vv(3, vxw, z_), s_vv(3, v, w));
+				const double delta[3]{ delta1, delta2, psi - delta1 - delta2 };
+
+				// 按指数积公式依次更新各杆件 //
+				double T_acc[16]{ 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1 }, step[16], tem[16];
+				for (Size i = 0, r = 0; i < chain_.size(); ++i)
+				{
+					auto &link = chain_[i];
+					if (link.is_revolute)
+					{
+						analyticRotAbout(link.A, z_, delta[r++], step);
+					}
+					else
+					{
+						const double trans[16]{ 1,0,0,delta_z * z_[0],0,1,0,delta_z * z_[1],0,0,1,delta_z * z_[2],0,0,0,1 };
+						s_vc(16, trans, step);
+					}
+					s_pm_dot_pm(T_acc, step, tem);
+					s_vc(16, tem, T_acc);
+					s_pm_dot_pm(T_acc, link.pm0, link.pm);
+				}
+
+				last_delta2_ = delta2;
+				error = 0.0;
+				return true;
+			}
+		};
+		auto ScaraInverseKinematicSolver::allocateMemory()->void
+		{
+			InverseKinematicSolver::allocateMemory();
+			imp_->topology_matched_ = imp_->detect(model());
+			imp_->reference_ok_ = imp_->topology_matched_ && imp_->snapshot(model(), maxError());
+		}
+		auto ScaraInverseKinematicSolver::kinPos()->bool
+		{
+			if (!isAnalytic())
+			{
+				auto ret = InverseKinematicSolver::kinPos();
+				if (ret && imp_->topology_matched_)imp_->reference_ok_ = imp_->snapshot(model(), std::max(maxError(), error()));
+				return ret;
+			}
+
+			double tem[16], ee_pm[16], error;
+			s_pm_dot_pm(*imp_->gm_->makJ().pm(), *imp_->gm_->mpm(), tem);
+			s_pm_dot_inv_pm(tem, *imp_->gm_->makI().prtPm(), ee_pm);
+
+			setIterCount(0);
+			auto ret = imp_->solve(ee_pm, error);
+			setError(ret ? error : std::max(error, maxError()));
+			if (!ret)return false;
+
+			for (auto &link : imp_->chain_)
+			{
+				link.prt->setPm(link.pm);
+				link.mot->updMp();
+			}
+			return true;
+		}
+		auto ScaraInverseKinematicSolver::isAnalytic()const->bool { return imp_->topology_matched_ && imp_->reference_ok_; }
+		ScaraInverseKinematicSolver::~ScaraInverseKinematicSolver() = default;
+		ScaraInverseKinematicSolver::ScaraInverseKinematicSolver(const std::string &name, Size max_iter_count, double max_error) :InverseKinematicSolver(name, max_iter_count, max_error) {}
+		ScaraInverseKinematicSolver::ScaraInverseKinematicSolver(const ScaraInverseKinematicSolver &other) = default;
+		ScaraInverseKinematicSolver::ScaraInverseKinematicSolver(ScaraInverseKinematicSolver &&other) = default;
+		ScaraInverseKinematicSolver& ScaraInverseKinematicSolver::operator=(const ScaraInverseKinematicSolver &other) = default;
+		ScaraInverseKinematicSolver& ScaraInverseKinematicSolver::operator=(ScaraInverseKinematicSolver &&other) = default;
+
 		auto ForwardDynamicSolver::allocateMemory()->void
 		{
 			for (auto &m : model().motionPool())m.activate(false);
@@ -44,6 +44,15 @@ namespace aris
 			auto virtual kinVel()->void = 0;
 			auto virtual dynAccAndFce()->void = 0;
 			auto init()->void;
+			/// 批量位置求解，用于离线的轨迹校验，各样本互相独立，按连续的段分配到thread_count个任务上（0表示使用全部核心），
+			/// 任务在本次调用临时建立的线程池中执行，不改变s_blk_set_thread_count设置的全局线程数。
+			/// 输入输出均为SoA格式，分量j的第i个样本位于[j*n + i]：正解时input为motionPool().size()个分量的驱动位置，
+			/// output为generalMotionPool().size() x 16个分量的末端位姿；反解（只有末端激活）时input与output的含义互换。
+			/// 每个样本都以调用时模型中杆件的当前位姿为初值，结果与线程数无关。success可为空，返回值为求解成功的样本数。
+			/// 每个任务使用一份通过xml复制的模型，模型中的所有类型都需要在Model中注册；每次调用都比较模型的xml，
+			/// 与建立副本时相同才重复使用副本，否则重新建立。clearBatchModels()释放副本。不能在分块计算的并行任务中调用。
+			auto kinPosBatch(Size n, const double *input, double *output, bool *success = nullptr, Size thread_count = 0)->Size;
+			auto clearBatchModels()->void;
 			auto error()const->double;
 			auto setError(double error)->void;
 			auto maxError()const->double;
@@ -69,6 +78,8 @@ namespace aris
 		public:
 			static const std::string& Type() { static const std::string type("UniversalSolver"); return type; }
 			auto virtual type() const->const std::string& override{ return Type(); }
+			auto virtual saveXml(aris::core::XmlElement &xml_ele) const->void override;
+			auto virtual loadXml(const aris::core::XmlElement &xml_ele)->void override;
 			auto virtual allocateMemory()->void override;
 			auto virtual kinPos()->bool override;
 			auto virtual kinVel()->void override;
@@ -76,6 +87,22 @@ namespace aris
 			auto cptGeneralJacobi()->void;
 			auto plotRelation()->void;
 
+			/// 迭代初值预测，0为关闭（默认），1为根据最近2次收敛解线性外推，2为根据最近3次收敛解二次外推
+			/// 适用于连续轨迹的位置求解；外推失败时会自动从杆件当前位置重新迭代
+			auto predictorOrder()const->Size;
+			auto setPredictorOrder(Size order)->void;
+			/// 外部直接修改了杆件位姿后，需要清除历史解
+			auto resetPredictor()->void;
+			/// 位置与速度求解时将F按独立的块分别做QR分解（默认），关闭后对整个F做稠密QR分解
+			auto blockQr()const->bool;
+			auto setBlockQr(bool use_block_qr)->void;
+			
+			/// kinPos的调用次数、累计迭代次数与单次最大迭代次数
+			auto kinPosCount()const->Size;
+			auto totalIterCount()const->Size;
+			auto peakIterCount()const->Size;
+			auto resetIterStatistics()->void;
+
 			virtual ~UniversalSolver();
 			explicit UniversalSolver(const std::string &name = "diag_solver", Size max_iter_count = 100, double max_error = 1e-10);
 			UniversalSolver(const UniversalSolver &other);
@@ -123,6 +150,55 @@ namespace aris
 			InverseKinematicSolver& operator=(const InverseKinematicSolver &other);
 			InverseKinematicSolver& operator=(InverseKinematicSolver &&other);
 		};
+		/// \brief Stewart平台（6条 U-P-S 腿）的解析位置反解
+		///
+		/// allocateMemory()时自动识别拓扑，并以当前装配好的位姿作为参考位形；
+		/// 识别失败、参考位形不满足约束时，退化为 InverseKinematicSolver 的迭代求解。
+		class StewartInverseKinematicSolver :public InverseKinematicSolver
+		{
+		public:
+			static const std::string& Type() { static const std::string type("StewartInverseKinematicSolver"); return type; }
+			auto virtual type() const->const std::string& override{ return Type(); }
+
+			auto virtual allocateMemory()->void override;
+			auto virtual kinPos()->bool override;
+			auto isAnalytic()const->bool;
+
+			virtual ~StewartInverseKinematicSolver();
+			explicit StewartInverseKinematicSolver(const std::string &name = "stewart_inverse_kinematic_solver", Size max_iter_count = 100, double max_error = 1e-10);
+			StewartInverseKinematicSolver(const StewartInverseKinematicSolver &other);
+			StewartInverseKinematicSolver(StewartInverseKinematicSolver &&other);
+			StewartInverseKinematicSolver& operator=(const StewartInverseKinematicSolver &other);
+			StewartInverseKinematicSolver& operator=(StewartInverseKinematicSolver &&other);
+
+		private:
+			struct Imp;
+			aris::core::ImpPtr<Imp> imp_;
+		};
+		/// \brief SCARA机器人（3个平行转动副 + 1个沿轴线的移动副，串联）的解析位置反解
+		///
+		/// 关节顺序任意，只要所有轴线平行且每个关节上有一个驱动；识别失败时退化为迭代求解。
+		class ScaraInverseKinematicSolver :public InverseKinematicSolver
+		{
+		public:
+			static const std::string& Type() { static const std::string type("ScaraInverseKinematicSolver"); return type; }
+			auto virtual type() const->const std::string& override{ return Type(); }
+
+			auto virtual allocateMemory()->void override;
+			auto virtual kinPos()->bool override;
+			auto isAnalytic()const->bool;
+
+			virtual ~ScaraInverseKinematicSolver();
+			explicit ScaraInverseKinematicSolver(const std::string &name = "scara_inverse_kinematic_solver", Size max_iter_count = 100, double max_error = 1e-10);
+			ScaraInverseKinematicSolver(const ScaraInverseKinematicSolver &other);
+			ScaraInverseKinematicSolver(ScaraInverseKinematicSolver &&other);
+			ScaraInverseKinematicSolver& operator=(const ScaraInverseKinematicSolver &other);
+			ScaraInverseKinematicSolver& operator=(ScaraInverseKinematicSolver &&other);
+
+		private:
+			struct Imp;
+			aris::core::ImpPtr<Imp> imp_;
+		};
 		class ForwardDynamicSolver :public UniversalSolver
 		{
 		public:
@@ -1209,7 +1209,7 @@ namespace aris
 			
 			double prt_gr[3], prt_fg[6];
 			s_inv_pm_dot_v3(*pm(), model().environment().gravity(), prt_gr);
-			s_mm(6, 1, 3, prt_im, 6, prt_gr, 1, prt_fg, 1);
+			s_mm<6, 1, 3>(prt_im, 6, prt_gr, 1, prt_fg, 1);
 
 			double pm[16];
 			getPm(relative_to, pm);
@@ -1222,7 +1222,7 @@ namespace aris
 
 			double prt_gr[3], prt_fg[6];
 			s_inv_pm_dot_v3(*pm(), model().environment().gravity(), prt_gr);
-			s_mm(6, 1, 3, prt_im, 6, prt_gr, 1, prt_fg, 1);
+			s_mm<6, 1, 3>(prt_im, 6, prt_gr, 1, prt_fg, 1);
 			s_tf(*pm(), prt_fg, fg);
 		}
 		auto Part::cptPrtFg(double *fg)const->void
@@ -1232,7 +1232,7 @@ namespace aris
 			
 			double prt_gr[3];
 			s_inv_pm_dot_v3(*pm(), model().environment().gravity(), prt_gr);
-			s_mm(6, 1, 3, prt_im, 6, prt_gr, 1, fg, 1);
+			s_mm<6, 1, 3>(prt_im, 6, prt_gr, 1, fg, 1);
 		}
 		auto Part::cptFv(const Coordinate &relative_to, double *fv)const->void
 		{
@@ -1241,7 +1241,7 @@ namespace aris
 			
 			double prt_vs[6], tem[6], prt_fv[6];
 			s_inv_tv(*pm(), vs(), prt_vs);
-			s_mm(6, 1, 6, prt_im, prt_vs, tem);
+			s_mm<6, 1, 6>(prt_im, prt_vs, tem);
 			s_cf(prt_vs, tem, prt_fv);
 
 			double pm[16];
@@ -1255,7 +1255,7 @@ namespace aris
 			
 			double prt_vs[6], prt_fv[6], tem[6];
 			s_inv_tv(*pm(), vs(), prt_vs);
-			s_mm(6, 1, 6, prt_im, prt_vs, tem);
+			s_mm<6, 1, 6>(prt_im, prt_vs, tem);
 			s_cf(prt_vs, tem, prt_fv);
 			s_tf(*pm(), prt_fv, fv);
 		}
@@ -1267,7 +1267,7 @@ namespace aris
 			
 			double prt_vs[6], tem[6];
 			s_inv_tv(*pm(), vs(), prt_vs);
-			s_mm(6, 1, 6, prt_im, prt_vs, tem);
+			s_mm<6, 1, 6>(prt_im, prt_vs, tem);
 			s_cf(prt_vs, tem, fv);
 		}
 		auto Part::cptPf(const Coordinate &relative_to, double *pf)const->void
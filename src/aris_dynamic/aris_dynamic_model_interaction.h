@@ -66,7 +66,7 @@ namespace aris
 				s_fill(6, 6, 0.0, tem);
 				s_fill(6, 1, 1.0, tem, 7);
 				s_inv_um(dim(), R, dim(), tem, 6);
-				s_mm(6, 6, 6, tem, 6, Q, dynamic::ColMajor{ 6 }, dm, 6);
+				s_mm<6, 6, 6>(tem, 6, Q, dynamic::ColMajor{ 6 }, dm, 6);
 			}
 			auto virtual cptGlbCmFromPm(double *cmI, double *cmJ, const double *makI_pm, const double *makJ_pm)const->void
 			{
@@ -334,7 +334,7 @@ namespace aris
 				s_tmf(pm, dm);
 
 				double r[4]{ -y2 / norm, x2 / norm, -x2 / norm, -y2 / norm };
-				s_mm(2, 6, 2, r, dm + 18, pm);
+				s_mm<2, 6, 2>(r, dm + 18, pm);
 				s_mc(2, 6, pm, dm + 18);
 			}
 			auto virtual cptGlbCmFromPm(double *cmI, double *cmJ, const double *makI_pm, const double *makJ_pm)const->void override
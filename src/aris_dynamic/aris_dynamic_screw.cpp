@@ -10,6 +10,13 @@
 #include <array>
 #include <list>
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 #include "aris_dynamic_screw.h"
 
 namespace aris
@@ -61,6 +68,146 @@ namespace aris
 		auto inline P()noexcept->const double3x3&{ static const double p[3][3] { { 0, -1, 1 },{ 1, 0, -1 },{ -1, 1, 0 } };	return p; }
 		auto inline Q()noexcept->const double3x3&{ static const double q[3][3] { { 1, 0, 0 },{ 0, 1, 0 },{ 0, 0, 1 } };	return q; }
 
+		// 以下为螺旋运算内核的SIMD实现，4x4位姿矩阵的每一行、3维向量均放在一个256位寄存器中，第4个通道不参与结果 //
+		// 只在x86平台上启用，其他平台以及不支持AVX2的CPU使用标量实现 //
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ARIS_SCREW_SIMD
+#define ARIS_SCREW_AVX2 __attribute__((target("avx2,fma")))
+		auto inline s_detect_simd_level()->int { __builtin_cpu_init(); return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? SIMD_AVX2 : SIMD_SCALAR; }
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define ARIS_SCREW_SIMD
+#define ARIS_SCREW_AVX2
+		auto inline s_detect_simd_level()->int
+		{
+			int info[4];
+			__cpuid(info, 1);
+			const bool fma = (info[2] & (1 << 12)) != 0, osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+			if (!(fma && osxsave && avx) || (_xgetbv(0) & 0x6) != 0x6)return SIMD_SCALAR;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0 ? SIMD_AVX2 : SIMD_SCALAR;
+		}
+#else
+		auto inline s_detect_simd_level()->int { return SIMD_SCALAR; }
+#endif
+		static int simd_level_ = s_detect_simd_level();
+		auto s_simd_level()noexcept->int { return simd_level_; }
+		auto s_set_simd_level(int level)noexcept->int { return simd_level_ = std::max(int(SIMD_SCALAR), std::min(level, s_detect_simd_level())); }
+
+#ifdef ARIS_SCREW_SIMD
+		ARIS_SCREW_AVX2 auto inline avx2_mask3()->__m256i { return _mm256_set_epi64x(0, -1, -1, -1); }
+		ARIS_SCREW_AVX2 auto inline avx2_load3(const double *v)->__m256d { return _mm256_maskload_pd(v, avx2_mask3()); }
+		ARIS_SCREW_AVX2 auto inline avx2_store3(double *v, __m256d a)->void { _mm256_maskstore_pd(v, avx2_mask3(), a); }
+		ARIS_SCREW_AVX2 auto inline avx2_c3(__m256d a, __m256d b)->__m256d
+		{
+			const __m256d a_yzx = _mm256_permute4x64_pd(a, _MM_SHUFFLE(3, 0, 2, 1)), a_zxy = _mm256_permute4x64_pd(a, _MM_SHUFFLE(3, 1, 0, 2));
+			const __m256d b_yzx = _mm256_permute4x64_pd(b, _MM_SHUFFLE(3, 0, 2, 1)), b_zxy = _mm256_permute4x64_pd(b, _MM_SHUFFLE(3, 1, 0, 2));
+			return _mm256_fmsub_pd(a_yzx, b_zxy, _mm256_mul_pd(a_zxy, b_yzx));
+		}
+		// 将位姿矩阵的前3行转置为4列，c[3]为平移 //
+		ARIS_SCREW_AVX2 auto inline avx2_pm_cols(const double *pm, __m256d *c)->void
+		{
+			const __m256d r0 = _mm256_loadu_pd(pm), r1 = _mm256_loadu_pd(pm + 4), r2 = _mm256_loadu_pd(pm + 8), r3 = _mm256_setzero_pd();
+			const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1), t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+			c[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+			c[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+			c[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+			c[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+		}
+		// R * v，c为avx2_pm_cols的结果 //
+		ARIS_SCREW_AVX2 auto inline avx2_rm_dot_v3(const __m256d *c, const double *v)->__m256d
+		{
+			return _mm256_fmadd_pd(c[2], _mm256_broadcast_sd(v + 2), _mm256_fmadd_pd(c[1], _mm256_broadcast_sd(v + 1), _mm256_mul_pd(c[0], _mm256_broadcast_sd(v))));
+		}
+		// R^T * v，只需要位姿矩阵的行 //
+		ARIS_SCREW_AVX2 auto inline avx2_inv_rm_dot_v3(const double *pm, const double *v)->__m256d
+		{
+			return _mm256_fmadd_pd(_mm256_loadu_pd(pm + 8), _mm256_broadcast_sd(v + 2), _mm256_fmadd_pd(_mm256_loadu_pd(pm + 4), _mm256_broadcast_sd(v + 1), _mm256_mul_pd(_mm256_loadu_pd(pm), _mm256_broadcast_sd(v))));
+		}
+		ARIS_SCREW_AVX2 auto inline avx2_store_pm_last_row(double *pm_out)->void { _mm256_storeu_pd(pm_out + 12, _mm256_set_pd(1.0, 0.0, 0.0, 0.0)); }
+
+		ARIS_SCREW_AVX2 auto s_pm_dot_pm_avx2(const double *pm1, const double *pm2, double *pm_out) noexcept->void
+		{
+			const __m256d b0 = _mm256_loadu_pd(pm2), b1 = _mm256_loadu_pd(pm2 + 4), b2 = _mm256_loadu_pd(pm2 + 8), e3 = _mm256_set_pd(1.0, 0.0, 0.0, 0.0);
+			__m256d r[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				const double *a = pm1 + 4 * i;
+				r[i] = _mm256_fmadd_pd(_mm256_broadcast_sd(a + 3), e3, _mm256_fmadd_pd(_mm256_broadcast_sd(a + 2), b2, _mm256_fmadd_pd(_mm256_broadcast_sd(a + 1), b1, _mm256_mul_pd(_mm256_broadcast_sd(a), b0))));
+			}
+			_mm256_storeu_pd(pm_out, r[0]);
+			_mm256_storeu_pd(pm_out + 4, r[1]);
+			_mm256_storeu_pd(pm_out + 8, r[2]);
+			avx2_store_pm_last_row(pm_out);
+		}
+		ARIS_SCREW_AVX2 auto s_inv_pm_dot_pm_avx2(const double *inv_pm, const double *pm, double *pm_out) noexcept->void
+		{
+			// pm的每一行减去inv_pm的平移，再左乘R^T //
+			const __m256d b0 = _mm256_sub_pd(_mm256_loadu_pd(pm), _mm256_set_pd(inv_pm[3], 0.0, 0.0, 0.0));
+			const __m256d b1 = _mm256_sub_pd(_mm256_loadu_pd(pm + 4), _mm256_set_pd(inv_pm[7], 0.0, 0.0, 0.0));
+			const __m256d b2 = _mm256_sub_pd(_mm256_loadu_pd(pm + 8), _mm256_set_pd(inv_pm[11], 0.0, 0.0, 0.0));
+			__m256d r[3];
+			for (int i = 0; i < 3; ++i)
+				r[i] = _mm256_fmadd_pd(_mm256_broadcast_sd(inv_pm + 8 + i), b2, _mm256_fmadd_pd(_mm256_broadcast_sd(inv_pm + 4 + i), b1, _mm256_mul_pd(_mm256_broadcast_sd(inv_pm + i), b0)));
+			_mm256_storeu_pd(pm_out, r[0]);
+			_mm256_storeu_pd(pm_out + 4, r[1]);
+			_mm256_storeu_pd(pm_out + 8, r[2]);
+			avx2_store_pm_last_row(pm_out);
+		}
+		ARIS_SCREW_AVX2 auto s_tv_avx2(const double *pm, const double *vs, double *vs_out) noexcept->void
+		{
+			__m256d c[4];
+			avx2_pm_cols(pm, c);
+			const __m256d w = avx2_rm_dot_v3(c, vs + 3);
+			const __m256d v = _mm256_add_pd(avx2_rm_dot_v3(c, vs), avx2_c3(c[3], w));
+			_mm256_storeu_pd(vs_out, v);
+			avx2_store3(vs_out + 3, w);
+		}
+		ARIS_SCREW_AVX2 auto s_inv_tv_avx2(const double *inv_pm, const double *vs, double *vs_out) noexcept->void
+		{
+			// v' = R^T(v + w x p), w' = R^T w //
+			const __m256d p = _mm256_set_pd(0.0, inv_pm[11], inv_pm[7], inv_pm[3]);
+			double tem[4];
+			_mm256_storeu_pd(tem, _mm256_add_pd(avx2_load3(vs), avx2_c3(avx2_load3(vs + 3), p)));
+			const __m256d v = avx2_inv_rm_dot_v3(inv_pm, tem);
+			const __m256d w = avx2_inv_rm_dot_v3(inv_pm, vs + 3);
+			_mm256_storeu_pd(vs_out, v);
+			avx2_store3(vs_out + 3, w);
+		}
+		ARIS_SCREW_AVX2 auto s_tf_avx2(const double *pm, const double *fs, double *fs_out) noexcept->void
+		{
+			__m256d c[4];
+			avx2_pm_cols(pm, c);
+			const __m256d f = avx2_rm_dot_v3(c, fs);
+			const __m256d m = _mm256_add_pd(avx2_rm_dot_v3(c, fs + 3), avx2_c3(c[3], f));
+			_mm256_storeu_pd(fs_out, f);
+			avx2_store3(fs_out + 3, m);
+		}
+		ARIS_SCREW_AVX2 auto s_cv_avx2(const double *vs, const double *vs2, double* vvs_out) noexcept->void
+		{
+			const __m256d v = avx2_load3(vs), w = avx2_load3(vs + 3), v2 = avx2_load3(vs2), w2 = avx2_load3(vs2 + 3);
+			_mm256_storeu_pd(vvs_out, _mm256_add_pd(avx2_c3(w, v2), avx2_c3(v, w2)));
+			avx2_store3(vvs_out + 3, avx2_c3(w, w2));
+		}
+		ARIS_SCREW_AVX2 auto s_cf_avx2(const double *vs, const double *fs, double* vfs_out) noexcept->void
+		{
+			const __m256d v = avx2_load3(vs), w = avx2_load3(vs + 3), f = avx2_load3(fs), m = avx2_load3(fs + 3);
+			_mm256_storeu_pd(vfs_out, avx2_c3(w, f));
+			avx2_store3(vfs_out + 3, _mm256_add_pd(avx2_c3(w, m), avx2_c3(v, f)));
+		}
+		ARIS_SCREW_AVX2 auto s_iv_dot_as_avx2(const double *iv, const double *as, double * fs) noexcept->void
+		{
+			// f = m*a - c x w, n = c x a + I*w，其中I为对称阵[Ixx Ixy Ixz; Ixy Iyy Iyz; Ixz Iyz Izz] //
+			const __m256d a = avx2_load3(as), w = avx2_load3(as + 3), c = avx2_load3(iv + 1);
+			const __m256d i0 = _mm256_set_pd(0.0, iv[8], iv[7], iv[4]), i1 = _mm256_set_pd(0.0, iv[9], iv[5], iv[7]), i2 = _mm256_set_pd(0.0, iv[6], iv[9], iv[8]);
+			const __m256d iw = _mm256_fmadd_pd(i2, _mm256_broadcast_sd(as + 5), _mm256_fmadd_pd(i1, _mm256_broadcast_sd(as + 4), _mm256_mul_pd(i0, _mm256_broadcast_sd(as + 3))));
+			_mm256_storeu_pd(fs, _mm256_fmsub_pd(_mm256_broadcast_sd(iv), a, avx2_c3(c, w)));
+			avx2_store3(fs + 3, _mm256_add_pd(avx2_c3(c, a), iw));
+		}
+#define ARIS_SCREW_DISPATCH(func, ...) if (simd_level_ == SIMD_AVX2) return func##_avx2(__VA_ARGS__)
+#else
+#define ARIS_SCREW_DISPATCH(func, ...)
+#endif
+
 		auto s_inv_pm(const double *pm_in, double *pm_out) noexcept->void
 		{
 			//转置
@@ -87,6 +234,8 @@ namespace aris
 		}
 		auto s_pm_dot_pm(const double *pm1, const double *pm2, double *pm_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_pm_dot_pm, pm1, pm2, pm_out);
+
 			pm_out[0] = pm1[0] * pm2[0] + pm1[1] * pm2[4] + pm1[2] * pm2[8];
 			pm_out[1] = pm1[0] * pm2[1] + pm1[1] * pm2[5] + pm1[2] * pm2[9];
 			pm_out[2] = pm1[0] * pm2[2] + pm1[1] * pm2[6] + pm1[2] * pm2[10];
@@ -109,6 +258,8 @@ namespace aris
 		}
 		auto s_inv_pm_dot_pm(const double *inv_pm, const double *pm, double *pm_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_inv_pm_dot_pm, inv_pm, pm, pm_out);
+
 			pm_out[0] = inv_pm[0] * pm[0] + inv_pm[4] * pm[4] + inv_pm[8] * pm[8];
 			pm_out[1] = inv_pm[0] * pm[1] + inv_pm[4] * pm[5] + inv_pm[8] * pm[9];
 			pm_out[2] = inv_pm[0] * pm[2] + inv_pm[4] * pm[6] + inv_pm[8] * pm[10];
@@ -172,10 +323,12 @@ namespace aris
 			s_c3s(c, as + 3, fs);
 
 			s_c3(c, as, fs + 3);
-			s_mma(3, 1, 3, im + 21, 6, as + 3, 1, fs + 3, 1);
+			s_mma<3, 1, 3>(im + 21, 6, as + 3, 1, fs + 3, 1);
 		}
 		auto s_iv_dot_as(const double *iv, const double *as, double * fs) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_iv_dot_as, iv, as, fs);
+
 			s_vc(3, iv[0], as, fs);
 			s_c3s(iv + 1, as + 3, fs);
 
@@ -261,6 +414,8 @@ namespace aris
 		}
 		auto s_cf(const double *vs, const double *fs, double* vfs_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_cf, vs, fs, vfs_out);
+
 			s_c3(vs + 3, fs, vfs_out);
 			s_c3(vs + 3, fs + 3, vfs_out + 3);
 			s_c3a(vs, fs, vfs_out + 3);
@@ -322,6 +477,8 @@ namespace aris
 		}
 		auto s_cv(const double *vs, const double *vs2, double* vvs_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_cv, vs, vs2, vvs_out);
+
 			s_c3(vs + 3, vs2, vvs_out);
 			s_c3(vs + 3, vs2 + 3, vvs_out + 3);
 			s_c3a(vs, vs2 + 3, vvs_out);
@@ -381,6 +538,8 @@ namespace aris
 		}
 		auto s_tf(const double *pm, const double *fs, double *fs_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_tf, pm, fs, fs_out);
+
 			s_pm_dot_v3(pm, fs, fs_out);
 			s_pm_dot_v3(pm, fs + 3, fs_out + 3);
 			s_c3a(pm + 3, 4, fs_out, 1, fs_out + 3, 1);
@@ -452,6 +611,8 @@ namespace aris
 		}
 		auto s_tv(const double *pm, const double *vs, double *vs_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_tv, pm, vs, vs_out);
+
 			s_pm_dot_v3(pm, vs, vs_out);
 			s_pm_dot_v3(pm, vs + 3, vs_out + 3);
 			s_c3a(pm + 3, 4, vs_out + 3, 1, vs_out, 1);
@@ -475,6 +636,8 @@ namespace aris
 		}
 		auto s_inv_tv(const double *inv_pm, const double *vs, double *vs_out) noexcept->void
 		{
+			ARIS_SCREW_DISPATCH(s_inv_tv, inv_pm, vs, vs_out);
+
 			s_c3i(inv_pm + 3, 4, vs + 3, 1, vs_out + 3, 1);
 			s_va(3, vs, vs_out + 3);
 
@@ -1005,7 +1168,7 @@ namespace aris
 			axis[b][2] = c == a ? -std::sin(re_in[0])*std::sin(re_in[1]) : P()[b][d] * std::sin(re_in[0])* std::cos(re_in[1]);
 			axis[d][2] = c == a ? P()[d][a] * std::cos(re_in[0])* std::sin(re_in[1]) : std::cos(re_in[0])* std::cos(re_in[1]);
 
-			s_mm(3, 1, 3, *axis, 3, we_in, 1, wa_out, 1);
+			s_mm<3, 1, 3>(*axis, 3, we_in, 1, wa_out, 1);
 
 			return wa_out;
 		}
@@ -2013,8 +2176,8 @@ namespace aris
 			is_out[35] = i3_in[8];
 			
 			s_tmf(pm_in, *tmf);
-			s_mm(6, 6, 6, *tmf, 6, is_out, 6, *tem, 6);
-			s_mm(6, 6, 6, *tem, 6, *tmf, 6, is_out, 6);
+			s_mm<6, 6, 6>(*tmf, 6, is_out, 6, *tem, 6);
+			s_mm<6, 6, 6>(*tem, 6, *tmf, 6, is_out, 6);
 
 			return is_out;
 		}
@@ -2117,7 +2280,7 @@ namespace aris
 			to_rm = to_rm ? to_rm : default_out();
 
 			// 正式开始计算 //
-			s_mm(3, 3, 3, relative_pm, 4, from_rm, from_rm_ld, to_rm, to_rm_ld);
+			s_mm<3, 3, 3>(relative_pm, 4, from_rm, from_rm_ld, to_rm, to_rm_ld);
 
 			return to_rm;
 		}
@@ -2129,7 +2292,7 @@ namespace aris
 			to_rm = to_rm ? to_rm : default_out();
 
 			// 正式开始计算 //
-			s_mm(3, 3, 3, inv_relative_pm, ColMajor{ 4 }, from_rm, from_rm_ld, to_rm, to_rm_ld);
+			s_mm<3, 3, 3>(inv_relative_pm, ColMajor{ 4 }, from_rm, from_rm_ld, to_rm, to_rm_ld);
 
 			return to_rm;
 		}
@@ -2201,7 +2364,7 @@ namespace aris
 			to_pm = to_pm ? to_pm : default_out();
 
 			// 正式开始计算 //
-			s_mm(3, 4, 3, relative_pm, 4, from_pm, 4, to_pm, 4);
+			s_mm<3, 4, 3>(relative_pm, 4, from_pm, 4, to_pm, 4);
 
 			to_pm[3] += relative_pm[3];
 			to_pm[7] += relative_pm[7];
@@ -2222,7 +2385,7 @@ namespace aris
 			to_pm = to_pm ? to_pm : default_out();
 
 			// 正式开始计算 //
-			s_mm(3, 4, 3, inv_relative_pm, ColMajor{ 4 }, from_pm, 4, to_pm, 4);
+			s_mm<3, 4, 3>(inv_relative_pm, ColMajor{ 4 }, from_pm, 4, to_pm, 4);
 
 			to_pm[3] += -inv_relative_pm[0] * inv_relative_pm[3] - inv_relative_pm[4] * inv_relative_pm[7] - inv_relative_pm[8] * inv_relative_pm[11];
 			to_pm[7] += -inv_relative_pm[1] * inv_relative_pm[3] - inv_relative_pm[5] * inv_relative_pm[7] - inv_relative_pm[9] * inv_relative_pm[11];
@@ -2250,7 +2413,7 @@ namespace aris
 			// 正式开始计算 //
 			s_pp2pp(relative_pm, from_pp, to_pp);
 			s_c3(relative_vs + 3, to_pp, to_vp);
-			s_mma(3, 1, 3, relative_pm, 4, from_vp, 1, to_vp, 1);
+			s_mma<3, 1, 3>(relative_pm, 4, from_vp, 1, to_vp, 1);
 			s_va(3, relative_vs, to_vp);
 
 			return to_vp;
@@ -2273,7 +2436,7 @@ namespace aris
 			std::copy_n(from_vp, 3, tem);
 			s_c3s(inv_relative_vs + 3, from_pp, tem);
 			s_vs(3, inv_relative_vs, tem);
-			s_mm(3, 1, 3, inv_relative_pm, ColMajor{ 4 }, tem, 1, to_vp, 1);
+			s_mm<3, 1, 3>(inv_relative_pm, ColMajor{ 4 }, tem, 1, to_vp, 1);
 
 			return to_vp;
 		}
@@ -2412,7 +2575,7 @@ namespace aris
 			to_wa = to_wa ? to_wa : default_out();
 
 			// 正式开始计算 //
-			s_mm(3, 1, 3, relative_pm, 4, from_wa, 1, to_wa, 1);
+			s_mm<3, 1, 3>(relative_pm, 4, from_wa, 1, to_wa, 1);
 			s_va(3, relative_vs + 3, to_wa);
 
 			return to_wa;
@@ -2428,7 +2591,7 @@ namespace aris
 			// 正式计算开始 //
 			double tem[3]{ -inv_relative_vs[3],-inv_relative_vs[4],-inv_relative_vs[5] };
 			s_va(3, from_wa, tem);
-			s_mm(3, 1, 3, inv_relative_pm, ColMajor{ 4 }, tem, 1, to_wa, 1);
+			s_mm<3, 1, 3>(inv_relative_pm, ColMajor{ 4 }, tem, 1, to_wa, 1);
 
 			return to_wa;
 		}
@@ -2654,9 +2817,9 @@ namespace aris
 
 			s_c3(relative_as + 3, to_pp, to_ap);
 			std::copy_n(to_vp, 3, tem_vp);
-			s_mma(3, 1, 3, relative_pm, 4, from_vp, 1, tem_vp, 1);
+			s_mma<3, 1, 3>(relative_pm, 4, from_vp, 1, tem_vp, 1);
 			s_c3a(relative_vs + 3, tem_vp, to_ap);
-			s_mma(3, 1, 3, relative_pm, 4, from_ap, 1, to_ap, 1);
+			s_mma<3, 1, 3>(relative_pm, 4, from_ap, 1, to_ap, 1);
 			s_va(3, relative_as, to_ap);
 
 			return to_ap;
@@ -2688,12 +2851,12 @@ namespace aris
 			s_c3s(inv_relative_as + 3, from_pp, tem);
 
 			std::copy_n(from_vp, 3, tem2);
-			s_mma(3, 1, 3, inv_relative_pm, 4, to_vp, 1, tem2, 1);
+			s_mma<3, 1, 3>(inv_relative_pm, 4, to_vp, 1, tem2, 1);
 			s_c3s(inv_relative_vs + 3, tem2, tem);
 
 			s_vs(3, inv_relative_as, tem);
 
-			s_mm(3, 1, 3, inv_relative_pm, ColMajor{ 4 }, tem, 1, to_ap, 1);
+			s_mm<3, 1, 3>(inv_relative_pm, ColMajor{ 4 }, tem, 1, to_ap, 1);
 
 			return to_ap;
 		}
@@ -2869,7 +3032,7 @@ namespace aris
 			// 正式开始计算 //
 			s_wa2wa(relative_pm, relative_vs, from_wa, to_wa);
 
-			s_mm(3, 1, 3, relative_pm, 4, from_xa, 1, to_xa, 1);
+			s_mm<3, 1, 3>(relative_pm, 4, from_xa, 1, to_xa, 1);
 			s_c3a(relative_vs + 3, to_wa, to_xa);
 			s_va(3, relative_as + 3, to_xa);
 
@@ -2894,7 +3057,7 @@ namespace aris
 			double tem[3]{ -inv_relative_as[3],-inv_relative_as[4],-inv_relative_as[5] };
 			s_va(3, from_xa, tem);
 			s_c3s(inv_relative_vs + 3, from_wa, tem);
-			s_mm(3, 1, 3, inv_relative_pm, ColMajor{ 4 }, tem, 1, to_xa, 1);
+			s_mm<3, 1, 3>(inv_relative_pm, ColMajor{ 4 }, tem, 1, to_xa, 1);
 
 			return to_xa;
 		}
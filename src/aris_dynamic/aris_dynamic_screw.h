@@ -55,6 +55,14 @@ namespace aris
 	/// iv  :  10x1 惯量矩阵向量[m, cx, cy, cz, Ixx, Iyy, Izz, Ixy, Ixz, Iyz]
 	namespace dynamic
 	{
+		/// \brief 螺旋运算内核（s_pm_dot_pm、s_inv_pm_dot_pm、s_tv、s_inv_tv、s_tf、s_cv、s_cf、s_iv_dot_as）使用的指令集
+		///
+		/// 程序启动时根据CPU自动选择，SIMD实现与标量实现的结果在舍入误差范围内一致
+		enum SimdLevel { SIMD_SCALAR = 0, SIMD_AVX2 = 1 };
+		auto s_simd_level()noexcept->int;
+		/// 指定指令集，超出CPU支持范围时自动降级，返回实际使用的指令集，主要用于测试与性能对比
+		auto s_set_simd_level(int level)noexcept->int;
+
 		auto s_inv_pm(const double *pm_in, double *pm_out) noexcept->void;
 		auto s_pm_dot_pm(const double *pm1_in, const double *pm2_in, double *pm_out) noexcept->void;
 		template <typename ...Args>
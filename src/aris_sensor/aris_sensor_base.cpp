@@ -6,24 +6,46 @@ namespace aris
 	{
 		struct Sensor::Imp 
 		{
+			// 三缓冲：latest_ 为最近写完的缓冲，写线程独占 back_，每个缓冲有自己的读者计数 //
+			// 任意多个读线程都可以持有 latest_，写线程只会写既不是 latest_、也没有读者持有的缓冲 //
+			static const int BUFFER_NUM = 3;
+
 			std::atomic_bool is_stopping_;
 			std::thread sensor_thread_;
-			std::atomic_int data_to_read_;
-			std::recursive_mutex data_mutex_[3];
-			std::unique_ptr<SensorData> data_[3];
+			std::atomic_int latest_;
+			std::atomic_int reader_count_[BUFFER_NUM];
+			int back_;
+			std::unique_ptr<SensorData> data_[BUFFER_NUM];
 
+			auto acquire()->int
+			{
+				// 先增加计数再确认该缓冲仍是 latest_：若写线程在两者之间选中它，确认必然失败，重试即可 //
+				for (;;)
+				{
+					auto idx = latest_.load();
+					reader_count_[idx].fetch_add(1);
+					if (latest_.load() == idx) return idx;
+					reader_count_[idx].fetch_sub(1);
+				}
+			}
+			auto release(const SensorData *data)->void
+			{
+				for (int i = 0; i < BUFFER_NUM; ++i) if (data_[i].get() == data) reader_count_[i].fetch_sub(1);
+			}
 			static auto update_thread(Sensor *sensor)->void
 			{
-				std::unique_lock<std::recursive_mutex> lock_(sensor->imp_->data_mutex_[0]);
-
-				while (!sensor->imp_->is_stopping_)
+				auto &imp = *sensor->imp_;
+				while (!imp.is_stopping_)
 				{
-					for (int i = 0; i < 3; ++i)
+					sensor->updateData(std::ref(*imp.data_[imp.back_]));
+					imp.latest_.store(imp.back_);
+
+					// 读者同时持有其余所有缓冲时，写线程等待，读线程永远不会等待 //
+					for (int next = -1; next < 0 && !imp.is_stopping_; )
 					{
-						sensor->imp_->data_to_read_ = (i + 2) % 3;
-						sensor->updateData(std::ref(*sensor->imp_->data_[i]));
-						std::unique_lock<std::recursive_mutex> nextLock(sensor->imp_->data_mutex_[(i + 1) % 3]);
-						lock_.swap(nextLock);
+						for (int i = 0; i < BUFFER_NUM && next < 0; ++i) if (i != imp.back_ && imp.reader_count_[i].load() == 0) next = i;
+						if (next < 0) std::this_thread::yield();
+						else imp.back_ = next;
 					}
 				}
 			};
@@ -34,19 +56,12 @@ namespace aris
 			{
 				init();
 
-				std::lock(imp_->data_mutex_[0], imp_->data_mutex_[1], imp_->data_mutex_[2]);
-
-				std::unique_lock<std::recursive_mutex> lock1(imp_->data_mutex_[0], std::adopt_lock);
-				std::unique_lock<std::recursive_mutex> lock2(imp_->data_mutex_[1], std::adopt_lock);
-				std::unique_lock<std::recursive_mutex> lock3(imp_->data_mutex_[2], std::adopt_lock);
-
 				for (auto &d : imp_->data_)
 				{
 					this->updateData(std::ref(*d));
 				}
 
 				imp_->is_stopping_ = false;
-				imp_->data_to_read_ = 2;
 
 				imp_->sensor_thread_ = std::thread(Imp::update_thread, this);
 			}
@@ -68,24 +83,19 @@ namespace aris
 		Sensor::Sensor(const std::string &name, std::function<SensorData*()> new_func) :Object(name), imp_(new Imp) 
 		{
 			for (auto i = 0; i < 3; ++i)imp_->data_[i].reset(new_func());
+			imp_->back_ = 0;
+			imp_->latest_ = 1;
+			for (auto &count : imp_->reader_count_) count = 0;
 		};
 
+		SensorDataProtector::~SensorDataProtector()
+		{
+			if (sensor_)sensor_->imp_->release(data_);
+		}
 		SensorDataProtector::SensorDataProtector(Sensor *sensor) : sensor_(sensor), data_(nullptr)
 		{
-			//这里data_to_read_指向最新的内存,例如如果data_to_read_为2,那么有两种情况：
-			//1.此时正在写内存0,内存1空闲。
-			//2.在某些极端特殊时刻下,sensor正好刚刚写到内存1,正准备释放dataMutex0,并且之后准备将data_to_read_置为0。
-			//无论以上哪种情况,dataMutex2都会被锁住。
-			//紧接着以上两种情况,继而会发生以下情况：
-			//1.正在写内存0,内存1空闲,dataMutex2都会被锁住后data_to_read_依然为2,那么此后数据一直在操作内存2,安全。
-			//2.dataMutex2被锁住的同时,data_to_read_被更新到0,此时传感器开始写内存1,由于dataMutex2被锁,因此传感器一直无法
-			//更新到内存2；但是数据读取的是内存0,安全。
-			
-			do {
-				lock_ = std::unique_lock<std::recursive_mutex>(sensor_->imp_->data_mutex_[sensor_->imp_->data_to_read_], std::try_to_lock);
-			} while (!lock_.owns_lock());
-			
-			data_ = sensor_->imp_->data_[sensor_->imp_->data_to_read_].get();
+			// 可以在任意多个线程中同时构造，只有原子操作，不会等待写线程，也不会进入内核 //
+			data_ = sensor_->imp_->data_[sensor_->imp_->acquire()].get();
 		};
 
 		struct SensorRoot::Imp
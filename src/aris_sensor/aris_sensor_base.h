@@ -23,11 +23,11 @@ namespace aris
 			auto data() const->const SensorData &{ return *data_; }
 			auto operator->()const -> const SensorData *{ return data_; }
 			auto operator*()const -> const SensorData &{ return std::ref(*data_); }
-			auto operator=(SensorDataProtector && other)->SensorDataProtector & { std::swap(*this, other); return *this; }
+			auto operator=(SensorDataProtector && other)->SensorDataProtector & { std::swap(sensor_, other.sensor_); std::swap(data_, other.data_); return *this; }
 
-			~SensorDataProtector() = default;
+			~SensorDataProtector();
 			SensorDataProtector() : sensor_(nullptr), data_(nullptr) {}
-			SensorDataProtector(SensorDataProtector && other) = default;
+			SensorDataProtector(SensorDataProtector && other) : sensor_(other.sensor_), data_(other.data_) { other.sensor_ = nullptr; other.data_ = nullptr; }
 
 		private:
 			explicit SensorDataProtector(Sensor *sensor);
@@ -36,7 +36,6 @@ namespace aris
 
 			Sensor *sensor_;
 			const SensorData *data_;
-			std::unique_lock<std::recursive_mutex> lock_;
 
 			friend class Sensor;
 		};
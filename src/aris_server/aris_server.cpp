@@ -2,10 +2,14 @@
 #include <thread>
 #include <algorithm>
 #include <memory>
+#include <iomanip>
+#include <atomic>
+#include <mutex>
 
 #include "aris_core.h"
 #include "aris_control.h"
 #include "aris_server.h"
+#include "aris_server_cmd_queue.h"
 
 namespace aris
 {
@@ -55,6 +59,10 @@ namespace aris
 				md_active_motion.add<aris::core::Param>("physical_id", "0", "", 'p');
 				md_active_motion.add<aris::core::Param>("slave_id", "0", "", 's');
 				auto &md_limit_time = md_group.add<aris::core::Param>("limit_time", "10000", "", 'l');
+
+				auto &st = root.add<aris::core::Command>("st", "", "");
+				auto &st_group = st.add<aris::core::GroupParam>("group", "");
+				st_group.add<aris::core::Param>("reset", "", "", 'r');
 			}
 			return root;
 		}
@@ -123,9 +131,7 @@ namespace aris
 
 						if (plan_param.count_ % 1000 == 0)
 						{
-							cs.controller().mout() << "Unenabled motor, slave id: " << cm.id() << ", absolute id: " << i << ", ret: " << ret << '\0';
-							cs.controller().mout().update();
-							cs.controller().sendOut();
+							cs.controller().rtLog("Unenabled motor, slave id: {}, absolute id: {}, ret: {}", cm.id(), i, ret);
 						}
 					}
 				}
@@ -151,9 +157,7 @@ namespace aris
 
 						if (plan_param.count_ % 1000 == 0)
 						{
-							cs.controller().mout() << "Undisabled motor, slave id: " << cm.id() << ", absolute id: " << i << ", ret: " << ret << '\0';
-							cs.controller().mout().update();
-							cs.controller().sendOut();
+							cs.controller().rtLog("Undisabled motor, slave id: {}, absolute id: {}, ret: {}", cm.id(), i, ret);
 						}
 					}
 				}
@@ -179,9 +183,7 @@ namespace aris
 
 						if (plan_param.count_ % 1000 == 0)
 						{
-							cs.controller().mout() << "Unmoded motor, slave id: " << cm.id() << ", absolute id: " << i << ", ret: " << ret << '\0';
-							cs.controller().mout().update();
-							cs.controller().sendOut();
+							cs.controller().rtLog("Unmoded motor, slave id: {}, absolute id: {}, ret: {}", cm.id(), i, ret);
 						}
 					}
 				}
@@ -207,9 +209,7 @@ namespace aris
 
 						if (plan_param.count_ % 1000 == 0)
 						{
-							cs.controller().mout() << "Unmoded motor, slave id: " << cm.id() << ", absolute id: " << i << ", ret: " << ret << '\0';
-							cs.controller().mout().update();
-							cs.controller().sendOut();
+							cs.controller().rtLog("Unmoded motor, slave id: {}, absolute id: {}, ret: {}", cm.id(), i, ret);
 						}
 					}
 				}
@@ -217,16 +217,39 @@ namespace aris
 
 			return (is_all_homed || param->limit_time_ <= plan_param.count_) ? 0 : 1;
 		}
+		auto default_statistics_parse(const std::string &cmd, const std::map<std::string, std::string> &params, aris::core::Msg &msg_out)->void
+		{
+			auto &cs = aris::server::ControlServer::instance();
+			auto stat = cs.controller().statistics();
+
+			auto print = [](const std::string &name, const aris::control::RtPhaseStatistics &s)
+			{
+				std::cout << std::setw(10) << name << " min:" << std::setw(8) << s.min_ns_ << " avr:" << std::setw(8) << s.avr_ns_ 
+					<< " p50:" << std::setw(8) << s.p50_ns_ << " p99:" << std::setw(8) << s.p99_ns_ << " p999:" << std::setw(8) << s.p999_ns_ << " max:" << std::setw(8) << s.max_ns_ << std::endl;
+			};
+			std::cout << "cycle count:" << stat.cycle_count_ << "  overrun count:" << stat.overrun_count_ << "  (ns)" << std::endl;
+			print("latency", stat.latency_);
+			print("recv", stat.recv_);
+			print("strategy", stat.strategy_);
+			print("sync", stat.sync_);
+			print("send", stat.send_);
+			print("cycle", stat.cycle_);
+
+			if (params.find("reset") != params.end())cs.controller().resetStatistics();
+
+			msg_out.header().reserved1_ = ControlServer::NOT_EXECUTE_RT_PLAN;
+		}
 		auto default_enable_command()->const aris::core::Command &{ return static_cast<const aris::core::Command &>(default_command_root().children().at(0)); }
 		auto default_disable_command()->const aris::core::Command &{ return static_cast<const aris::core::Command &>(default_command_root().children().at(1)); }
 		auto default_home_command()->const aris::core::Command &{ return static_cast<const aris::core::Command &>(default_command_root().children().at(2)); }
 		auto default_mode_command()->const aris::core::Command &{ return static_cast<const aris::core::Command &>(default_command_root().children().at(3)); }
+		auto default_statistics_command()->const aris::core::Command &{ return static_cast<const aris::core::Command &>(default_command_root().children().at(4)); }
 
 		class ControlServer::Imp
 		{
 		public:
 			auto tg()->void;
-			auto executeCmd()->int;
+			auto executeCmd(aris::core::MsgBase &msg, aris::core::MsgBase *next)->int;
 			auto onRunError()->int;
 
 			Imp(ControlServer *server) :server_(server) {}
@@ -235,24 +258,31 @@ namespace aris
 		private:
 			std::recursive_mutex mu_running_;
 			std::atomic_bool is_running_{ false };
+			std::mutex mu_parse_;// CommandParser 不能同时解析多条命令
 
 			ControlServer *server_;
 
 			// 实时循环中的步态参数 //
-			enum { CMD_POOL_SIZE = 50 };
-			aris::core::MsgFix<aris::control::Master::MAX_MSG_SIZE> msg_queue_[CMD_POOL_SIZE];
-			int current_cmd_{ 0 };
-			std::atomic<int> cmd_num_{ 0 };
+			CmdQueue cmd_queue_;
 			std::uint32_t count_{ 1 };
+			bool discard_cmd_{ false };
 
-			// 储存上一次motion的数据 //
-			struct PVC { double p; double v; double c; };
-			std::vector<PVC> last_target_motion_data_vec_;
+			// 命令融合，next_count_ 为 0 时表示下一条命令还没有开始 //
+			struct BlendData { double base, offset, p, v, next_p, next_v; };
+			std::vector<BlendData> blend_data_;
+			std::uint32_t blend_window_{ 0 };
+			std::uint32_t next_count_{ 0 };
+			int next_ret_{ 0 };
+			bool has_blend_offset_{ false };
+
+			// 本周期电机的目标位置，上一周期的目标位置在 controller 的 motionState() 中 //
+			std::vector<double> target_pos_;
 
 			// 以下储存所有的命令的parse和plan函数 //
 			std::map<std::string, int> cmd_id_map_;//store gait id in follow vector
 			std::vector<dynamic::PlanFunction> plan_vec_;// store plan func
-			std::vector<ParseFunc> parser_vec_; // store parse func
+			std::vector<ParamViewParseFunc> parser_vec_; // store parse func
+			aris::core::ParamView param_view_;// 在 mu_parse_ 保护下重复使用
 
 			// 储存Model, Controller, SensorRoot, WidgetRoot //
 			aris::dynamic::Model* model_;
@@ -264,36 +294,42 @@ namespace aris
 		};
 		auto ControlServer::Imp::tg()->void
 		{
-			// 查看是否有新cmd //
-			if (server_->controller().recvIn())
-			{
-				if (cmd_num_ >= CMD_POOL_SIZE)
-				{
-					server_->controller().mout() << "cmd pool is full, thus ignore last command\n";
-					// 结束同步调用的等待 //
-					auto promise = reinterpret_cast<std::promise<void>*&>(server_->controller().msgIn().header().reserved3_);
-					if (promise)promise->set_value();
-				}
-				else
-				{
-					msg_queue_[(current_cmd_ + cmd_num_) % CMD_POOL_SIZE] = server_->controller().msgIn();
-					++cmd_num_;
-				}
-			}
-
 			// 执行cmd queue中的cmd //
-			if (cmd_num_ > 0)
+			if (auto msg = cmd_queue_.front())
 			{
-				if (executeCmd())
+				if (executeCmd(*msg, blend_window_ > 0 ? cmd_queue_.next() : nullptr))
 				{
-					if (++count_ % 1000 == 0) server_->controller().mout() << "execute cmd in count: " << count_;
+					if (++count_ % 1000 == 0) server_->controller().rtLog("execute cmd in count: {}", count_);
 				}
 				else
 				{
-					server_->controller().mout() << "cmd finished, spend " << count_ << " counts\n\n";
+					server_->controller().rtLog("cmd finished, spend {} counts", count_);
 					count_ = 1;
-					current_cmd_ = (current_cmd_ + 1) % CMD_POOL_SIZE;
-					--cmd_num_;
+					cmd_queue_.pop();
+
+					// 融合中的下一条命令成为当前命令，若其已经结束则一并出队 //
+					has_blend_offset_ = false;
+					if (next_count_ > 0)
+					{
+						if (next_ret_ > 0)
+						{
+							count_ = next_count_;
+							has_blend_offset_ = true;
+						}
+						else
+						{
+							server_->controller().rtLog("blended cmd finished");
+							cmd_queue_.pop();
+						}
+						next_count_ = 0;
+					}
+
+					if (discard_cmd_)
+					{
+						for (discard_cmd_ = false; cmd_queue_.front();) cmd_queue_.pop();
+						count_ = 1;
+						has_blend_offset_ = false;
+					}
 				}
 			}
 
@@ -303,12 +339,63 @@ namespace aris
 			server_->controller().mout().update();
 			server_->controller().sendOut();
 		}
-		auto ControlServer::Imp::executeCmd()->int
+		auto ControlServer::Imp::executeCmd(aris::core::MsgBase &msg, aris::core::MsgBase *next)->int
 		{
-			aris::dynamic::PlanParam plan_param{ model_, count_, msg_queue_[current_cmd_].data(), static_cast<std::uint32_t>(msg_queue_[current_cmd_].size()) };
+			aris::dynamic::PlanParam plan_param{ model_, count_, msg.data(), static_cast<std::uint32_t>(msg.size()) };
 
 			// 执行plan函数 //
-			int ret = this->plan_vec_.at(static_cast<std::size_t>(msg_queue_[current_cmd_].header().reserved1_)).operator()(plan_param);
+			int ret = this->plan_vec_.at(static_cast<std::size_t>(msg.header().reserved1_)).operator()(plan_param);
+			auto option = msg.header().reserved2_;
+
+			// 融合：当前命令剩余 blend_window_ 个周期时开始执行下一条命令，叠加两者相对于起点的位移 //
+			const auto motion_num = std::min(controller_->motionPool().size(), model_->motionPool().size());
+			if (has_blend_offset_) for (std::size_t i = 0; i < motion_num; ++i)
+			{
+				auto &mm = model_->motionPool().at(i);
+				if (mm.active())mm.setMp(mm.mp() + blend_data_.at(i).offset);
+			}
+			const auto can_blend = [](std::int64_t opt) { return (opt & USING_TARGET_POS) && (opt & USING_BLEND); };
+			if (next && (next_count_ > 0 || (ret > 0 && static_cast<std::uint32_t>(ret) <= blend_window_ && can_blend(option) && can_blend(next->header().reserved2_))))
+			{
+				// 起点取本周期当前命令的输出，即下一条命令在 count 为 1 时从 model 中读到的位置 //
+				if (next_count_ == 0)
+				{
+					for (std::size_t i = 0; i < motion_num; ++i) blend_data_.at(i).base = model_->motionPool().at(i).mp();
+					next_count_ = 1;
+					next_ret_ = 1;
+				}
+
+				// 保存当前命令的输出，下一条命令结束后保持其最后的输出 //
+				for (std::size_t i = 0; i < motion_num; ++i)
+				{
+					blend_data_.at(i).p = model_->motionPool().at(i).mp();
+					blend_data_.at(i).v = model_->motionPool().at(i).mv();
+				}
+				if (next_ret_ > 0)
+				{
+					aris::dynamic::PlanParam next_param{ model_, next_count_, next->data(), static_cast<std::uint32_t>(next->size()) };
+					next_ret_ = this->plan_vec_.at(static_cast<std::size_t>(next->header().reserved1_)).operator()(next_param);
+					++next_count_;
+					for (std::size_t i = 0; i < motion_num; ++i)
+					{
+						blend_data_.at(i).next_p = model_->motionPool().at(i).mp();
+						blend_data_.at(i).next_v = model_->motionPool().at(i).mv();
+					}
+				}
+				for (std::size_t i = 0; i < motion_num; ++i)
+				{
+					auto &mm = model_->motionPool().at(i);
+					auto &bd = blend_data_.at(i);
+					if (!mm.active())continue;
+					mm.setMp(bd.p + bd.next_p - bd.base);
+					mm.setMv(bd.v + bd.next_v);
+					// 当前命令结束后，下一条命令的输出需要加上当前命令最终的位移 //
+					if (ret == 0)bd.offset = bd.p - bd.base;
+				}
+
+				// 融合后的结果需要同时满足两条命令的检查 //
+				option &= next->header().reserved2_;
+			}
 
 			// 控制电机 //
 			for (std::size_t i = 0; i < controller_->motionPool().size(); ++i)
@@ -316,73 +403,84 @@ namespace aris
 				auto &cm = controller_->motionPool().at(i);
 				auto &mm = model_->motionPool().at(i);
 				
+				// 只有没有经过这里写入的目标位置才需要从电机读取 //
+				if (mm.active() && (option & USING_TARGET_POS)) target_pos_[i] = mm.mp();
+				else target_pos_[i] = cm.targetPos();
+
 				if (mm.active())
 				{
-					if ((msg_queue_[current_cmd_].header().reserved2_ & USING_TARGET_POS))cm.setTargetPos(mm.mp());
-					if ((msg_queue_[current_cmd_].header().reserved2_ & USING_TARGET_VEL))cm.setTargetVel(mm.mv());
-					if ((msg_queue_[current_cmd_].header().reserved2_ & USING_TARGET_CUR))cm.setTargetCur(mm.mf());
-					if ((msg_queue_[current_cmd_].header().reserved2_ & USING_VEL_OFFSET))cm.setOffsetVel(mm.mv());
-					if ((msg_queue_[current_cmd_].header().reserved2_ & USING_CUR_OFFSET))cm.setOffsetCur(mm.mf());
+					if ((option & USING_TARGET_POS))cm.setTargetPos(mm.mp());
+					if ((option & USING_TARGET_VEL))cm.setTargetVel(mm.mv());
+					if ((option & USING_TARGET_CUR))cm.setTargetCur(mm.mf());
+					if ((option & USING_VEL_OFFSET))cm.setOffsetVel(mm.mv());
+					if ((option & USING_CUR_OFFSET))cm.setOffsetCur(mm.mf());
 				}
 			}
 
 			// 检查规划的指令是否合理（包括电机是否已经跟随上） //
-			for (std::size_t i = 0; i < controller_->motionPool().size(); ++i)
+			// 先在连续的数组上做一次无分支的批量检查，只有出错时才逐个电机查找并输出 //
+			auto &st = controller_->motionState();
+			const auto n = st.target_pos_.size();
+			const double *tp = target_pos_.data(), *lp = st.target_pos_.data(), *ap = st.actual_pos_.data();
+			const double *max_pos = st.max_pos_.data(), *min_pos = st.min_pos_.data(), *max_vel = st.max_vel_.data(), *max_fe = st.max_pos_following_error_.data();
+			int over_max{ 0 }, under_min{ 0 }, discontinuous{ 0 }, following_error{ 0 };
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				over_max |= tp[i] > max_pos[i];
+				under_min |= tp[i] < min_pos[i];
+				discontinuous |= std::abs(tp[i] - lp[i]) > 0.001 * max_vel[i];
+				following_error |= std::abs(tp[i] - ap[i]) > max_fe[i];
+			}
+			over_max &= !(option & NOT_CHECK_POS_MAX);
+			under_min &= !(option & NOT_CHECK_POS_MIN);
+			discontinuous &= !(option & NOT_CHECK_POS_PLAN_CONTINUOUS);
+			following_error &= !(option & NOT_CHECK_POS_FOLLOWING_ERROR);
+
+			for (std::size_t i = 0; (over_max | under_min | discontinuous | following_error) && i < n; ++i)
 			{
 				auto &cm = controller_->motionPool().at(i);
 				
 				// check max pos //
-				if (!(msg_queue_[current_cmd_].header().reserved2_ & NOT_CHECK_POS_MAX) && (cm.targetPos() > cm.maxPos()))
+				if (over_max && tp[i] > max_pos[i])
 				{
-					server_->controller().mout() << "Motor " << cm.id() << " (sla id) target position is bigger than its MAX permitted value in count: " << count_ << "\n";
-					server_->controller().mout() << "The min, max and current count using ABS sequence are:\n";
-					for (auto &cm1 : controller_->motionPool())server_->controller().mout() << cm1.minPos() << "\t" << cm1.maxPos() << "\t" << cm1.targetPos() << "\n";
+					server_->controller().rtLog("Motor {} (sla id) target position is bigger than its MAX permitted value in count: {}", cm.id(), count_);
+					server_->controller().rtLog("The min, max and current count using ABS sequence are:");
+					for (std::size_t j = 0; j < n; ++j)server_->controller().rtLog("{}\t{}\t{}", min_pos[j], max_pos[j], tp[j]);
 					onRunError();
 					return 0;
 				}
 
 				// check min pos //
-				if (!(msg_queue_[current_cmd_].header().reserved2_ & NOT_CHECK_POS_MIN) && (cm.targetPos() < cm.minPos()))
+				if (under_min && tp[i] < min_pos[i])
 				{
-					server_->controller().mout() << "Motor " << cm.id() << " (sla id) target position is smaller than its MIN permitted value in count: " << count_ << "\n";
-					server_->controller().mout() << "The min, max and current count using ABS sequence are:\n";
-					for (auto &cm1 : controller_->motionPool())server_->controller().mout() << cm1.minPos() << "\t" << cm1.maxPos() << "\t" << cm1.targetPos() << "\n";
+					server_->controller().rtLog("Motor {} (sla id) target position is smaller than its MIN permitted value in count: {}", cm.id(), count_);
+					server_->controller().rtLog("The min, max and current count using ABS sequence are:");
+					for (std::size_t j = 0; j < n; ++j)server_->controller().rtLog("{}\t{}\t{}", min_pos[j], max_pos[j], tp[j]);
 					onRunError();
 					return 0;
 				}
 
 				// check pos plan continuous //
-				if (!(msg_queue_[current_cmd_].header().reserved2_ & NOT_CHECK_POS_PLAN_CONTINUOUS) && (std::abs(cm.targetPos() - last_target_motion_data_vec_.at(i).p) > 0.001 * cm.maxVel()))
+				if (discontinuous && std::abs(tp[i] - lp[i]) > 0.001 * max_vel[i])
 				{
-					server_->controller().mout() << "Motor " << cm.id() << " (sla id) target position is not continuous in count: " << count_ << "\n";
-					server_->controller().mout() << "The pin of last and this count using ABS sequence are:\n";
-					for (std::size_t i = 0; i < controller_->motionPool().size(); ++i)server_->controller().mout() << last_target_motion_data_vec_.at(i).p << "\t" << controller_->motionPool().at(i).targetPos() << "\n";
+					server_->controller().rtLog("Motor {} (sla id) target position is not continuous in count: {}", cm.id(), count_);
+					server_->controller().rtLog("The pin of last and this count using ABS sequence are:");
+					for (std::size_t j = 0; j < n; ++j)server_->controller().rtLog("{}\t{}", lp[j], tp[j]);
 					onRunError();
 					return 0;
 				}
 
 				// check pos following error //
-				if (!(msg_queue_[current_cmd_].header().reserved2_ & NOT_CHECK_POS_FOLLOWING_ERROR) && (std::abs(cm.targetPos() - cm.actualPos()) > cm.maxPosFollowingError()))
+				if (following_error && std::abs(tp[i] - ap[i]) > max_fe[i])
 				{
-					server_->controller().mout() << "Motor " << cm.id() << " (sla id) target and feedback positions are not near in count: " << count_ << "\n";
-					server_->controller().mout() << "The pin of target and feedback using ABS sequence are:\n";
-					for (auto &cmp : controller_->motionPool())server_->controller().mout() << cmp.targetPos() << "\t" << cmp.actualPos() << "\n";
+					server_->controller().rtLog("Motor {} (sla id) target and feedback positions are not near in count: {}", cm.id(), count_);
+					server_->controller().rtLog("The pin of target and feedback using ABS sequence are:");
+					for (std::size_t j = 0; j < n; ++j)server_->controller().rtLog("{}\t{}", tp[j], ap[j]);
 					onRunError();
 					return 0;
 				}
 			}
 
-			// 储存电机指令 //
-			for (std::size_t i = 0; i < controller_->motionPool().size(); ++i)
-			{
-				last_target_motion_data_vec_.at(i).p = controller_->motionPool().at(i).targetPos();
-				last_target_motion_data_vec_.at(i).v = controller_->motionPool().at(i).targetVel();
-				last_target_motion_data_vec_.at(i).c = controller_->motionPool().at(i).targetCur();
-			}
-
-			// 如果是同步指令，那么通知等待线程结束 //
-			auto promise = reinterpret_cast<std::promise<void>*&>(msg_queue_[current_cmd_].header().reserved3_);
-			if (ret == 0 && promise)promise->set_value();
 			return ret;
 		}
 		auto ControlServer::Imp::onRunError()->int
@@ -409,16 +507,9 @@ namespace aris
 				}
 			}
 			
-			// 结束所有等待的指令 //
-			for (int i = -1; ++i < cmd_num_;)
-			{
-				auto promise = reinterpret_cast<std::promise<void>*&>(msg_queue_[current_cmd_ + i].header().reserved3_);
-				if (promise)promise->set_value();
-			}
-
-			// 清理命令 //
-			server_->controller().mout() << "All commands in command queue are discarded, please try to RECOVER\n";
-			cmd_num_ = 1;//因为这里为0退出,因此之后在tg中回递减cmd_num_,所以这里必须为1
+			// 清理命令，当前命令在tg中出队后丢弃其余的命令，并通知等待的线程 //
+			server_->controller().rtLog("All commands in command queue are discarded, please try to RECOVER");
+			discard_cmd_ = true;
 			count_ = 1;
 
 			return 0;
@@ -465,6 +556,13 @@ namespace aris
 			imp_->widget_root_ = findOrInsert<aris::server::WidgetRoot>("widget_root");
 		}
 		auto ControlServer::addCmd(const std::string &cmd_name, const ParseFunc &parse_func, const aris::dynamic::PlanFunction &plan_func)->void
+		{
+			// 旧的 parse 函数仍然接收 std::map，只在调用它时构造 //
+			ParamViewParseFunc view_func;
+			if (parse_func) view_func = [parse_func](const aris::core::ParamView &params, aris::core::Msg &msg_out) { parse_func(params.cmd(), params.toMap(), msg_out); };
+			addCmd(cmd_name, view_func, plan_func);
+		}
+		auto ControlServer::addCmd(const std::string &cmd_name, const ParamViewParseFunc &parse_func, const aris::dynamic::PlanFunction &plan_func)->void
 		{
 			std::unique_lock<std::recursive_mutex> running_lck(imp_->mu_running_);
 			if (imp_->is_running_)throw std::runtime_error("failed to ControlServer::addCmd, because it's already started");
@@ -488,34 +586,37 @@ namespace aris
 		}
 		auto ControlServer::executeCmd(const aris::core::Msg &msg)->void
 		{
-			std::unique_lock<std::recursive_mutex> running_lck(imp_->mu_running_);
+			// 不持有 mu_running_，多个线程可以同时提交命令 //
 			if (!imp_->is_running_)throw std::runtime_error("failed in ControlServer::executeCmd, because ControlServer is not running");
 
 			aris::core::log(msg.data());
 
+			// 等待当前已提交的命令全部执行完毕 //
+			auto wait_all_finished = [this]()
+			{
+				auto enqueue_pos = imp_->cmd_queue_.enqueuePos();
+				imp_->cmd_queue_.notifier().wait([&]() { return !imp_->is_running_ || imp_->cmd_queue_.finishedPos() >= enqueue_pos; });
+			};
+
 			// check parse condition //
-			if (!(msg.header().reserved1_ & PARSE_EVEN_IF_CMD_POOL_IS_FULL) && (imp_->cmd_num_ == Imp::CMD_POOL_SIZE))
+			if (!(msg.header().reserved1_ & PARSE_EVEN_IF_CMD_POOL_IS_FULL) && (imp_->cmd_queue_.size() >= CmdQueue::CMD_POOL_SIZE))
 			{
 				throw std::runtime_error("failed in ControlServer::executeCmd parse, because ControlServer is full");
 			}
-			if (msg.header().reserved1_ & PARSE_WHEN_ALL_PLAN_FINISHED)
-			{
-				while (imp_->cmd_num_ != 0)std::this_thread::sleep_for(std::chrono::milliseconds(50));
-			}
+			if (msg.header().reserved1_ & PARSE_WHEN_ALL_PLAN_FINISHED) wait_all_finished();
 
-			std::string cmd;
-			std::map<std::string, std::string> params;
-			widgetRoot().cmdParser().parse(msg.data(), cmd, params);
+			std::unique_lock<std::mutex> parse_lck(imp_->mu_parse_);
+			auto &params = imp_->param_view_;
+			widgetRoot().cmdParser().parse(msg.data(), params);
+			const std::string cmd = params.cmd();
 
 			// print cmd and params //
-			auto print_size = params.empty() ? 2 : 2 + std::max_element(params.begin(), params.end(), [](const auto& a, const auto& b)
-			{
-				return a.first.length() < b.first.length();
-			})->first.length();
+			std::size_t print_size = 2;
+			for (std::size_t i = 0; i < params.size(); ++i) print_size = std::max(print_size, 2 + params.name(i).length());
 			std::cout << cmd << std::endl;
-			for (auto &p : params)
+			for (std::size_t i = 0; i < params.size(); ++i)
 			{
-				std::cout << std::string(print_size - p.first.length(), ' ') << p.first << " : " << p.second << std::endl;
+				std::cout << std::string(print_size - params.name(i).length(), ' ') << params.name(i) << " : " << params.value(i) << std::endl;
 			}
 			std::cout << std::endl;
 			// print over //
@@ -524,41 +625,41 @@ namespace aris
 			aris::core::Msg cmd_msg = msg;
 			auto cmd_pair = imp_->cmd_id_map_.find(cmd);
 			if (cmd_pair == imp_->cmd_id_map_.end())throw std::runtime_error(std::string("command \"") + cmd + "\" does not have gait function, please AddCmd() first");
-			imp_->parser_vec_.at(cmd_pair->second).operator()(cmd, params, cmd_msg);
+			imp_->parser_vec_.at(cmd_pair->second).operator()(params, cmd_msg);
+			parse_lck.unlock();
 			if (cmd_msg.header().reserved1_ & NOT_EXECUTE_RT_PLAN) return;
-			if (!(msg.header().reserved1_ & EXECUTE_EVEN_IF_CMD_POOL_IS_FULL) && (imp_->cmd_num_ == Imp::CMD_POOL_SIZE))
-			{
-				throw std::runtime_error("failed in ControlServer::executeCmd execute, because ControlServer is full");
-			}
-			if (msg.header().reserved1_ & EXECUTE_WHEN_ALL_PLAN_FINISHED)
-			{
-				while (imp_->cmd_num_ != 0)std::this_thread::sleep_for(std::chrono::milliseconds(50));
-			}
+			if (msg.header().reserved1_ & EXECUTE_WHEN_ALL_PLAN_FINISHED) wait_all_finished();
 
 			if (imp_->plan_vec_.at(cmd_pair->second) == nullptr)throw std::runtime_error(std::string("command \"") + cmd + "\" have invalid gait function, it's nullptr");
-			
-			
-			
-			std::cout << cmd_msg.header().reserved1_ << "   " << cmd_msg.header().reserved2_ << "   " << cmd_msg.header().reserved3_ << "   " << std::endl;
+			if (cmd_msg.size() > aris::control::Master::MAX_MSG_SIZE)throw std::runtime_error(std::string("command \"") + cmd + "\" is too large");
+
 			// sync or async //
-			if (cmd_msg.header().reserved1_ & WAIT_FOR_RT_PLAN_EXECUTION)
-			{
-				cmd_msg.header().reserved1_ = cmd_pair->second;// using reserved 2 to store gait id
+			const bool wait_for_execution = (cmd_msg.header().reserved1_ & WAIT_FOR_RT_PLAN_EXECUTION) != 0;
+			cmd_msg.header().reserved1_ = cmd_pair->second;// using reserved 1 to store gait id
+			cmd_msg.header().reserved3_ = 0;
 
-				std::promise<void> cmd_finish_promise;
-				auto fut = cmd_finish_promise.get_future();
-				reinterpret_cast<std::promise<void> *&>(cmd_msg.header().reserved3_) = &cmd_finish_promise;
-				controller().sendIn(cmd_msg);
-				fut.wait();
-			}
-			else
+			// 直接写入实时线程的命令队列，队列满时除非指定 EXECUTE_EVEN_IF_CMD_POOL_IS_FULL，否则抛出异常 //
+			auto pos = imp_->cmd_queue_.push(cmd_msg);
+			if (pos < 0 && (msg.header().reserved1_ & EXECUTE_EVEN_IF_CMD_POOL_IS_FULL))
 			{
-				cmd_msg.header().reserved1_ = cmd_pair->second;// using reserved 2 to store gait id
+				imp_->cmd_queue_.notifier().wait([&]() { return !imp_->is_running_ || (pos = imp_->cmd_queue_.push(cmd_msg)) >= 0; });
+			}
+			if (pos < 0)throw std::runtime_error("failed in ControlServer::executeCmd execute, because ControlServer is full");
+			// 写入时 stop 可能已经清空了队列，这条命令会在下次 start 时丢弃 //
+			if (!imp_->is_running_)throw std::runtime_error("failed in ControlServer::executeCmd execute, because ControlServer is stopped");
 
-				reinterpret_cast<std::promise<void> *&>(cmd_msg.header().reserved3_) = nullptr;
-				controller().sendIn(cmd_msg);
+			if (wait_for_execution)
+			{
+				imp_->cmd_queue_.notifier().wait([&]() { return !imp_->is_running_ || imp_->cmd_queue_.finishedPos() > static_cast<std::uint64_t>(pos); });
 			}
 		}
+		auto ControlServer::setBlendWindow(std::uint32_t count)->void
+		{
+			std::unique_lock<std::recursive_mutex> running_lck(imp_->mu_running_);
+			if (imp_->is_running_)throw std::runtime_error("failed to ControlServer::setBlendWindow, because it's already started");
+			imp_->blend_window_ = count;
+		}
+		auto ControlServer::blendWindow()const->std::uint32_t { return imp_->blend_window_; }
 		auto ControlServer::start()->void
 		{
 			std::unique_lock<std::recursive_mutex> running_lck(imp_->mu_running_);
@@ -566,10 +667,24 @@ namespace aris
 			imp_->is_running_ = true;
 
 			// 得到电机向量以及数据 //
-			imp_->last_target_motion_data_vec_.clear();
-			imp_->last_target_motion_data_vec_.resize(controller().slavePool().size(), Imp::PVC{ 0,0,0 });
+			// motionPool() 在 controller 启动时才建立，这里按从站数分配 //
+			imp_->target_pos_.assign(controller().slavePool().size(), 0.0);
+			imp_->blend_data_.clear();
+			imp_->blend_data_.resize(controller().slavePool().size(), Imp::BlendData{ 0,0,0,0,0,0 });
+			imp_->count_ = 1;
+			imp_->next_count_ = 0;
+			imp_->has_blend_offset_ = false;
+
+			// stop 之后才写入的命令不能在这次执行 //
+			imp_->cmd_queue_.clear();
+			imp_->discard_cmd_ = false;
 
 			controller().setControlStrategy([this]() {this->imp_->tg(); });
+			controller().setRtLogHandler([](const std::string &text) 
+			{
+				std::cout << text << std::endl;
+				aris::core::log(text);
+			});
 
 			sensorRoot().start();
 			controller().start();
@@ -579,9 +694,14 @@ namespace aris
 			std::unique_lock<std::recursive_mutex> running_lck(imp_->mu_running_);
 			if (!imp_->is_running_)throw std::runtime_error("failed to ControlServer::stop, because it's not started");
 			imp_->is_running_ = false;
+			imp_->cmd_queue_.notifier().notify();
 
 			controller().stop();
 			sensorRoot().stop();
+
+			// 实时线程已经停止，丢弃未执行的命令 //
+			imp_->cmd_queue_.clear();
+			imp_->discard_cmd_ = false;
 		}
 		ControlServer::~ControlServer() = default;
 		ControlServer::ControlServer() :imp_(new Imp(this))
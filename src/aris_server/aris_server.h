@@ -22,6 +22,8 @@ namespace aris
 		enum { MAX_MOTOR_NUM = 100 };
 
 		using ParseFunc = std::function<void(const std::string &cmd, const std::map<std::string, std::string> &params, aris::core::Msg &msg_out)>;
+		/// 直接读取解析结果，不构造 std::map，参数值只在 parse 函数返回之前有效
+		using ParamViewParseFunc = std::function<void(const aris::core::ParamView &params, aris::core::Msg &msg_out)>;
 
 		class ControlServer : public aris::core::Object
 		{
@@ -50,6 +52,7 @@ namespace aris
 				USING_TARGET_CUR = 0x0400,
 				USING_VEL_OFFSET = 0x0800,
 				USING_CUR_OFFSET = 0x1000,
+				USING_BLEND = 0x2000,
 			};
 			static auto instance()->ControlServer &;
 			static auto Type()->const std::string &{ static const std::string type("ControlServer"); return type; }
@@ -77,7 +80,17 @@ namespace aris
 			auto widgetRoot()const->const WidgetRoot&{ return const_cast<ControlServer *>(this)->widgetRoot(); }
 
 			auto addCmd(const std::string &cmd_name, const ParseFunc &parse_func, const aris::dynamic::PlanFunction &gait_func)->void;
+			auto addCmd(const std::string &cmd_name, const ParamViewParseFunc &parse_func, const aris::dynamic::PlanFunction &gait_func)->void;
 			auto executeCmd(const aris::core::Msg &cmd_string)->void;
+			/// 命令融合的窗口（周期数），为 0 时不融合
+			///
+			/// 当前命令的 plan 返回的剩余周期数不大于窗口时，若下一条命令已在队列中，则同时执行下一条命令，
+			/// 电机目标位置为当前命令的输出加上下一条命令相对于融合起点的位移，速度为两者之和，并对融合的结果做检查。
+			/// 融合起点为下一条命令开始的那个周期中，当前命令写入 model 的 mp()，下一条命令的 plan 在 count 为 1 时也应从 mp() 读取起点。
+			/// 融合需要命令主动开启：只有两条命令都设置了 USING_TARGET_POS 与 USING_BLEND 时才会融合。
+			/// 两条命令的 plan 会交替调用，plan 中的状态应储存在命令参数中，而不是静态变量中。
+			auto setBlendWindow(std::uint32_t count)->void;
+			auto blendWindow()const->std::uint32_t;
 			auto start()->void;
 			auto stop()->void;
 
@@ -103,10 +116,13 @@ namespace aris
 		auto default_disable_plan(const aris::dynamic::PlanParam &plan_param)->int;
 		auto default_mode_plan(const aris::dynamic::PlanParam &plan_param)->int;
 		auto default_home_plan(const aris::dynamic::PlanParam &plan_param)->int;
+		// 打印 controller 的实时周期统计，不进入实时线程，使用 addCmd("st", default_statistics_parse, nullptr) 添加 //
+		auto default_statistics_parse(const std::string &cmd, const std::map<std::string, std::string> &params, aris::core::Msg &msg_out)->void;
 		auto default_enable_command()->const aris::core::Command &;
 		auto default_disable_command()->const aris::core::Command &;
 		auto default_home_command()->const aris::core::Command &;
 		auto default_mode_command()->const aris::core::Command &;
+		auto default_statistics_command()->const aris::core::Command &;
 	}
 }
 
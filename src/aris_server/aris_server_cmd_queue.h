@@ -0,0 +1,138 @@
+﻿#ifndef ARIS_SERVER_CMD_QUEUE_H
+#define ARIS_SERVER_CMD_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <chrono>
+#include <thread>
+
+#ifdef UNIX
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+#include <aris_core.h>
+#include <aris_control.h>
+
+// ControlServer 内部使用的命令队列，不随库安装，单独成文件以便测试 //
+namespace aris
+{
+	namespace server
+	{
+		// 命令完成的通知，实时线程只修改原子变量，有等待者时才唤醒 //
+		// Linux 下使用 futex，Xenomai 的实时线程不能调用 Linux 系统调用，因此等待者退化为轮询 //
+		class CmdNotifier
+		{
+		public:
+			auto notify()->void
+			{
+				event_.fetch_add(1);
+#if defined(UNIX) && !defined(USE_XENOMAI)
+				if (waiter_num_.load() > 0) syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&event_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+			}
+			template<typename Pred>
+			auto wait(Pred pred)->void
+			{
+				while (!pred())
+				{
+#if defined(UNIX) && !defined(USE_XENOMAI)
+					auto event = event_.load();
+					++waiter_num_;
+					if (!pred())
+					{
+						timespec timeout{ 0, 10000000 };
+						syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&event_), FUTEX_WAIT_PRIVATE, event, &timeout, nullptr, 0);
+					}
+					--waiter_num_;
+#else
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+				}
+			}
+
+		private:
+			std::atomic<std::uint32_t> event_{ 0 };
+			std::atomic<int> waiter_num_{ 0 };
+		};
+		// 多生产者单消费者的命令队列，槽位预先分配，实时线程直接在槽位中执行命令 //
+		// 每个槽位的 seq_ 为 pos 时可写入，为 pos + 1 时可执行，执行完后置为 pos + CMD_POOL_SIZE //
+		class CmdQueue
+		{
+		public:
+			enum { CMD_POOL_SIZE = 64 };
+			struct Slot
+			{
+				std::atomic<std::uint64_t> seq_;
+				aris::core::MsgFix<aris::control::Master::MAX_MSG_SIZE> msg_;
+			};
+
+			// 非实时线程调用，成功返回命令的序号，队列满时返回 -1 //
+			auto push(const aris::core::MsgBase &msg)->std::int64_t
+			{
+				auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					auto &slot = slots_[pos % CMD_POOL_SIZE];
+					auto diff = static_cast<std::int64_t>(slot.seq_.load(std::memory_order_acquire) - pos);
+					if (diff == 0)
+					{
+						if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							std::copy_n(reinterpret_cast<const char*>(&msg.header()), msg.size() + sizeof(aris::core::MsgHeader), reinterpret_cast<char*>(&slot.msg_.header()));
+							slot.seq_.store(pos + 1, std::memory_order_release);
+							return static_cast<std::int64_t>(pos);
+						}
+					}
+					else if (diff < 0) return -1;
+					else pos = enqueue_pos_.load(std::memory_order_relaxed);
+				}
+			}
+			// 实时线程调用 //
+			auto front()->aris::core::MsgBase* 
+			{
+				auto &slot = slots_[dequeue_pos_ % CMD_POOL_SIZE];
+				return slot.seq_.load(std::memory_order_acquire) == dequeue_pos_ + 1 ? &slot.msg_ : nullptr;
+			}
+			auto next()->aris::core::MsgBase*
+			{
+				if (!front())return nullptr;
+				auto &slot = slots_[(dequeue_pos_ + 1) % CMD_POOL_SIZE];
+				return slot.seq_.load(std::memory_order_acquire) == dequeue_pos_ + 2 ? &slot.msg_ : nullptr;
+			}
+			auto pop()->void
+			{
+				slots_[dequeue_pos_ % CMD_POOL_SIZE].seq_.store(dequeue_pos_ + CMD_POOL_SIZE, std::memory_order_release);
+				finished_pos_.store(++dequeue_pos_);
+				notifier_.notify();
+			}
+			// 只能在实时线程不运行时调用，等待正在写入的命令写完，然后丢弃队列中所有的命令 //
+			auto clear()->void
+			{
+				while (dequeue_pos_ < enqueue_pos_.load())
+				{
+					if (front()) pop();
+					else std::this_thread::yield();
+				}
+			}
+			// 任意线程调用 //
+			auto size()const->std::size_t { return static_cast<std::size_t>(enqueue_pos_.load() - finished_pos_.load()); }
+			auto enqueuePos()const->std::uint64_t { return enqueue_pos_.load(); }
+			auto finishedPos()const->std::uint64_t { return finished_pos_.load(); }
+			auto notifier()->CmdNotifier& { return notifier_; }
+
+			CmdQueue() { for (std::uint64_t i = 0; i < CMD_POOL_SIZE; ++i)slots_[i].seq_.store(i); }
+
+		private:
+			Slot slots_[CMD_POOL_SIZE];
+			std::atomic<std::uint64_t> enqueue_pos_{ 0 };
+			std::atomic<std::uint64_t> finished_pos_{ 0 };
+			std::uint64_t dequeue_pos_{ 0 };
+			CmdNotifier notifier_;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,42 @@
+﻿#include <iostream>
+#include <fstream>
+
+#include <aris.h>
+
+// 将 DataLogger 写出的二进制日志转换为 csv：aris_log_convert <log.bin> [out.csv] //
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: aris_log_convert <log.bin> [out.csv]" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		aris::control::DataLogReader reader;
+		reader.open(argv[1]);
+
+		const char *type_name[]{ "int32", "int64", "float32", "float64" };
+		std::cout << argv[1] << " : " << reader.rowSize() << " rows" << std::endl;
+		for (auto &c : reader.channels())
+			std::cout << "  " << c.name_ << " " << type_name[c.type_] << (c.unit_.empty() ? "" : " [" + c.unit_ + "]") << std::endl;
+
+		std::string out_name = argc > 2 ? argv[2] : std::string(argv[1]) + ".csv";
+		std::ofstream out(out_name.c_str());
+		if (!out.is_open())
+		{
+			std::cout << "failed to open " << out_name << std::endl;
+			return 1;
+		}
+		reader.writeCsv(out);
+		std::cout << "write to " << out_name << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -1,4 +1,6 @@
 ﻿#include <iostream>
+#include <atomic>
+#include <memory>
 #include <aris_control.h>
 #include "test_control_ethercat.h"
 
@@ -249,6 +251,58 @@ void test_data_logger()
 	}
 }
 
+void test_sdo_async()
+{
+	try
+	{
+		aris::control::EthercatMaster m;
+		std::vector<EthercatSlave*> slaves;
+		for (std::uint16_t i = 0; i < 6; ++i)slaves.push_back(&m.slavePool().add<EthercatSlave>("s" + std::to_string(i), i, 0x0000009a, 0x00030924, 0x000103F6, 0x0300));
+
+		// 在实时线程中提交写请求并查询结果 //
+		SdoRequest rt_write, rt_read;
+		rt_write.setWrite(0x6098, 0x00, static_cast<std::int8_t>(16));
+		rt_read.setRead(0x6098, 0x00, 1);
+		std::atomic<int> rt_state{ 0 };
+		m.setControlStrategy([&]()
+		{
+			switch (rt_state)
+			{
+			case 0: if (slaves[0]->submitSdo(rt_write)) rt_state = 1; break;
+			case 1: if (rt_write.finished() && slaves[0]->submitSdo(rt_read)) rt_state = 2; break;
+			case 2: if (rt_read.finished()) rt_state = 3; break;
+			}
+		});
+		if (slaves[0]->submitSdo(rt_write))std::cout << "EthercatSlave::submitSdo() failed: submitted before start" << std::endl;
+
+		m.start();
+
+		// 启动时批量配置，所有从站的请求一起提交 //
+		std::vector<std::unique_ptr<SdoRequest>> batch;
+		for (auto s : slaves)for (std::uint8_t sub = 1; sub <= 40; ++sub)
+		{
+			batch.push_back(std::unique_ptr<SdoRequest>(new SdoRequest));
+			batch.back()->setWrite(0x2000, sub, static_cast<std::int32_t>(s->phyId() * 100 + sub));
+			if (!s->submitSdo(*batch.back()))std::cout << "EthercatSlave::submitSdo() failed: batch submit" << std::endl;
+		}
+		for (auto &r : batch)if (r->wait() != SdoRequest::SUCCESS)std::cout << "SdoRequest::wait() failed: batch write" << std::endl;
+
+		SdoRequest check;
+		check.setRead(0x2000, 7, sizeof(std::int32_t));
+		slaves[3]->submitSdo(check);
+		if (check.wait() != SdoRequest::SUCCESS || check.value<std::int32_t>() != 307)std::cout << "SdoRequest::value() failed" << std::endl;
+
+		for (int i = 0; i < 1000 && rt_state != 3; ++i)std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		m.stop();
+
+		if (rt_state != 3 || rt_read.state() != SdoRequest::SUCCESS || rt_read.value<std::int8_t>() != 16)std::cout << "EthercatSlave::submitSdo() failed: rt request" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+
 void test_control_ethercat()
 {
 	test_pdo_code();
@@ -256,4 +310,5 @@ void test_control_ethercat()
 	//test_sdo_code();
 	//test_sdo_xml();
 	test_data_logger();
+	test_sdo_async();
 }
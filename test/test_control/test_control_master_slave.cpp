@@ -1,4 +1,11 @@
 ﻿#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#ifdef UNIX
+#include <unistd.h>
+#endif
 #include <aris_control.h>
 #include "test_control_master_slave.h"
 
@@ -21,7 +28,205 @@ void test_construct()
 	std::cout << m.xmlString() << std::endl;
 }
 
+void test_statistics()
+{
+	aris::control::Master m;
+	m.setControlStrategy([]() {});
+	m.start();
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	m.stop();
+
+	auto stat = m.statistics();
+	if (stat.cycle_count_ == 0)std::cout << "Master::statistics() failed: no cycle recorded" << std::endl;
+	for (auto &s : { stat.latency_, stat.recv_, stat.strategy_, stat.sync_, stat.send_, stat.cycle_ })
+	{
+		if (!(s.min_ns_ <= s.p50_ns_ && s.p50_ns_ <= s.p99_ns_ && s.p99_ns_ <= s.p999_ns_ && s.p999_ns_ <= s.max_ns_))
+			std::cout << "Master::statistics() failed: percentiles not ordered" << std::endl;
+	}
+	std::cout << "cycle count:" << stat.cycle_count_ << " overrun count:" << stat.overrun_count_ << std::endl;
+	std::cout << "latency min:" << stat.latency_.min_ns_ << " p99:" << stat.latency_.p99_ns_ << " max:" << stat.latency_.max_ns_ << std::endl;
+	std::cout << "cycle   min:" << stat.cycle_.min_ns_ << " p99:" << stat.cycle_.p99_ns_ << " max:" << stat.cycle_.max_ns_ << std::endl;
+}
+
+void test_rt_timer()
+{
+	aris::control::Master m;
+	m.rtTimer().loadXmlStr("<rt_timer type=\"RTTimer\" priority=\"0\" cpu=\"0\" spin_ns=\"20000\"/>");
+	if (m.rtTimer().config().cpu_ != 0 || m.rtTimer().config().spin_ns_ != 20000)std::cout << "RTTimer::loadXml() failed" << std::endl;
+
+	m.setControlStrategy([]() {});
+	m.start();
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	m.stop();
+
+	auto stat = m.statistics();
+	if (stat.cycle_count_ == 0)std::cout << "RTTimer with spin failed: no cycle recorded" << std::endl;
+	std::cout << "spin latency min:" << stat.latency_.min_ns_ << " p99:" << stat.latency_.p99_ns_ << " max:" << stat.latency_.max_ns_ << std::endl;
+}
+
+void test_rt_start_failed()
+{
+	aris::control::Master m;
+	m.setControlStrategy([]() {});
+
+	// 绑定到不存在的 cpu 上，实时线程无法启动 //
+	m.rtTimer().loadXmlStr("<rt_timer type=\"RTTimer\" priority=\"0\" cpu=\"100000\" spin_ns=\"0\"/>");
+	try
+	{
+		m.start();
+		m.stop();
+#ifdef UNIX
+		std::cout << "Master::start() failed: no exception with invalid cpu" << std::endl;
+#endif
+	}
+	catch (std::runtime_error &e)
+	{
+		if (std::string(e.what()).find("errno") == std::string::npos)std::cout << "Master::start() failed: no errno in \"" << e.what() << "\"" << std::endl;
+		try { m.stop(); std::cout << "Master::stop() failed: stopped a master that is not running" << std::endl; }
+		catch (std::runtime_error &) {}
+	}
+
+	// 回滚后可以正常启动 //
+	m.rtTimer().loadXmlStr("<rt_timer type=\"RTTimer\" priority=\"0\" cpu=\"-1\" spin_ns=\"0\"/>");
+	m.start();
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	m.stop();
+	if (m.statistics().cycle_count_ == 0)std::cout << "Master::start() failed: no cycle after rollback" << std::endl;
+}
+
+void test_rt_log()
+{
+	aris::control::Master m;
+
+	std::vector<std::string> texts;
+	m.setRtLogHandler([&](const std::string &text) { texts.push_back(text); });
+
+	int count{ 0 };
+	m.setControlStrategy([&]()
+	{
+		++count;
+		if (count <= 3) m.rtLog("count {} pos {} name {}", count, 0.5 * count, "abc");
+		if (count == 5) for (int i = 0; i < 10000; ++i)m.rtLog("overflow");
+		if (count == 50) m.rtLog("more args:", std::uint16_t(1), -2);
+	});
+	m.start();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	m.stop();
+
+	if (texts.size() < 5)std::cout << "Master::rtLog() failed: not enough records" << std::endl;
+	else
+	{
+		if (texts[0] != "count 1 pos 0.5 name abc" || texts[2] != "count 3 pos 1.5 name abc")std::cout << "Master::rtLog() failed: format not correct" << std::endl;
+		if (texts.back().find("rt log dropped) more args: 1 -2") == std::string::npos)std::cout << "Master::rtLog() failed: dropped count not correct" << std::endl;
+	}
+}
+
+void test_binary_log()
+{
+	aris::control::DataLogger logger;
+	auto pos = logger.addChannel("pos", DataLogger::FLOAT64, "m");
+	auto cur = logger.addChannel("cur", DataLogger::FLOAT32, "A");
+	auto status = logger.addChannel("status", DataLogger::INT32);
+	auto stamp = logger.addChannel("stamp", DataLogger::INT64, "ns");
+	const std::int64_t stamp_base = (std::int64_t(1) << 60) + 1;// 超过 2^53，经过 double 时会损失精度
+
+	const int record_num = 2500;
+	logger.start("test_binary_log.bin");
+	for (int i = 0; i < record_num; ++i)
+	{
+		if (i == 100) { logger.beginRecord(); continue; }// 未提交的记录视为丢弃
+
+		while (!logger.beginRecord())std::this_thread::sleep_for(std::chrono::microseconds(100));
+		logger.setChannel(pos, 0.001 * i);
+		logger.setChannel(cur, 0.5 * i);
+		logger.setChannel(status, i);
+		logger.setChannel(stamp, static_cast<std::size_t>(stamp_base + i));
+		logger.commitRecord();
+	}
+	logger.stop();
+
+	aris::control::DataLogReader reader;
+	reader.open(aris::core::logDirPath() + "test_binary_log.bin");
+	if (reader.channels().size() != 4 || reader.channels()[0].name_ != "pos" || reader.channels()[1].unit_ != "A" || reader.channels()[2].type_ != DataLogger::INT32)
+		std::cout << "DataLogReader::channels() failed" << std::endl;
+	if (reader.rowSize() != record_num - 1)std::cout << "DataLogReader::rowSize() failed" << std::endl;
+
+	auto index = reader.indexColumn();
+	auto pos_col = reader.column(pos), cur_col = reader.column(cur), status_col = reader.column(status);
+	for (std::size_t r = 0; r < index.size(); ++r)
+	{
+		auto i = index[r];
+		if (i != (r < 100 ? r : r + 1) || pos_col[r] != 0.001 * i || cur_col[r] != 0.5 * i || status_col[r] != i)
+		{
+			std::cout << "DataLogReader::column() failed at row " << r << std::endl;
+			break;
+		}
+	}
+	auto stamp_col = reader.intColumn(stamp);
+	for (std::size_t r = 0; r < index.size(); ++r)
+	{
+		if (stamp_col[r] != stamp_base + static_cast<std::int64_t>(index[r]))
+		{
+			std::cout << "DataLogReader::intColumn() failed at row " << r << std::endl;
+			break;
+		}
+	}
+
+	std::stringstream ss;
+	reader.writeCsv(ss);
+	std::string line;
+	std::getline(ss, line);
+	if (line != "index,pos[m],cur[A],status,stamp[ns]")std::cout << "DataLogReader::writeCsv() failed: title not correct" << std::endl;
+	std::getline(ss, line);
+	if (line != "0,0,0,0," + std::to_string(stamp_base))std::cout << "DataLogReader::writeCsv() failed: data not correct" << std::endl;
+
+	// stop 时还未提交的记录不能进入下一次的日志，下一次的序号从 0 开始 //
+	logger.start("test_binary_log_session.bin");
+	for (int i = 0; i < 5; ++i) { while (!logger.beginRecord())std::this_thread::sleep_for(std::chrono::microseconds(100)); logger.commitRecord(); }
+	while (!logger.beginRecord())std::this_thread::sleep_for(std::chrono::microseconds(100));
+	logger.setChannel(status, -1);
+	logger.stop();
+	logger.commitRecord();
+	logger.start("test_binary_log_session.bin");
+	for (int i = 0; i < 3; ++i)
+	{
+		while (!logger.beginRecord())std::this_thread::sleep_for(std::chrono::microseconds(100));
+		logger.setChannel(status, i);
+		logger.commitRecord();
+	}
+	logger.stop();
+	reader.open(aris::core::logDirPath() + "test_binary_log_session.bin");
+	if (reader.rowSize() != 3 || reader.indexColumn() != std::vector<std::uint64_t>{ 0, 1, 2 } || reader.intColumn(status) != std::vector<std::int64_t>{ 0, 1, 2 })
+		std::cout << "DataLogger::start() failed: records of the last session not discarded" << std::endl;
+
+#ifdef UNIX
+	// 写入失败时需要报告，/dev/full 的写入总是返回 ENOSPC //
+	aris::core::createLogDir();
+	auto full_link = aris::core::logDirPath() + "test_binary_log_full.bin";
+	std::remove(full_link.c_str());
+	if (symlink("/dev/full", full_link.c_str()) == 0)
+	{
+		try
+		{
+			logger.start("test_binary_log_full.bin");
+			logger.stop();
+			std::cout << "DataLogger::start() failed: write error not reported" << std::endl;
+		}
+		catch (std::runtime_error &e)
+		{
+			if (std::string(e.what()).find(std::strerror(ENOSPC)) == std::string::npos)std::cout << "DataLogger::start() failed: wrong error \"" << e.what() << "\"" << std::endl;
+		}
+		std::remove(full_link.c_str());
+	}
+#endif
+}
+
 void test_control_master_slave()
 {
 	test_construct();
+	test_statistics();
+	test_rt_timer();
+	test_rt_start_failed();
+	test_rt_log();
+	test_binary_log();
 }
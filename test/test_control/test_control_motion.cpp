@@ -1,4 +1,6 @@
 ﻿#include <iostream>
+#include <cmath>
+#include <chrono>
 #include <aris_control.h>
 #include "test_control_ethercat.h"
 #include "test_control_motion.h"
@@ -103,9 +105,118 @@ void test_elmo_enable()
 	}
 }
 
+void test_sim_drive()
+{
+	try
+	{
+		aris::control::EthercatMaster m;
+
+		auto &s1 = m.slavePool().add<EthercatMotion>("s1", 0, 0x0000009a, 0x00030924, 0x000103F6, 0x0300, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+
+		auto &tx = s1.pdoGroupPool().add<PdoGroup>("index_1A00", 0x1A00, true);
+		tx.add<Pdo>("index_6064", 0x6064, 0x00, sizeof(std::int32_t));
+		tx.add<Pdo>("index_606c", 0x606c, 0x00, sizeof(std::int32_t));
+		tx.add<Pdo>("index_6041", 0x6041, 0x00, sizeof(std::uint16_t));
+		tx.add<Pdo>("index_6061", 0x6061, 0x00, sizeof(std::uint8_t));
+		tx.add<Pdo>("index_6078", 0x6078, 0x00, sizeof(std::int16_t));
+
+		auto &rx = s1.pdoGroupPool().add<PdoGroup>("index_1605", 0x1605, false);
+		rx.add<Pdo>("index_607A", 0x607A, 0x00, sizeof(std::int32_t));
+		rx.add<Pdo>("index_60FF", 0x60FF, 0x00, sizeof(std::int32_t));
+		rx.add<Pdo>("index_6071", 0x6071, 0x00, sizeof(std::int16_t));
+		rx.add<Pdo>("index_6040", 0x6040, 0x00, sizeof(std::uint16_t));
+		rx.add<Pdo>("index_6060", 0x6060, 0x00, sizeof(std::uint8_t));
+
+		// 0 为使能， 1 为 cos 运动， 2 为注入故障， 3 为故障后使能， 4 为跟随误差故障， 5 为故障后使能， 6 为去使能 //
+		int count{ 0 }, cos_count{ 0 }, state{ 0 };
+		bool fault_found{ false }, following_error_found{ false };
+		double begin_pos{ 0.0 }, end_error{ 0.0 };
+		m.setControlStrategy([&]()
+		{
+			if (++count == 1)
+			{
+				EcSimDriveParam param;
+				param.max_following_error = 5000.0;
+				aris_ecrt_sim_set_drive_param(s1.ecHandle(), param);
+			}
+
+			int ret;
+			switch (state)
+			{
+			case 0:
+				s1.setModeOfOperation(8);
+				if (s1.enable() == 0)
+				{
+					state = 1;
+					begin_pos = s1.actualPos();
+				}
+				break;
+			case 1:
+				s1.setTargetPos(begin_pos + (1.0 - std::cos(std::min(++cos_count, 1000) / 1000.0 * 2.0 * 3.141592653)) * 10000);
+				if (cos_count == 1020)
+				{
+					end_error = s1.actualPos() - begin_pos;
+					aris_ecrt_sim_set_fault(s1.ecHandle());
+					state = 2;
+				}
+				break;
+			case 2:
+			case 4:
+				ret = s1.enable();
+				if (ret == 8) state == 2 ? fault_found = true : following_error_found = true;
+				if (ret == 0) 
+				{
+					if (state == 4) state = 5;
+					else
+					{
+						s1.setTargetPos(s1.actualPos() + 100000);
+						state = 3;
+					}
+				}
+				break;
+			case 3:
+				state = 4;
+				break;
+			case 5:
+				if (s1.disable() == 0)
+				{
+					m.mout() << "disabled at count " << count << '\0';
+					m.mout().update();
+					m.sendOut();
+					state = 6;
+				}
+				break;
+			default:
+				break;
+			}
+		});
+
+		aris_rt_set_time_scale(0.0);
+		auto begin_time = std::chrono::high_resolution_clock::now();
+		m.start();
+		aris::core::Msg msg;
+		while (!m.recvOut(msg))std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		m.stop();
+		auto end_time = std::chrono::high_resolution_clock::now();
+		aris_rt_set_time_scale(1.0);
+
+		if (std::abs(end_error) > 1.0)std::cout << "sim drive csp tracking failed" << std::endl;
+		if (!fault_found)std::cout << "sim drive fault injection failed" << std::endl;
+		if (!following_error_found)std::cout << "sim drive following error failed" << std::endl;
+
+		std::cout << msg.data() << std::endl;
+		std::cout << "sim drive cycle time:" << std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time).count() / count << "ns" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+
 void test_control_motion()
 {
 	std::cout << std::endl << "-----------------test motion---------------------" << std::endl;
+	test_sim_drive();
 	test_elmo_enable();
 	std::cout << "-----------------test motion finished------------" << std::endl << std::endl;
 
@@ -1,9 +1,14 @@
 ﻿#include <iostream>
 #include <condition_variable>
 #include <future>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <cmath>
 #include <aris.h>
 
 #include "test_control_server.h"
+#include "aris_server_cmd_queue.h"
 
 const char xml_data[] =
 "<?xml version=\"1.0\" encoding=\"utf-8\" ?>"
@@ -326,8 +331,215 @@ void test_construct()
 
 
 
+void test_cmd_queue()
+{
+	struct CmdData { int producer, seq; };
+	const int producer_num = 4, cmd_num = 2000, total = producer_num * cmd_num;
+
+	aris::server::CmdQueue queue;
+	std::vector<CmdData> pushed(total), executed(total);
+	std::atomic<int> error_count{ 0 };
+	std::atomic_bool is_blocked{ false };// 超时后让各线程退出，否则 future 析构时会一直等待
+
+	// 模拟实时线程，偶尔停顿使队列被写满 //
+	auto consumer = std::async(std::launch::async, [&]()
+	{
+		for (int i = 0; i < total && !is_blocked;)
+		{
+			auto msg = queue.front();
+			if (!msg) { std::this_thread::yield(); continue; }
+			executed[i] = *reinterpret_cast<const CmdData*>(msg->data());
+
+			// next() 只能看到紧随其后的命令 //
+			auto next = queue.next();
+			CmdData next_data = next ? *reinterpret_cast<const CmdData*>(next->data()) : CmdData{ -1, -1 };
+			queue.pop();
+			if (next && (!queue.front() || std::memcmp(queue.front()->data(), &next_data, sizeof(CmdData))))++error_count;
+
+			if (++i % 500 == 0)std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+
+	std::vector<std::future<void>> producers;
+	for (int p = 0; p < producer_num; ++p)
+	{
+		producers.push_back(std::async(std::launch::async, [&, p]()
+		{
+			for (int s = 0; s < cmd_num && !is_blocked; ++s)
+			{
+				aris::core::Msg msg;
+				msg.copyStruct(CmdData{ p, s });
+
+				// 与 ControlServer::executeCmd 相同：队列满时等待，之后等待命令执行完 //
+				auto pos = queue.push(msg);
+				if (pos < 0) queue.notifier().wait([&]() { return is_blocked || (pos = queue.push(msg)) >= 0; });
+				if (pos < 0)return;
+				if (pos >= total) { ++error_count; return; }
+				pushed[pos] = CmdData{ p, s };
+				if (s % 100 == 0)
+				{
+					queue.notifier().wait([&]() { return is_blocked || queue.finishedPos() > static_cast<std::uint64_t>(pos); });
+					if (queue.finishedPos() <= static_cast<std::uint64_t>(pos))++error_count;
+				}
+			}
+		}));
+	}
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+	for (auto &p : producers) if (p.wait_until(deadline) != std::future_status::ready) is_blocked = true;
+	if (consumer.wait_until(deadline) != std::future_status::ready) is_blocked = true;
+	if (is_blocked)
+	{
+		std::cout << "CmdQueue failed: blocked, " << queue.finishedPos() << " of " << total << " commands executed" << std::endl;
+		return;
+	}
+
+	// 执行顺序与 push 返回的序号一致，每个生产者的命令保持先后顺序 //
+	std::vector<int> last_seq(producer_num, -1);
+	for (int i = 0; i < total; ++i)
+	{
+		if (executed[i].producer != pushed[i].producer || executed[i].seq != pushed[i].seq) { ++error_count; break; }
+		if (executed[i].seq != last_seq[executed[i].producer] + 1) { ++error_count; break; }
+		last_seq[executed[i].producer] = executed[i].seq;
+	}
+	if (queue.size() != 0 || queue.finishedPos() != static_cast<std::uint64_t>(total))++error_count;
+
+	if (error_count)std::cout << "CmdQueue failed: " << error_count << " errors" << std::endl;
+
+	// clear 丢弃所有未执行的命令，之后的命令正常执行 //
+	aris::core::Msg msg;
+	for (int i = 0; i < 3; ++i) { msg.header().msg_id_ = i; queue.push(msg); }
+	queue.clear();
+	msg.header().msg_id_ = 100;
+	auto pos = queue.push(msg);
+	if (queue.size() != 1 || pos != total + 3 || !queue.front() || queue.front()->header().msg_id_ != 100)std::cout << "CmdQueue clear failed" << std::endl;
+}
+
+// 仿真电机，实际位置即为目标位置，并记录每个周期写入的目标 //
+class SimMotion :public aris::control::Motion
+{
+public:
+	auto virtual modeOfOperation()const->std::uint8_t override { return 8; }
+	auto virtual targetPos()const->double override { return target_pos_; }
+	auto virtual targetVel()const->double override { return target_vel_; }
+	auto virtual targetCur()const->double override { return 0.0; }
+	auto virtual offsetVel()const->double override { return 0.0; }
+	auto virtual offsetCur()const->double override { return 0.0; }
+	auto virtual setModeOfOperation(std::uint8_t mode)->void override {}
+	auto virtual setTargetPos(double pos)->void override { target_pos_ = pos; if (pos_log_.size() < pos_log_.capacity())pos_log_.push_back(pos); }
+	auto virtual setTargetVel(double vel)->void override { target_vel_ = vel; if (vel_log_.size() < vel_log_.capacity())vel_log_.push_back(vel); }
+	auto virtual setTargetCur(double cur)->void override {}
+	auto virtual setOffsetVel(double vel)->void override {}
+	auto virtual setOffsetCur(double cur)->void override {}
+	auto virtual modeOfDisplay()->std::uint8_t override { return 8; }
+	auto virtual actualPos()->double override { return target_pos_; }
+	auto virtual actualVel()->double override { return target_vel_; }
+	auto virtual actualCur()->double override { return 0.0; }
+	auto virtual disable()->int override { return 0; }
+	auto virtual enable()->int override { return 0; }
+	auto virtual home()->int override { return 0; }
+	auto virtual mode(std::uint8_t md)->int override { return 0; }
+
+	SimMotion(const std::string &name, std::uint16_t phy_id) :Slave(name, phy_id), Motion(name, phy_id, 10.0, -10.0, 10.0, 100.0)
+	{
+		pos_log_.reserve(10000);
+		vel_log_.reserve(10000);
+	}
+
+	double target_pos_{ 0.0 }, target_vel_{ 0.0 };
+	std::vector<double> pos_log_, vel_log_;// 预先分配，实时线程中不会重新分配内存
+};
+// 余弦速度曲线的点到点运动，起点在 count 为 1 时从 model 中读取 //
+struct BlendMoveParam
+{
+	double d, begin;
+	std::uint32_t t;
+};
+auto blend_move_parse(const aris::core::ParamView &params, aris::core::Msg &msg_out)->void
+{
+	BlendMoveParam param{ params.toDouble("d"), 0.0, static_cast<std::uint32_t>(params.toUint64("t")) };
+	msg_out.copyStruct(param);
+	msg_out.header().reserved2_ = aris::server::ControlServer::USING_TARGET_POS | aris::server::ControlServer::USING_TARGET_VEL 
+		| aris::server::ControlServer::NOT_CHECK_POS_FOLLOWING_ERROR | (params.toInt64("blend") == 1 ? aris::server::ControlServer::USING_BLEND : 0);
+}
+auto blend_move_plan(const aris::dynamic::PlanParam &param)->int
+{
+	auto p = reinterpret_cast<BlendMoveParam*>(param.param_);
+	auto &mm = param.model_->motionPool().at(0);
+	if (param.count_ == 1) p->begin = mm.mp();
+
+	const double dt = 0.001, s = aris::PI * param.count_ / p->t;
+	mm.setMp(p->begin + p->d * (1.0 - std::cos(s)) / 2.0);
+	mm.setMv(p->d * aris::PI / p->t / dt * std::sin(s) / 2.0);
+	return p->t - param.count_;
+}
+void test_blend()
+{
+	auto&cs = aris::server::ControlServer::instance();
+	cs.resetController(new aris::control::Controller);
+	cs.resetModel(new aris::dynamic::Model);
+	cs.resetSensorRoot(new aris::sensor::SensorRoot);
+	cs.resetWidgetRoot(new aris::server::WidgetRoot);
+
+	auto &sim = cs.controller().slavePool().add<SimMotion>("sim", 0);
+	cs.model().addMotion();
+
+	auto &mv = cs.widgetRoot().cmdParser().commandPool().add<aris::core::Command>("blend_mv", "", "gp");
+	auto &gp = mv.add<aris::core::GroupParam>("gp", "");
+	gp.add<aris::core::Param>("d", "0.1", "");
+	gp.add<aris::core::Param>("t", "200", "");
+	gp.add<aris::core::Param>("blend", "1", "");
+	cs.addCmd("blend_mv", blend_move_parse, blend_move_plan);
+
+	auto run = [&](const std::string &cmd1, const std::string &cmd2)
+	{
+		sim.pos_log_.clear();
+		sim.vel_log_.clear();
+		sim.target_pos_ = 0.0;
+		cs.model().motionPool().at(0).setMp(0.0);
+
+		cs.start();
+		cs.executeCmd(aris::core::Msg(cmd1));
+
+		// 等待第二条命令执行完毕，超时后 stop 会结束等待 //
+		aris::core::Msg msg2(cmd2);
+		msg2.header().reserved1_ |= aris::server::ControlServer::WAIT_FOR_RT_PLAN_EXECUTION;
+		auto finished = std::async(std::launch::async, [&]() { cs.executeCmd(msg2); });
+		if (finished.wait_for(std::chrono::seconds(20)) != std::future_status::ready)std::cout << "ControlServer blend failed: timeout" << std::endl;
+		cs.stop();
+		finished.get();
+	};
+
+	// 两条命令都开启融合：总周期数减少，终点不变，位置与速度连续 //
+	cs.setBlendWindow(50);
+	run("blend_mv --d=0.1 --t=200 --blend=1", "blend_mv --d=-0.05 --t=200 --blend=1");
+	auto &p = sim.pos_log_;
+	auto &v = sim.vel_log_;
+	if (p.size() != 349 || v.size() != p.size())std::cout << "ControlServer blend failed: " << p.size() << " counts executed" << std::endl;
+	else
+	{
+		if (std::abs(p.back() - 0.05) > 1e-12)std::cout << "ControlServer blend failed: final position " << p.back() << std::endl;
+		for (std::size_t i = 1; i < p.size(); ++i)
+		{
+			// 位移与平均速度一致，速度的变化不超过两条曲线加速度之和 //
+			if (std::abs(p[i] - p[i - 1] - (v[i] + v[i - 1]) / 2 * 0.001) > 1e-5 || std::abs(v[i] - v[i - 1]) > 0.03)
+			{
+				std::cout << "ControlServer blend failed: discontinuous at count " << i << std::endl;
+				break;
+			}
+		}
+	}
+
+	// 没有开启融合的命令依次执行 //
+	run("blend_mv --d=0.1 --t=200 --blend=1", "blend_mv --d=-0.05 --t=200 --blend=0");
+	if (p.size() != 400 || std::abs(p.back() - 0.05) > 1e-12)std::cout << "ControlServer blend failed: command without USING_BLEND is blended" << std::endl;
+	cs.setBlendWindow(0);
+}
+
 void test_control_server()
 {
+	test_cmd_queue();
+	test_blend();
 	//test_xml();
 	test_construct();
 
@@ -6,6 +6,7 @@
 #include "test_core_command.h"
 #include "test_core_msg.h"
 #include "test_core_pipe.h"
+#include "test_core_expression_calculator.h"
 
 int main(int argc, char *argv[])
 {
@@ -14,6 +15,7 @@ int main(int argc, char *argv[])
 	test_core_socket();
 	test_core_pipe();
 	test_command();
+	test_core_expression_calculator();
 
 	std::cout << "test_core finished, press any key to continue" << std::endl;
 	std::cin.get();
@@ -286,13 +286,94 @@ void test_command_code()
 		std::cout << e.what() << std::endl;
 	}
 }
+void test_command_view()
+{
+	try
+	{
+		aris::core::CommandParser parser("parser");
+		auto &tt = parser.commandPool().add<aris::core::Command>("tt", "ap0", "");
+		tt.add<aris::core::Param>("ap0", "", "", 'a');
+		auto &bu0 = tt.add<aris::core::UniqueParam>("bu0", "ap1", "");
+		bu0.add<aris::core::Param>("ap1", "0", "");
+		auto &bg1 = bu0.add<aris::core::GroupParam>("bg1", "");
+		bg1.add<aris::core::Param>("ap2", "1", "");
+		bg1.add<aris::core::Param>("bp2", "2", "", 'b');
+		auto &cg0 = tt.add<aris::core::GroupParam>("cg0", "");
+		cg0.add<aris::core::Param>("cp1", "0", "");
+		auto &dg1 = cg0.add<aris::core::GroupParam>("dg1", "");
+		dg1.add<aris::core::Param>("cp2", "3", "", 'c');
+		dg1.add<aris::core::Param>("dp2", "4", "", 'd');
+		auto &mv = parser.commandPool().add<aris::core::Command>("mv", "", "").add<aris::core::GroupParam>("mv_param", "");
+		mv.add<aris::core::Param>("pos", "0.5", "", 'p');
+		mv.add<aris::core::Param>("count", "10", "", 'n');
+		mv.add<aris::core::Param>("offset", "-3", "", 'o');
+
+		aris::core::ParamView view;
+		std::string cmd_result;
+		std::map<std::string, std::string> param_result;
+
+		// 与map接口的结果一致 //
+		for (auto cmd_string : { "tt", "tt -a", "tt --ap2", "tt --ap2=", "tt cd", "  tt   --ap1=7  ", "mv", "mv --pos=1.25 -n=3" })
+		{
+			parser.parse(cmd_string, cmd_result, param_result);
+			parser.parse(cmd_string, view);
+			if (view.cmd() != cmd_result || view.toMap() != param_result)std::cout << "cmd view parse failed \"" << cmd_string << "\"" << std::endl;
+		}
+
+		parser.parse("mv --pos=1.25 -n=3", view);
+		if (view.toDouble("pos") != 1.25)std::cout << "cmd view toDouble failed" << std::endl;
+		if (view.toUint64("count") != 3)std::cout << "cmd view toUint64 failed" << std::endl;
+		if (view.toInt64("offset") != -3)std::cout << "cmd view toInt64 failed" << std::endl;
+		if (view.has("ap0") || view.value("ap0") != nullptr)std::cout << "cmd view has failed" << std::endl;
+
+		// 拷贝后参数值指向新的缓冲区 //
+		aris::core::ParamView copy(view);
+		parser.parse("tt -a", view);
+		if (copy.cmd() != "mv" || copy.toDouble("pos") != 1.25 || copy.value("pos") == view.value("ap0"))std::cout << "cmd view copy failed" << std::endl;
+
+		try { parser.parse("mv --offset=abc", view); view.toInt64("offset"); std::cout << "cmd view toInt64 failed" << std::endl; }
+		catch (std::exception &) {};
+		try { parser.parse("mv", view); view.toUint64("offset"); std::cout << "cmd view toUint64 failed" << std::endl; }
+		catch (std::exception &) {};
+		try { parser.parse("mv --pos=1 --pos=2", view); std::cout << "cmd view parse failed \"mv --pos=1 --pos=2\"" << std::endl; }
+		catch (std::exception &) {};
+		try { parser.parse("xx", view); std::cout << "cmd view parse failed \"xx\"" << std::endl; }
+		catch (std::exception &) {};
 
+		// 修改参数树之后重新编译 //
+		mv.add<aris::core::Param>("speed", "2", "", 's');
+		parser.parse("mv -s=4", view);
+		if (view.toDouble("speed") != 4.0 || view.toDouble("pos") != 0.5)std::cout << "cmd view recompile failed" << std::endl;
+		parser.commandPool().add<aris::core::Command>("rc", "", "").add<aris::core::Param>("t", "1", "");
+		parser.parse("rc", view);
+		if (view.cmd() != "rc" || view.toInt64("t") != 1)std::cout << "cmd view new command failed" << std::endl;
+		mv.add<aris::core::Param>("pos2", "0", "", 'p');
+		try { parser.parse("mv", view); std::cout << "cmd view parse failed: duplicate abbreviation" << std::endl; }
+		catch (std::exception &) {};
+
+		// 同名命令与map接口一样取第一个，命令较多时查找表的排序也必须稳定 //
+		aris::core::CommandParser dup_parser("dup_parser");
+		for (int i = 0; i < 64; ++i)
+		{
+			dup_parser.commandPool().add<aris::core::Command>("dup", "", "").add<aris::core::Param>("id", std::to_string(i), "");
+			dup_parser.commandPool().add<aris::core::Command>("cmd" + std::to_string(63 - i), "", "");
+		}
+		dup_parser.parse("dup", view);
+		dup_parser.parse("dup", cmd_result, param_result);
+		if (view.toInt64("id") != 0 || param_result.at("id") != "0")std::cout << "cmd view parse failed: duplicate command name" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
 
 void test_command()
 {
 	std::cout << std::endl << "-----------------test command---------------------" << std::endl;
 	test_command_xml();
 	test_command_code();
+	test_command_view();
 	std::cout << "-----------------test command finished------------" << std::endl << std::endl;
 }
 
@@ -0,0 +1,157 @@
+﻿#include <iostream>
+#include <algorithm>
+#include <regex>
+#include <aris_core.h>
+#include "test_core_expression_calculator.h"
+
+using namespace aris::core;
+
+auto is_equal(const Matrix &m1, const Matrix &m2)->bool
+{
+	if (m1.m() != m2.m() || m1.n() != m2.n()) return false;
+	for (aris::Size i = 0; i < m1.m(); ++i)for (aris::Size j = 0; j < m1.n(); ++j)if (std::abs(m1(i, j) - m2(i, j)) > 1e-12) return false;
+	return true;
+}
+
+void test_compile()
+{
+	Calculator c;
+	c.addVariable("a", Matrix(2.0));
+	c.addVariable("v", Matrix({ 1.0, 2.0, 3.0 }));
+	c.addVariable("m", Matrix(2, 2, std::vector<double>{ 1.0, 2.0, 3.0, 4.0 }.data()));
+
+	const std::vector<std::pair<std::string, Matrix>> cases
+	{
+		{ "1+2*3", Matrix(7.0) },
+		{ "-(1+2)*a", Matrix(-6.0) },
+		{ "2-3-4", Matrix(-5.0) },
+		{ "8/2/2", Matrix(2.0) },
+		{ "a*v+1", Matrix({ 3.0, 5.0, 7.0 }) },
+		{ "{v;v*2}", Matrix(2, 3, std::vector<double>{ 1.0, 2.0, 3.0, 2.0, 4.0, 6.0 }.data()) },
+		{ "{1,a;3,4}*m", Matrix(2, 2, std::vector<double>{ 7.0, 10.0, 15.0, 22.0 }.data()) },
+		{ "m-{1,1;1,1}", Matrix(2, 2, std::vector<double>{ 0.0, 1.0, 2.0, 3.0 }.data()) },
+		{ "sqrt(a*8)", Matrix(4.0) },
+		{ "{{1,2},3;{4,5,6}}", Matrix(2, 3, std::vector<double>{ 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 }.data()) },
+		{ "{}", Matrix() },
+		{ "+a", Matrix(2.0) },
+	};
+
+	for (auto &cs : cases)
+	{
+		try
+		{
+			if (!is_equal(c.calculateExpression(cs.first), cs.second)) std::cout << "aris::core::Calculator calculateExpression failed: " << cs.first << std::endl;
+			// 第二次走缓存 //
+			if (!is_equal(c.calculateExpression(cs.first), cs.second)) std::cout << "aris::core::Calculator cached calculateExpression failed: " << cs.first << std::endl;
+			auto exp = c.compile(cs.first);
+			if (!is_equal(exp.evaluate(), cs.second) || !is_equal(exp.evaluate(), cs.second)) std::cout << "aris::core::Calculator compile failed: " << cs.first << std::endl;
+		}
+		catch (std::exception &e)
+		{
+			std::cout << "aris::core::Calculator compile failed: " << cs.first << " " << e.what() << std::endl;
+		}
+	}
+
+	// 非法表达式 //
+	for (auto exp : { "1+", "{1,2;3}", "b*2", "{1,2}+{1,2,3}", "sqrt(1,2)" })
+	{
+		try
+		{
+			c.calculateExpression(exp);
+			std::cout << "aris::core::Calculator compile failed: invalid expression accepted " << exp << std::endl;
+		}
+		catch (std::exception &) {}
+	}
+
+	// 修改变量后重复求值 //
+	auto exp = c.compile("a*v");
+	c.setVariable("a", Matrix(3.0));
+	if (!is_equal(exp.evaluate(), Matrix({ 3.0, 6.0, 9.0 })) || !is_equal(c.calculateExpression("a*v"), Matrix({ 3.0, 6.0, 9.0 }))) std::cout << "aris::core::Calculator setVariable failed" << std::endl;
+
+	// clearVariables之后旧的表达式失效 //
+	c.clearVariables();
+	try
+	{
+		exp.evaluate();
+		std::cout << "aris::core::Calculator compile failed: out of date expression evaluated" << std::endl;
+	}
+	catch (std::exception &) {}
+}
+
+void test_literal()
+{
+	Calculator c;
+
+	// toString 之后再解析必须得到完全相同的值 //
+	const double values[]{ 3.141592653589793 / 7, 0.1, 1.0 / 3, -2.5e-300, 1e300, 0.0, -1.0 };
+	Matrix mat(1, 7, values);
+	auto parsed = c.calculateExpression(mat.toString());
+	if (parsed.m() != 1 || parsed.n() != 7 || !std::equal(values, values + 7, parsed.data())) std::cout << "aris::core::Calculator literal round trip failed: " << mat.toString() << std::endl;
+	if (Matrix(0.1).toString() != "{0.1}") std::cout << "aris::core::Matrix toString failed: " << Matrix(0.1).toString() << std::endl;
+
+	// 非十进制的数字不能走快速解析，结果必须与完整求值一致 //
+	for (auto exp : { "0x10", "inf", "nan", "-inf", "1e", "0x1p3", "{1,0x10}", "1e5", " {1.5e-3 , -.5 ;\n 2 , +3.} " })
+	{
+		std::string fast, full;
+		try { fast = c.calculateExpression(exp).toString(); }
+		catch (std::exception &) { fast = "error"; }
+		try { full = c.compile(exp).evaluate().toString(); }
+		catch (std::exception &) { full = "error"; }
+		if (fast != full) std::cout << "aris::core::Calculator literal failed: \"" << exp << "\" -> " << fast << " instead of " << full << std::endl;
+	}
+}
+
+void test_evaluate()
+{
+	// 原先的实现：按变量名顺序逐个用正则替换 //
+	auto test_vars = [](const std::vector<std::pair<std::string, std::string>> &vars, std::initializer_list<const char*> exps)
+	{
+		Calculator c;
+		for (auto &v : vars)c.addVariable(v.first, v.second);
+
+		auto reference = [&vars](std::string str)
+		{
+			std::map<std::string, std::string> sorted(vars.begin(), vars.end());
+			for (auto &var : sorted) str = std::regex_replace(str, std::regex("\\$\\{" + var.first + "\\}"), var.second);
+			return str;
+		};
+
+		for (auto exp : exps)
+		{
+			if (c.evaluateExpression(exp) != reference(exp)) std::cout << "aris::core::Calculator evaluateExpression failed: \"" << exp << "\" -> \"" << c.evaluateExpression(exp) << "\" instead of \"" << reference(exp) << "\"" << std::endl;
+		}
+	};
+
+	test_vars(
+	{
+		{ "a", "{1,2}" },
+		{ "len", "0.5" },
+		{ "b", "${len}*2" },
+		{ "z", "${a}+${b}" },
+		{ "path", "/home/${user}" },
+		{ "user", "aris" },
+	},
+	{ "${a}*${len}", "${z}", "${b}+${b}", "${path}/${user}", "${unknown}+1", "${${a}}", "${a", "$a}", "", "no variable", "${}${len}}" });
+
+	// 跨越替换边界形成的引用 //
+	test_vars(
+	{
+		{ "a", "${" },
+		{ "b", "x" },
+		{ "c", "$" },
+		{ "d", "{b}" },
+		{ "e", "b" },
+		{ "f", "}" },
+	},
+	{ "${a}b}", "${c}{b}", "${c}${d}", "${${e}}", "${a}${e}${f}", "${a}a}", "${f}${a}b}" });
+	if (Calculator().evaluateExpression("${a}b}") != "${a}b}") std::cout << "aris::core::Calculator evaluateExpression failed: no variables" << std::endl;
+}
+
+void test_core_expression_calculator()
+{
+	std::cout << std::endl << "-----------------test expression calculator---------------------" << std::endl;
+	test_compile();
+	test_literal();
+	test_evaluate();
+	std::cout << "-----------------test expression calculator finished------------" << std::endl << std::endl;
+}
@@ -0,0 +1,6 @@
+﻿#ifndef TEST_CORE_EXPRESSION_CALCULATOR_H_
+#define TEST_CORE_EXPRESSION_CALCULATOR_H_
+
+void test_core_expression_calculator();
+
+#endif
@@ -1,4 +1,9 @@
 ﻿#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include <aris_core.h>
 #include "test_core_object.h"
 
@@ -167,11 +172,118 @@ void test_big_five()
 void test_xml()
 {
 }
+void test_name_index()
+{
+	Object root("root");
+	auto &pool = root.add<Object>("pool");
+	for (int i = 0; i < 32; ++i) pool.add<Object>("obj" + std::to_string(i)).add<Object>("marker");
+
+	// test add //
+	for (int i = 0; i < 32; ++i) if (pool.findByName("obj" + std::to_string(i)) != pool.children().begin() + i) std::cout << "aris::core::Object name index failed: add" << std::endl;
+	if (pool.findByName("obj32") != pool.children().end()) std::cout << "aris::core::Object name index failed: not exist" << std::endl;
+
+	pool.add<Object>("obj32");
+	if (pool.findByName("obj32") != pool.children().begin() + 32) std::cout << "aris::core::Object name index failed: add after index" << std::endl;
+
+	// test erase //
+	pool.children().erase(pool.children().begin() + 3);
+	if (pool.findByName("obj3") != pool.children().end() || pool.findByName("obj4") != pool.children().begin() + 3) std::cout << "aris::core::Object name index failed: erase" << std::endl;
+
+	// 直接修改容器后，下一次 add 重建索引 //
+	pool.add<Object>("obj33");
+	if (pool.findByName("obj33") != pool.children().begin() + 32 || pool.findByName("obj4") != pool.children().begin() + 3) std::cout << "aris::core::Object name index failed: add after erase" << std::endl;
+
+	// test rename by assign, including duplicate names //
+	pool.children().at(5) = Object("obj10");
+	if (pool.findByName("obj6") != pool.children().end() || pool.findByName("obj10") != pool.children().begin() + 5) std::cout << "aris::core::Object name index failed: rename" << std::endl;
+	pool.children().at(5) = Object("renamed");
+	if (pool.findByName("obj10") != pool.children().begin() + 9 || pool.findByName("renamed") != pool.children().begin() + 5) std::cout << "aris::core::Object name index failed: rename duplicate" << std::endl;
+
+	// test loadXml //
+	auto xml = root.xmlString();
+	Object root2("root2");
+	root2.loadXmlStr(xml);
+	if (root2.xmlString() != xml) std::cout << "aris::core::Object name index failed: loadXml" << std::endl;
+	auto &pool2 = *root2.findByName("pool");
+	for (std::size_t i = 0; i < pool2.children().size(); ++i) 
+		if (pool2.findByName(pool2.children().at(i).name()) != pool2.children().begin() + i) std::cout << "aris::core::Object name index failed: loadXml" << std::endl;
+
+	// test path //
+	if (root2.findByPath("pool/obj20/marker") != &pool2.findByName("obj20")->children().front()) std::cout << "aris::core::Object findByPath failed" << std::endl;
+	if (pool2.findByPath("/pool/obj20") != &*pool2.findByName("obj20")) std::cout << "aris::core::Object findByPath failed: absolute path" << std::endl;
+	if (root2.findByPath("pool/obj3/marker") != nullptr) std::cout << "aris::core::Object findByPath failed: not exist" << std::endl;
+	if (root2.findByPath("") != &root2) std::cout << "aris::core::Object findByPath failed: empty path" << std::endl;
+
+	// 查找不修改索引，多个线程可以同时查找 //
+	const Object &const_pool = pool2;
+	std::atomic<int> error_count{ 0 };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)threads.push_back(std::thread([&]()
+	{
+		for (int k = 0; k < 1000; ++k)
+			for (std::size_t i = 0; i < const_pool.children().size(); ++i)
+				if (const_pool.findByName(const_pool.children().at(i).name()) != const_pool.children().begin() + i) ++error_count;
+	}));
+	for (auto &t : threads)t.join();
+	if (error_count) std::cout << "aris::core::Object name index failed: concurrent find" << std::endl;
+}
+void test_binary_snapshot()
+{
+	Object root("root");
+	root.registerType<Man>();
+	auto &pool = root.add<Object>("pool");
+	pool.add<Man>("man1", 11, "worker");
+	pool.add<Man>("man2", 22, "teacher").add<Object>("child");
+
+	// test save / load //
+	std::string data;
+	root.saveBinaryStr(data, 123);
+
+	Object root2("root2");
+	root2.registerType<Man>();
+	root2.loadBinaryStr(data);
+	if (root2.xmlString() != root.xmlString()) std::cout << "aris::core::Object binary snapshot failed: load" << std::endl;
+
+	// test corrupted data //
+	auto bad = data;
+	bad.back() ^= 1;
+	try
+	{
+		root2.loadBinaryStr(bad);
+		std::cout << "aris::core::Object binary snapshot failed: corrupted data accepted" << std::endl;
+	}
+	catch (std::exception &) {}
+
+	// test snapshot invalidated by xml content //
+	const std::string xml_file = "test_core_object_snapshot.xml", snapshot_file = "test_core_object_snapshot.bin";
+	root.saveXmlFile(xml_file);
+	std::remove(snapshot_file.c_str());
+
+	Object root3("root3");
+	root3.registerType<Man>();
+	root3.loadXmlFile(xml_file, snapshot_file);
+	if (root3.xmlString() != root.xmlString()) std::cout << "aris::core::Object binary snapshot failed: first load" << std::endl;
 
+	std::ifstream snapshot_stream(snapshot_file, std::ios::binary);
+	if (!snapshot_stream) std::cout << "aris::core::Object binary snapshot failed: snapshot not generated" << std::endl;
+	snapshot_stream.close();
 
+	root3.loadXmlFile(xml_file, snapshot_file);
+	if (root3.xmlString() != root.xmlString()) std::cout << "aris::core::Object binary snapshot failed: load from snapshot" << std::endl;
+
+	pool.add<Man>("man3", 33, "driver");
+	root.saveXmlFile(xml_file);
+	root3.loadXmlFile(xml_file, snapshot_file);
+	if (root3.xmlString() != root.xmlString()) std::cout << "aris::core::Object binary snapshot failed: stale snapshot used" << std::endl;
+
+	std::remove(xml_file.c_str());
+	std::remove(snapshot_file.c_str());
+}
 
 void test_object()
 {
 	// test big 5 //
 	test_big_five();
+	test_name_index();
+	test_binary_snapshot();
 }
\ No newline at end of file
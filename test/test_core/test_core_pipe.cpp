@@ -1,6 +1,7 @@
 ﻿#include <iostream>
 #include <thread>
 #include <future>
+#include <chrono>
 #include <aris_core.h>
 #include "test_core_pipe.h"
 
@@ -12,8 +13,136 @@ long mod(long a, long b)
 	return (a%b + b) % b;
 }
 
+void test_pipe_zero_copy()
+{
+	// 缓冲区很小，消息长度不一，保证多次回绕 //
+	aris::core::Pipe pipe("zero_copy_pipe", 200);
+
+	int send_count{ 0 }, recv_count{ 0 };
+	for (int loop = 0; loop < 1000; ++loop)
+	{
+		for (;;)
+		{
+			const MsgSize size = (send_count * 7) % 50;
+			auto header = pipe.reserve(size + 8);
+			if (!header) break;
+			header->msg_id_ = send_count;
+			for (MsgSize i = 0; i < size; ++i)reinterpret_cast<char*>(header + 1)[i] = static_cast<char>(send_count + i);
+			// 提交前减小消息长度 //
+			header->msg_size_ = size;
+			pipe.commit();
+			++send_count;
+		}
+
+		for (int i = 0; i < loop % 4 + 1; ++i)
+		{
+			auto header = pipe.peek();
+			if (!header)break;
+			if (pipe.peek() != header)std::cout << "pipe peek failed" << std::endl;
+
+			const MsgSize size = (recv_count * 7) % 50;
+			bool ok = header->msg_id_ == recv_count && header->msg_size_ == size;
+			for (MsgSize j = 0; ok && j < size; ++j)ok = reinterpret_cast<const char*>(header + 1)[j] == static_cast<char>(recv_count + j);
+			if (!ok)std::cout << "pipe zero copy failed at msg " << recv_count << std::endl;
+			pipe.release();
+			++recv_count;
+		}
+	}
+
+	// 普通接口与零拷贝接口混用 //
+	aris::core::Msg msg;
+	while (pipe.recvMsg(msg)) ++recv_count;
+	if (recv_count != send_count)std::cout << "pipe zero copy failed: lost msg" << std::endl;
+	if (pipe.reserve(1000) != nullptr)std::cout << "pipe reserve failed: too large msg" << std::endl;
+	if (!pipe.sendMsg(aris::core::Msg("zero copy")) || !pipe.recvMsg(msg) || std::string(msg.data()) != "zero copy")std::cout << "pipe sendMsg failed" << std::endl;
+}
+
+void test_pipe_throughput()
+{
+	const int msg_num{ 1000000 };
+	const MsgSize msg_size{ 64 };
+	aris::core::Pipe pipe("throughput_pipe", 16384);
+
+	auto begin = std::chrono::high_resolution_clock::now();
+	auto fu = std::async(std::launch::async, [&]()
+	{
+		for (int i = 0; i < msg_num;)
+		{
+			if (auto header = pipe.reserve(msg_size))
+			{
+				header->msg_id_ = i++;
+				pipe.commit();
+			}
+			else std::this_thread::yield();
+		}
+	});
+
+	int error_count{ 0 };
+	for (int i = 0; i < msg_num;)
+	{
+		if (auto header = pipe.peek())
+		{
+			if (header->msg_id_ != i++ || header->msg_size_ != msg_size)++error_count;
+			pipe.release();
+		}
+		else std::this_thread::yield();
+	}
+	fu.wait();
+	auto time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+	if (error_count)std::cout << "pipe throughput failed: " << error_count << " wrong msg" << std::endl;
+	std::cout << "pipe throughput: " << msg_num / time / 1e6 << " M msg/s, " << msg_num * (msg_size + sizeof(MsgHeader)) / time / 1e6 << " MB/s" << std::endl;
+}
+
+void test_pipe_msg()
+{
+	aris::core::Pipe pipe("pipe_msg", 1024);
+	aris::core::PipeMsg pipe_msg(pipe, 256);
+	aris::core::MsgStream stream(pipe_msg);
+
+	// 写在预留的缓冲区中 //
+	stream.update();
+	pipe_msg.acquire();
+	stream.resetBuf();
+	if (!pipe_msg.isInPipe())std::cout << "pipe msg failed: not in pipe after acquire" << std::endl;
+	stream << "first" << '\0';
+	stream.update();
+	if (pipe.peek())std::cout << "pipe msg failed: visible before send" << std::endl;
+	if (!pipe_msg.send())std::cout << "pipe msg failed: send returns false" << std::endl;
+	stream.resetBuf();
+
+	aris::core::Msg recv;
+	if (!pipe.recvMsg(recv) || std::string(recv.data()) != "first")std::cout << "pipe msg failed: wrong content" << std::endl;
+
+	// 管道满时写入内部缓冲，之后由 sendMsg 发出 //
+	aris::core::Pipe full_pipe("full_pipe", 1024);
+	while (full_pipe.sendMsg(aris::core::Msg(std::string(100, 'x'))));
+	aris::core::PipeMsg spill_msg(full_pipe, 256);
+	aris::core::MsgStream spill_stream(spill_msg);
+	spill_stream.update();
+	spill_msg.acquire();
+	spill_stream.resetBuf();
+	if (spill_msg.isInPipe())std::cout << "pipe msg failed: in pipe when pipe is full" << std::endl;
+	spill_stream << "second" << '\0';
+	spill_stream.update();
+	if (spill_msg.send())std::cout << "pipe msg failed: send to full pipe returns true" << std::endl;
+	spill_stream.resetBuf();
+
+	while (full_pipe.recvMsg(recv));
+	spill_stream << "third" << '\0';
+	spill_stream.update();
+	if (!spill_msg.send())std::cout << "pipe msg failed: spilled send returns false" << std::endl;
+	spill_stream.resetBuf();
+	if (!full_pipe.recvMsg(recv) || std::string(recv.data()) != "third")std::cout << "pipe msg failed: wrong spilled content" << std::endl;
+	if (!spill_msg.isInPipe())std::cout << "pipe msg failed: not back in pipe after send" << std::endl;
+}
+
 void test_core_pipe()
 {
+	test_pipe_zero_copy();
+	test_pipe_throughput();
+	test_pipe_msg();
+
 	aris::core::Pipe pipe;
 
 	auto fu = std::async(std::launch::async, [&pipe]() 
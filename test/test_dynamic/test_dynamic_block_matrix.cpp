@@ -365,6 +365,93 @@ void test_block_householder()
 	//dlmwrite("C:\\Users\\py033\\Desktop\\t.txt", result2, m, 1);
 }
 
+void test_block_parallel()
+{
+	// 20 个 6x6 块组成的稀疏正定阵，模拟多机器人的约束矩阵 //
+	const aris::Size blk_num{ 20 }, blk_size{ 6 }, n{ blk_num * blk_size };
+	const BlockSize blk_m(blk_num, blk_size);
+
+	std::vector<double> A(n * n, 0.0), B(n * n, 0.0), S(n * n, 0.0), C1(n * n), C2(n * n), L1(n * n), L2(n * n);
+	for (aris::Size i = 0; i < n; ++i)
+	{
+		for (aris::Size j = 0; j < n; ++j)
+		{
+			// 只保留块三对角部分 //
+			if (i / blk_size + 1 < j / blk_size || j / blk_size + 1 < i / blk_size)continue;
+			A[i * n + j] = std::sin(0.37 * i + 0.11 * j);
+			B[i * n + j] = std::cos(0.23 * i + 0.17 * j);
+		}
+	}
+	s_mm(n, n, n, A.data(), n, A.data(), T(n), S.data(), n);
+	for (aris::Size i = 0; i < n; ++i)S[i * n + i] += 1.0;
+
+	BlockData blk_A, blk_B, blk_S, blk_C1, blk_C2, blk_L1, blk_L2;
+	for (auto *p : { &blk_A, &blk_B, &blk_S, &blk_C1, &blk_C2, &blk_L1, &blk_L2 })p->resize(blk_num * blk_num);
+	s_blk_map(blk_m, blk_m, A.data(), blk_A);
+	s_blk_map(blk_m, blk_m, B.data(), blk_B);
+	s_blk_map(blk_m, blk_m, S.data(), blk_S);
+	s_blk_map(blk_m, blk_m, C1.data(), blk_C1);
+	s_blk_map(blk_m, blk_m, C2.data(), blk_C2);
+	s_blk_map(blk_m, blk_m, L1.data(), blk_L1);
+	s_blk_map(blk_m, blk_m, L2.data(), blk_L2);
+	for (aris::Size i = 0; i < blk_num; ++i)
+	{
+		for (aris::Size j = 0; j < blk_num; ++j)
+		{
+			blk_A[i * blk_num + j].is_zero = i > j + 1 || j > i + 1;
+			blk_B[i * blk_num + j].is_zero = i > j + 1 || j > i + 1;
+			blk_S[i * blk_num + j].is_zero = i > j + 2 || j > i + 2;
+		}
+	}
+
+	s_blk_set_thread_count(1);
+	s_blk_mm(blk_m, blk_m, blk_m, blk_A, blk_B, blk_C1);
+	s_blk_llt(blk_m, blk_S, BlockStride{ blk_num, 1, n, 1 }, blk_L1, BlockStride{ blk_num, 1, n, 1 });
+	auto serial_mm = aris::core::benchmark(100, [&]() { s_blk_mm(blk_m, blk_m, blk_m, blk_A, blk_B, blk_C1); });
+	auto serial_llt = aris::core::benchmark(100, [&]() { s_blk_llt(blk_m, blk_S, BlockStride{ blk_num, 1, n, 1 }, blk_L1, BlockStride{ blk_num, 1, n, 1 }); });
+
+	s_blk_set_thread_count(4);
+	if (s_blk_thread_count() != 4)std::cout << "\"s_blk_set_thread_count\" failed" << std::endl;
+	s_blk_mm(blk_m, blk_m, blk_m, blk_A, blk_B, blk_C2);
+	s_blk_llt(blk_m, blk_S, BlockStride{ blk_num, 1, n, 1 }, blk_L2, BlockStride{ blk_num, 1, n, 1 });
+	auto parallel_mm = aris::core::benchmark(100, [&]() { s_blk_mm(blk_m, blk_m, blk_m, blk_A, blk_B, blk_C2); });
+	auto parallel_llt = aris::core::benchmark(100, [&]() { s_blk_llt(blk_m, blk_S, BlockStride{ blk_num, 1, n, 1 }, blk_L2, BlockStride{ blk_num, 1, n, 1 }); });
+	s_blk_set_thread_count(1);
+
+	for (aris::Size i = 0; i < blk_num * blk_num; ++i)
+	{
+		if (blk_C1[i].is_zero != blk_C2[i].is_zero || (!blk_C1[i].is_zero && !s_is_equal(blk_size, blk_size, blk_C1[i].data, n, blk_C2[i].data, n, error)))
+		{
+			std::cout << "\"s_blk_mm parallel\" failed" << std::endl;
+			break;
+		}
+	}
+	for (aris::Size i = 0; i < blk_num * blk_num; ++i)
+	{
+		if (blk_L1[i].is_zero != blk_L2[i].is_zero || (!blk_L1[i].is_zero && !s_is_equal(blk_size, blk_size, blk_L1[i].data, n, blk_L2[i].data, n, error)))
+		{
+			std::cout << "\"s_blk_llt parallel\" failed" << std::endl;
+			break;
+		}
+	}
+
+	// 与稠密结果比较 //
+	s_mm(n, n, n, A.data(), B.data(), C2.data());
+	for (aris::Size i = 0; i < blk_num * blk_num; ++i)
+	{
+		if (blk_C1[i].is_zero)s_fill(blk_size, blk_size, 0.0, blk_C1[i].data, n);
+	}
+	if (!s_is_equal(n, n, C1.data(), C2.data(), error))std::cout << "\"s_blk_mm parallel\" failed" << std::endl;
+	s_llt(n, S.data(), L2.data());
+	for (aris::Size i = 0; i < blk_num * blk_num; ++i)
+	{
+		if (blk_L1[i].is_zero)s_fill(blk_size, blk_size, 0.0, blk_L1[i].data, n);
+	}
+	if (!s_is_equal(n, n, L1.data(), L2.data(), error))std::cout << "\"s_blk_llt parallel\" failed" << std::endl;
+
+	std::cout << "s_blk_mm serial:" << serial_mm << "  parallel:" << parallel_mm
+		<< "  s_blk_llt serial:" << serial_llt << "  parallel:" << parallel_llt << std::endl;
+}
 
 void test_block_matrix()
 {
@@ -373,6 +460,7 @@ void test_block_matrix()
 	test_block_multiply();
 	test_block_llt();
 	test_block_householder();
+	test_block_parallel();
 
 	std::cout << "-----------------test block matrix finished-----------" << std::endl << std::endl;
 }
\ No newline at end of file
@@ -1043,6 +1043,46 @@ void test_householder()
 	}
 }
 
+void test_fixed_size()
+{
+	double A[36], B[36], C1[36], C2[36], L1[36], L2[36], tau1[6], tau2[6];
+	for (aris::Size i = 0; i < 36; ++i)
+	{
+		A[i] = std::sin(0.37 * i + 0.1);
+		B[i] = std::cos(0.23 * i + 0.4);
+	}
+
+	s_mm(6, 6, 6, A, 6, B, ColMajor{ 6 }, C1, 6);
+	s_mm<6, 6, 6>(A, 6, B, ColMajor{ 6 }, C2, 6);
+	if (!s_is_equal(6, 6, C1, C2, error))std::cout << "\"s_mm<6, 6, 6>\" failed" << std::endl;
+
+	s_mm(3, 1, 3, 0.5, A, 6, B, 1, C1, 1);
+	s_mm<3, 1, 3>(0.5, A, 6, B, 1, C2, 1);
+	if (!s_is_equal(3, C1, C2, error))std::cout << "\"s_mm<3, 1, 3>\" failed" << std::endl;
+
+	s_mma(6, 1, 6, A, B, C1);
+	s_mma<6, 1, 6>(A, B, C2);
+	if (!s_is_equal(6, C1, C2, error))std::cout << "\"s_mma<6, 1, 6>\" failed" << std::endl;
+
+	s_mma(4, 2, 3, 0.3, A, T(6), B, 6, C1, 2);
+	s_mma<4, 2, 3>(0.3, A, T(6), B, 6, C2, 2);
+	if (!s_is_equal(4, 2, C1, C2, error))std::cout << "\"s_mma<4, 2, 3>\" failed" << std::endl;
+
+	// A*A^T + 6I 为正定阵 //
+	double S[36];
+	s_mm(6, 6, 6, A, 6, A, T(6), S, 6);
+	for (aris::Size i = 0; i < 6; ++i)S[i * 7] += 6.0;
+	s_llt(6, S, L1);
+	s_llt<6>(S, L2);
+	if (!s_is_equal(6, 6, L1, L2, error))std::cout << "\"s_llt<6>\" failed" << std::endl;
+
+	s_householder_ut(6, 4, A, 6, L1, 4, tau1, 1);
+	s_householder_ut<6, 4>(A, 6, L2, 4, tau2, 1);
+	if (!s_is_equal(6, 4, L1, L2, error) || !s_is_equal(4, tau1, tau2, error))std::cout << "\"s_householder_ut<6, 4>\" failed" << std::endl;
+
+	std::cout << "6x6 s_mm  runtime:" << aris::core::benchmark(100000, [&]() { s_mm(6, 6, 6, A, 6, B, 6, C1, 6); })
+		<< "  fixed:" << aris::core::benchmark(100000, [&]() { s_mm<6, 6, 6>(A, 6, B, 6, C2, 6); }) << std::endl;
+}
 
 
 void test_matrix()
@@ -1053,7 +1093,7 @@ void test_matrix()
 	test_multiply();
 	test_llt();
 	test_householder();
-	
+	test_fixed_size();
 
 	std::cout << "-----------------test matrix finished-----------" << std::endl << std::endl;
 }
\ No newline at end of file
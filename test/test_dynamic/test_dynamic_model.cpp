@@ -1,9 +1,87 @@
 ﻿#include "test_dynamic_model.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
 #include <aris_dynamic.h>
 
+using namespace aris::dynamic;
+
+auto is_same_model(const Model &m1, const Model &m2)->bool
+{
+	if (m1.xmlString() != m2.xmlString() || m1.partPool().size() != m2.partPool().size()) return false;
+	for (aris::Size i = 0; i < m1.partPool().size(); ++i)
+	{
+		auto &p1 = m1.partPool().at(i), &p2 = m2.partPool().at(i);
+		if (!std::equal(&p1.pm()[0][0], &p1.pm()[0][0] + 16, &p2.pm()[0][0])) return false;
+		if (!std::equal(p1.prtIv(), p1.prtIv() + 10, p2.prtIv())) return false;
+		if (p1.markerPool().size() != p2.markerPool().size()) return false;
+		for (aris::Size j = 0; j < p1.markerPool().size(); ++j)
+		{
+			auto &mak1 = p1.markerPool().at(j).prtPm(), &mak2 = p2.markerPool().at(j).prtPm();
+			if (!std::equal(&mak1[0][0], &mak1[0][0] + 16, &mak2[0][0])) return false;
+		}
+	}
+	return true;
+}
+
+void test_model_snapshot()
+{
+	// 欧拉角等不能被十进制精确表示，读取快照得到的模型必须与读取xml得到的完全相同 //
+	const double link1_pe[6]{ 0.1, 0.2, 0.3, aris::PI / 7, aris::PI / 3, 1.0 / 3 };
+	const double link2_pe[6]{ 1.0 / 3, 0.7, -0.1, aris::PI / 2 + 0.1, aris::PI / 9, -aris::PI / 11 };
+	const double iv[10]{ 2.0, 0.1, 0.2, 0.3, 1.0 / 3, 1.0 / 7, 10.0, 0.01, 0.02, 0.03 };
+	const double axis[3]{ 0.0, 0.0, 1.0 }, pos1[3]{ 0.1, 0.2, 0.3 }, pos2[3]{ 1.0 / 3, 0.7, -0.1 };
+
+	Model m;
+	auto &link1 = m.addPartByPe(link1_pe, "321", iv);
+	auto &link2 = m.addPartByPe(link2_pe, "313", iv);
+	auto &joint1 = m.addRevoluteJoint(link1, m.ground(), pos1, axis);
+	auto &joint2 = m.addRevoluteJoint(link2, link1, pos2, axis);
+	m.addMotion(joint1);
+	m.addMotion(joint2);
+	m.addGeneralMotionByPe(link2, m.ground(), link2_pe, "321");
+	m.variablePool().add<MatrixVariable>("k", aris::core::Matrix(1.0 / 3));
+	m.variablePool().add<MatrixVariable>("PI_7", aris::core::Matrix(aris::PI / 7));
+
+	// 在xml中使用表达式，快照中必须替换为求值的结果 //
+	const std::string xml_file = "test_dynamic_model_snapshot.xml", snapshot_file = "test_dynamic_model_snapshot.bin";
+	aris::core::XmlDocument doc;
+	m.saveXmlDoc(doc);
+	std::function<aris::core::XmlElement*(aris::core::XmlElement*)> find_part = [&](aris::core::XmlElement *ele)->aris::core::XmlElement*
+	{
+		if (ele->Attribute("pe") && ele->Attribute("inertia") && std::string(ele->Name()) != "ground") return ele;
+		for (auto child = ele->FirstChildElement(); child; child = child->NextSiblingElement()) if (auto found = find_part(child)) return found;
+		return nullptr;
+	};
+	auto part_ele = find_part(doc.RootElement());
+	if (!part_ele)std::cout << "aris::dynamic::Model snapshot failed: part not found in xml" << std::endl;
+	else part_ele->SetAttribute("pe", "{0.1, 0.2, 0.3, PI_7 + k, k*2/5, 2/7}");
+	doc.SaveFile(xml_file.c_str());
+	std::remove(snapshot_file.c_str());
+
+	Model from_xml, first_load, from_snapshot;
+	from_xml.loadXmlFile(xml_file);
+	first_load.loadXmlFile(xml_file, snapshot_file);
+	if (!std::ifstream(snapshot_file)) std::cout << "aris::dynamic::Model snapshot failed: snapshot not generated" << std::endl;
+	from_snapshot.loadXmlFile(xml_file, snapshot_file);
+
+	if (!is_same_model(from_xml, first_load)) std::cout << "aris::dynamic::Model snapshot failed: first load differs from xml" << std::endl;
+	if (!is_same_model(from_xml, from_snapshot)) std::cout << "aris::dynamic::Model snapshot failed: load from snapshot differs from xml" << std::endl;
+
+	std::ifstream snapshot_stream(snapshot_file, std::ios::binary);
+	const std::string snapshot((std::istreambuf_iterator<char>(snapshot_stream)), std::istreambuf_iterator<char>());
+	if (snapshot.find("PI_7 + k") != std::string::npos || snapshot.find("k*2/5") != std::string::npos)std::cout << "aris::dynamic::Model snapshot failed: expressions not evaluated in snapshot" << std::endl;
+
+	std::remove(xml_file.c_str());
+	std::remove(snapshot_file.c_str());
+}
+
 void test_model()
 {
 	std::cout << std::endl << "-----------------test model---------------------" << std::endl;
+	test_model_snapshot();
 	std::cout << "-----------------test model finished------------" << std::endl << std::endl;
 }
-
@@ -1178,6 +1178,260 @@ void test_multi_systems()
 		std::cout << e.what() << std::endl;
 	}
 }
+void test_analytic_solver()
+{
+	try
+	{
+		std::cout << "test analytic inverse kinematic solver:" << std::endl;
+		
+		// stewart //
+		const double input_origin_p[6]{ 2.0 , 2.0 , 2.0 , 2.0 , 2.0 , 2.0 };
+		const double output_origin_pm[16]{ 1,0,0,0,
+			0, 0.999999999751072,2.2312668404904e-05,1.7078344386197,
+			0, -2.23126684049141e-05,0.999999999751072,0.577658198650165,
+			0,0,0,1 };
+		const double input_p[6]{ 2.15,2.03,1.98,1.68,2.22,2.01 };
+		const double output_pm[16]{ 0.654617242227831, -0.16813527373803,0.737025641279234,0.0674004103296998,
+			0.286892301165042,0.957269694021347, -0.0364354283699648,1.66351811346172,
+			-0.699406229390514,0.235298241883176,0.674881962758251,0.907546391448817,
+			0,0,0,1 };
+
+		Model m;
+		m.loadXmlStr(xml_file_stewart);
+		auto &stewart = m.solverPool().add<StewartInverseKinematicSolver>();
+		stewart.allocateMemory();
+		if (!stewart.isAnalytic())std::cout << "StewartInverseKinematicSolver topology detect failed" << std::endl;
+
+		double result[6];
+		for (int k = 0; k < 2; ++k)
+		{
+			m.generalMotionPool().at(0).setMpm(k % 2 ? output_origin_pm : output_pm);
+			if (!stewart.kinPos() || stewart.iterCount() != 0)std::cout << "StewartInverseKinematicSolver::kinPos() failed" << std::endl;
+			for (aris::Size i = 0; i < 6; ++i)result[i] = m.motionPool().at(i).mp();
+			if (!s_is_equal(6, result, k % 2 ? input_origin_p : input_p, 1e-9))std::cout << "StewartInverseKinematicSolver::kinPos() failed" << std::endl;
+		}
+
+		int count{ 0 };
+		std::cout << "StewartInverseKinematicSolver::inverse computational pos time:" << aris::core::benchmark(10000, [&]()
+		{
+			m.generalMotionPool().at(0).setMpm(++count % 2 ? output_origin_pm : output_pm);
+			stewart.kinPos();
+		}) << std::endl;
+
+		// scara //
+		const double PI = 3.141592653589793;
+		const double iv[10]{ 2 , 0 , 0 , 0 , 1 , 1, 10 , 0, 0, 0 };
+		const double j1_pos[3]{ 0 , 0 , 0 }, j2_pos[3]{ 1 , 0 , 0 }, j3_pos[3]{ 1 , 1 , 0 }, z_axis[3]{ 0 , 0 , 1 };
+		const double l1_pe[6]{ 0 , 0 , 0 , 0 , 0 , 0 }, l2_pe[6]{ 1 , 0 , 0 , PI / 2 , 0 , 0 }, l3_pe[6]{ 1 , 1 , 0 , PI / 2 , 0 , 0 };
+
+		Model scara;
+		auto &link1 = scara.addPartByPe(l1_pe, "321", iv);
+		auto &link2 = scara.addPartByPe(l2_pe, "321", iv);
+		auto &link3 = scara.addPartByPe(l3_pe, "321", iv);
+		auto &link4 = scara.addPartByPe(l3_pe, "321", iv);
+		scara.addMotion(scara.addRevoluteJoint(link1, scara.ground(), j1_pos, z_axis));
+		scara.addMotion(scara.addRevoluteJoint(link2, link1, j2_pos, z_axis));
+		scara.addMotion(scara.addPrismaticJoint(link3, link2, j3_pos, z_axis));
+		scara.addMotion(scara.addRevoluteJoint(link4, link3, j3_pos, z_axis));
+		auto &ee = scara.addGeneralMotionByPe(link4, scara.ground(), l3_pe, "321");
+
+		auto &universal = scara.solverPool().add<InverseKinematicSolver>();
+		auto &analytic = scara.solverPool().add<ScaraInverseKinematicSolver>();
+		universal.allocateMemory();
+		analytic.allocateMemory();
+		if (!analytic.isAnalytic())std::cout << "ScaraInverseKinematicSolver topology detect failed" << std::endl;
+
+		const double ee_pe[2][6]{ { 1.3 , 1 , -0.3 , 0.3 , 0 , 0 },{ 0.2 , 1.1 , 0.4 , -1.2 , 0 , 0 } };
+		double expect[4];
+		for (int k = 0; k < 2; ++k)
+		{
+			ee.setMpe(ee_pe[k], "321");
+			universal.kinPos();
+			for (aris::Size i = 0; i < 4; ++i)expect[i] = scara.motionPool().at(i).mp();
+			if (!analytic.kinPos() || analytic.iterCount() != 0)std::cout << "ScaraInverseKinematicSolver::kinPos() failed" << std::endl;
+			for (aris::Size i = 0; i < 4; ++i)result[i] = scara.motionPool().at(i).mp();
+			if (!s_is_equal(4, result, expect, 1e-9))std::cout << "ScaraInverseKinematicSolver::kinPos() failed" << std::endl;
+		}
+	}
+	catch (std::exception&e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+void test_predictor()
+{
+	try
+	{
+		std::cout << "test solver predictor:" << std::endl;
+
+		// 两个相同的模型沿同一条连续轨迹做位置正解，比较结果与迭代次数 //
+		Model m1, m2;
+		m1.loadXmlStr(xml_file_stewart);
+		m2.loadXmlStr(xml_file_stewart);
+		auto &plain = m1.solverPool().add<ForwardKinematicSolver>("plain");
+		auto &predicted = m2.solverPool().add<ForwardKinematicSolver>("predicted");
+		predicted.setPredictorOrder(2);
+		plain.allocateMemory();
+		predicted.allocateMemory();
+
+		double pm1[16], pm2[16];
+		for (aris::Size k = 0; k < 500; ++k)
+		{
+			for (aris::Size i = 0; i < 6; ++i)
+			{
+				m1.motionPool().at(i).setMp(2.0 + 0.1 * std::sin(0.01 * k + i));
+				m2.motionPool().at(i).setMp(2.0 + 0.1 * std::sin(0.01 * k + i));
+			}
+
+			if (!plain.kinPos() || !predicted.kinPos())std::cout << "UniversalSolver::kinPos() with predictor failed" << std::endl;
+			m1.generalMotionPool().at(0).getMpm(pm1);
+			m2.generalMotionPool().at(0).getMpm(pm2);
+			if (!s_is_equal(16, pm1, pm2, 1e-9))std::cout << "UniversalSolver::kinPos() with predictor failed: result not correct" << std::endl;
+		}
+
+		std::cout << "average iter count without predictor:" << double(plain.totalIterCount()) / plain.kinPosCount() << "  peak:" << plain.peakIterCount() << std::endl;
+		std::cout << "average iter count with predictor   :" << double(predicted.totalIterCount()) / predicted.kinPosCount() << "  peak:" << predicted.peakIterCount() << std::endl;
+		if (predicted.totalIterCount() >= plain.totalIterCount())std::cout << "UniversalSolver::kinPos() with predictor failed: iter count not reduced" << std::endl;
+	}
+	catch (std::exception&e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+// 转盘上挂两个互不相关的平行四边形机构，F被分为两个独立的块 //
+void make_two_loop_model(Model &m)
+{
+	const double iv[10]{ 1.0 , 0.0 , 0.0 , 0.0 , 1.0 , 1.0, 1.0 , 0.0, 0.0, 0.0 };
+	const double pe[6]{ 0.0 , 0.0 , 0.0 , 0.0 , 0.0 , 0.0 };
+	const double axis[3]{ 0.0 , 0.0 , 1.0 };
+	const double origin[3]{ 0.0 , 0.0 , 0.0 };
+
+	auto &hub = m.addPartByPe(pe, "321", iv);
+	m.addMotion(m.addRevoluteJoint(hub, m.ground(), origin, axis));
+	for (double side : { 1.0, -1.0 })
+	{
+		const double p1[3]{ side , 0.0 , 0.0 }, p2[3]{ 2.0 * side , 0.0 , 0.0 }, p3[3]{ 2.0 * side , 1.0 , 0.0 }, p4[3]{ side , 1.0 , 0.0 };
+		auto &b = m.addPartByPe(pe, "321", iv);
+		auto &c = m.addPartByPe(pe, "321", iv);
+		auto &d = m.addPartByPe(pe, "321", iv);
+		m.addMotion(m.addRevoluteJoint(b, hub, p1, axis));
+		m.addRevoluteJoint(c, b, p2, axis);
+		m.addRevoluteJoint(d, c, p3, axis);
+		m.addRevoluteJoint(d, hub, p4, axis);
+	}
+}
+void test_block_qr()
+{
+	try
+	{
+		std::cout << "test solver block qr:" << std::endl;
+
+		// 分块QR与稠密QR的位置与速度解应一致 //
+		for (auto xml : { xml_file_stewart, xml_file_multi, static_cast<const char*>(nullptr) })
+		{
+			Model m1, m2;
+			if (xml)
+			{
+				m1.loadXmlStr(xml);
+				m2.loadXmlStr(xml);
+			}
+			else
+			{
+				make_two_loop_model(m1);
+				make_two_loop_model(m2);
+			}
+			auto &block = m1.solverPool().add<UniversalSolver>("block", 100, 1e-14);
+			auto &dense = m2.solverPool().add<UniversalSolver>("dense", 100, 1e-14);
+			dense.setBlockQr(false);
+			block.allocateMemory();
+			dense.allocateMemory();
+			if (!block.blockQr() || dense.blockQr())std::cout << "UniversalSolver::setBlockQr() failed" << std::endl;
+
+			for (aris::Size k = 0; k < 20; ++k)
+			{
+				for (aris::Size i = 0; i < m1.motionPool().size(); ++i)
+				{
+					double mp = m1.motionPool().at(i).mp() + 0.002 * std::sin(0.1 * k + i);
+					m1.motionPool().at(i).setMp(mp);
+					m2.motionPool().at(i).setMp(mp);
+					m1.motionPool().at(i).setMv(0.1 * std::cos(0.1 * k + i));
+					m2.motionPool().at(i).setMv(0.1 * std::cos(0.1 * k + i));
+				}
+
+				if (block.kinPos() != dense.kinPos())std::cout << "UniversalSolver::kinPos() with block qr failed" << std::endl;
+				block.kinVel();
+				dense.kinVel();
+
+				for (aris::Size i = 0; i < m1.partPool().size(); ++i)
+				{
+					if (!s_is_equal(16, *m1.partPool().at(i).pm(), *m2.partPool().at(i).pm(), 1e-9))std::cout << "UniversalSolver::kinPos() with block qr failed: result not correct" << std::endl;
+					if (!s_is_equal(6, m1.partPool().at(i).vs(), m2.partPool().at(i).vs(), 1e-9))std::cout << "UniversalSolver::kinVel() with block qr failed: result not correct" << std::endl;
+				}
+			}
+		}
+	}
+	catch (std::exception&e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+void test_batch()
+{
+	try
+	{
+		std::cout << "test solver batch:" << std::endl;
+
+		Model m;
+		m.loadXmlStr(xml_file_stewart);
+		auto &s = m.solverPool().add<ForwardKinematicSolver>();
+		s.allocateMemory();
+
+		// 输入输出为SoA，分量j的第k个样本位于[j*n + k] //
+		const aris::Size n = 1000;
+		std::vector<double> input(n * 6), output(n * 16), output1(n * 16), result(16);
+		std::unique_ptr<bool[]> success(new bool[n]);
+		for (aris::Size k = 0; k < n; ++k)for (aris::Size i = 0; i < 6; ++i)input[i * n + k] = 2.0 + 0.1 * std::sin(0.01 * k + i);
+
+		std::cout << "ForwardKinematicSolver::kinPosBatch() time:" << aris::core::benchmark(1, [&]()
+		{
+			if (s.kinPosBatch(n, input.data(), output.data(), success.get(), 4) != n)std::cout << "ForwardKinematicSolver::kinPosBatch() failed" << std::endl;
+		}) << std::endl;
+
+		// 每个样本都从相同的初值出发，结果与线程数无关 //
+		if (s.kinPosBatch(n, input.data(), output1.data(), nullptr, 1) != n || output != output1)std::cout << "ForwardKinematicSolver::kinPosBatch() failed: result depends on thread count" << std::endl;
+		if (aris::dynamic::s_blk_thread_count() != 1)std::cout << "ForwardKinematicSolver::kinPosBatch() failed: global block thread count changed" << std::endl;
+
+		// 修改模型参数后副本必须重建，下面与直接求解的结果比较 //
+		double mak_pm[16];
+		std::copy_n(*m.motionPool().at(0).makI().prtPm(), 16, mak_pm);
+		mak_pm[3] += 0.01;
+		m.motionPool().at(0).makI().setPrtPm(mak_pm);
+		if (s.kinPosBatch(n, input.data(), output.data(), success.get(), 4) != n)std::cout << "ForwardKinematicSolver::kinPosBatch() failed: after marker changed" << std::endl;
+		if (output == output1)std::cout << "ForwardKinematicSolver::kinPosBatch() failed: stale model copies used" << std::endl;
+
+		std::vector<double> seed(m.partPool().size() * 16);
+		for (aris::Size j = 0; j < m.partPool().size(); ++j)m.partPool().at(j).getPm(seed.data() + j * 16);
+		for (aris::Size k = 0; k < n; ++k)
+		{
+			for (aris::Size j = 0; j < m.partPool().size(); ++j)m.partPool().at(j).setPm(seed.data() + j * 16);
+			for (aris::Size i = 0; i < 6; ++i)m.motionPool().at(i).setMp(input[i * n + k]);
+			s.kinPos();
+			m.generalMotionPool().at(0).getMpm(result.data());
+			for (aris::Size i = 0; i < 16; ++i)
+			{
+				if (!success[k] || std::abs(result[i] - output[i * n + k]) > 1e-9)
+				{
+					std::cout << "ForwardKinematicSolver::kinPosBatch() failed: result not correct" << std::endl;
+					break;
+				}
+			}
+		}
+	}
+	catch (std::exception&e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
 void bench_3R()
 {
 	try
@@ -1450,6 +1704,10 @@ void test_model_compute()
 	test_6R();
 	test_stewart();
 	test_multi_systems();
+	test_analytic_solver();
+	test_predictor();
+	test_block_qr();
+	test_batch();
 
 	bench_3R();
 	bench_6R();
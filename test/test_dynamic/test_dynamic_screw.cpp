@@ -1829,6 +1829,60 @@ void test_solve()
 	
 }
 
+void test_simd()
+{
+	const double pm[16]{ -0.22, -0.975499782797526, 0.000416847668728071, 0.1,
+		0.175499782797526, -0.04, -0.983666521865018, 0.2,
+		0.959583152331272, -0.216333478134982, 0.18, 0.3,
+		0,0,0,1 };
+	const double pm2[16]{ 0.567219713641686, -0.802148353464729, 0.186697527955346, 0.4,
+		0.77015943479698, 0.595815021375475, 0.227875431446751, 0.5,
+		-0.294033685601273, 0.0393073663292097, 0.955000734172515, 0.6,
+		0,0,0,1 };
+	const double vs[6]{ 0.1, -0.2, 0.3, -0.4, 0.5, -0.6 };
+	const double fs[6]{ 1.1, 2.2, -3.3, 0.44, -0.55, 0.66 };
+	const double iv[10]{ 2.5, 0.1, -0.2, 0.3, 1.1, 1.2, 1.3, 0.04, -0.05, 0.06 };
+
+	// 每个内核分别用标量与SIMD实现计算，比较结果 //
+	const int simd_level = s_simd_level();
+	double result[2][8][16];
+	for (int level = 0; level < 2; ++level)
+	{
+		s_set_simd_level(level == 0 ? SIMD_SCALAR : SIMD_AVX2);
+		s_pm_dot_pm(pm, pm2, result[level][0]);
+		s_inv_pm_dot_pm(pm, pm2, result[level][1]);
+		s_tv(pm, vs, result[level][2]);
+		s_inv_tv(pm, vs, result[level][3]);
+		s_tf(pm, fs, result[level][4]);
+		s_cv(vs, fs, result[level][5]);
+		s_cf(vs, fs, result[level][6]);
+		s_iv_dot_as(iv, vs, result[level][7]);
+	}
+	const char *names[8]{ "s_pm_dot_pm", "s_inv_pm_dot_pm", "s_tv", "s_inv_tv", "s_tf", "s_cv", "s_cf", "s_iv_dot_as" };
+	for (int i = 0; i < 8; ++i)if (!s_is_equal(i < 2 ? 16 : 6, result[0][i], result[1][i], 1e-14))std::cout << "\"" << names[i] << "\" simd failed" << std::endl;
+
+	// 性能对比 //
+	if (s_set_simd_level(SIMD_AVX2) == SIMD_AVX2)
+	{
+		double out[16];
+		for (int level = 0; level < 2; ++level)
+		{
+			s_set_simd_level(level == 0 ? SIMD_SCALAR : SIMD_AVX2);
+			std::cout << (level == 0 ? "scalar" : "avx2  ")
+				<< "  s_pm_dot_pm:" << aris::core::benchmark(1000000, [&]() { s_pm_dot_pm(pm, pm2, out); })
+				<< "  s_inv_pm_dot_pm:" << aris::core::benchmark(1000000, [&]() { s_inv_pm_dot_pm(pm, pm2, out); })
+				<< "  s_tv:" << aris::core::benchmark(1000000, [&]() { s_tv(pm, vs, out); })
+				<< "  s_inv_tv:" << aris::core::benchmark(1000000, [&]() { s_inv_tv(pm, vs, out); })
+				<< "  s_tf:" << aris::core::benchmark(1000000, [&]() { s_tf(pm, fs, out); })
+				<< "  s_cv:" << aris::core::benchmark(1000000, [&]() { s_cv(vs, fs, out); })
+				<< "  s_cf:" << aris::core::benchmark(1000000, [&]() { s_cf(vs, fs, out); })
+				<< "  s_iv_dot_as:" << aris::core::benchmark(1000000, [&]() { s_iv_dot_as(iv, vs, out); })
+				<< std::endl;
+		}
+	}
+	s_set_simd_level(simd_level);
+}
+
 void test_screw()
 {
 	std::cout << std::endl << "-----------------test screw--------------------" << std::endl;
@@ -1839,6 +1893,7 @@ void test_screw()
 	test_variable_change();
 	test_coordinate_transform();
 	test_solve();
+	test_simd();
 
 	std::cout << "-----------------test screw finished-----------" << std::endl << std::endl;
 }
\ No newline at end of file